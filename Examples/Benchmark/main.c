@@ -0,0 +1,496 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "noodle.h"
+
+#define SETTINGS_GROUPS 16384
+#define SETTINGS_KEYS 64
+#define SETTINGS_LOOKUPS 40
+#define ARRAY_LENGTH 256
+
+typedef struct Document_t
+{
+    char*           pContent;
+    size_t          size;
+    char*           pArrays; // Made of long arrays, what the converters are timed on
+    size_t          arraysSize;
+    char*           pJson; // pArrays converted to JSON
+    size_t          jsonSize;
+    NoodleGroup_t*  pSettings; // Wide groups that lookups are timed on
+    NoodleGroup_t** ppGroups; // Of pSettings in a shuffled order
+    const char*     ppKeys[SETTINGS_LOOKUPS];
+} Document_t;
+
+// Each case runs once over the whole document, false means it failed
+typedef NOODLE_BOOL (* BenchmarkFunction_t)(const Document_t* pDocument);
+
+// What the rate of a case is measured in
+typedef enum BenchmarkRate_t
+{
+    BENCHMARK_RATE_CONTENT, // Bytes of pContent
+    BENCHMARK_RATE_ARRAYS, // Bytes of pArrays
+    BENCHMARK_RATE_JSON, // Bytes of pJson
+    BENCHMARK_RATE_LOOKUPS, // Keys looked up
+} BenchmarkRate_t;
+
+typedef struct Benchmark_t
+{
+    const char*         pName;
+    BenchmarkFunction_t function;
+    BenchmarkRate_t     rate;
+} Benchmark_t;
+
+// Output of the converters is buffered like a file would be, then dropped
+typedef struct Output_t
+{
+    size_t  size;
+    size_t  total;
+    char    pBuffer[16384];
+} Output_t;
+
+static char keyNames[SETTINGS_KEYS][32];
+static volatile size_t sink; // Keeps the lookups from being optimized out
+static Output_t output;
+static NoodleContext_t* pContext; // Reused by every run, like a reloader would
+
+static double timeNow(void)
+{
+    struct timespec now;
+    timespec_get(&now, TIME_UTC);
+
+    return (double)now.tv_sec + (double)now.tv_nsec / 1e9;
+}
+
+static const char* keyName(size_t index, char* pBuffer)
+{
+    // Identifiers can't contain digits so keys are spelled out in letters
+    size_t length = 0;
+    pBuffer[length++] = 'k';
+
+    do
+    {
+        pBuffer[length++] = (char)('a' + index % 26);
+        index /= 26;
+    } while (index);
+
+    pBuffer[length] = '\0';
+    return pBuffer;
+}
+
+// Builds a document of roughly the given size out of groups that look like
+// typical settings, with every kind of value in them
+static NOODLE_BOOL generateDocument(Document_t* pDocument, size_t size)
+{
+    size_t capacity = size + 4096;
+
+    pDocument->pContent = malloc(capacity);
+    pDocument->size = 0;
+    if (!pDocument->pContent) return NOODLE_FALSE;
+
+    char pKey[32];
+
+    for (size_t i = 0; pDocument->size < size; i++)
+    {
+        int written = snprintf(pDocument->pContent + pDocument->size, capacity - pDocument->size,
+            "%s = {\n"
+            "    enabled = true,\n"
+            "    volume = 0.75,\n"
+            "    count = %zu,\n"
+            "    title = \"Some window title\",\n"
+            "    sizes = [ 1280, 720, 1920, 1080 ],\n"
+            "    nested = { depth = 2, name = \"inner\" }\n"
+            "}\n",
+            keyName(i, pKey), i);
+
+        if (written < 0 || (size_t)written >= capacity - pDocument->size) break;
+        pDocument->size += (size_t)written;
+    }
+
+    return NOODLE_TRUE;
+}
+
+static size_t writeOutput(void* pUser, const void* pData, size_t size)
+{
+    Output_t* pOutput = pUser;
+
+    if (size > sizeof(pOutput->pBuffer) - pOutput->size)
+    {
+        sink = pOutput->pBuffer[0];
+        pOutput->size = 0;
+    }
+
+    if (size <= sizeof(pOutput->pBuffer))
+    {
+        memcpy(pOutput->pBuffer + pOutput->size, pData, size);
+        pOutput->size += size;
+    }
+
+    pOutput->total += size;
+    return size;
+}
+
+static size_t writeMemory(void* pUser, const void* pData, size_t size)
+{
+    Document_t* pDocument = pUser;
+
+    char* pJson = realloc(pDocument->pJson, pDocument->jsonSize + size + 1);
+    if (!pJson) return 0;
+
+    memcpy(pJson + pDocument->jsonSize, pData, size);
+    pDocument->pJson = pJson;
+    pDocument->jsonSize += size;
+    pDocument->pJson[pDocument->jsonSize] = '\0';
+
+    return size;
+}
+
+// Builds a document of roughly the given size out of groups that each hold 
+// long arrays of numbers, like exported meshes or samples would, and its JSON
+static NOODLE_BOOL generateArrays(Document_t* pDocument, size_t size)
+{
+    size_t capacity = size + ARRAY_LENGTH * 32;
+
+    pDocument->pArrays = malloc(capacity);
+    pDocument->arraysSize = 0;
+    if (!pDocument->pArrays) return NOODLE_FALSE;
+
+    char pKey[32];
+    uint32_t random = 12345;
+
+    for (size_t i = 0; pDocument->arraysSize < size; i++)
+    {
+        char* pContent = pDocument->pArrays;
+        size_t used = pDocument->arraysSize;
+
+        used += (size_t)snprintf(pContent + used, capacity - used, "%s = {\n    indices = [", keyName(i, pKey));
+
+        for (size_t j = 0; j < ARRAY_LENGTH; j++)
+        {
+            random = random * 1664525u + 1013904223u;
+            used += (size_t)snprintf(pContent + used, capacity - used, j ? ", %u" : "%u", (unsigned)(random >> 16));
+        }
+
+        used += (size_t)snprintf(pContent + used, capacity - used, "]\n    weights = [");
+
+        for (size_t j = 0; j < ARRAY_LENGTH; j++)
+        {
+            random = random * 1664525u + 1013904223u;
+            used += (size_t)snprintf(pContent + used, capacity - used, j ? ", %u.%03u" : "%u.%03u", (unsigned)(random >> 24), (unsigned)(random >> 8) % 1000);
+        }
+
+        used += (size_t)snprintf(pContent + used, capacity - used, "]\n}\n");
+
+        if (used >= capacity) break;
+        pDocument->arraysSize = used;
+    }
+
+    return noodleToJson(pDocument->pArrays, pDocument->arraysSize, writeMemory, pDocument, NULL, 0);
+}
+
+// Every group looks like a request handler's settings, most of which are 
+// read on each request. The groups are visited out of order so they miss 
+// the cache like they would between requests.
+static NOODLE_BOOL generateSettings(Document_t* pDocument)
+{
+    size_t capacity = (size_t)SETTINGS_GROUPS * (SETTINGS_KEYS * 24 + 64);
+    char* pContent = malloc(capacity);
+    if (!pContent) return NOODLE_FALSE;
+
+    size_t size = 0;
+    char pKey[32];
+
+    for (size_t k = 0; k < SETTINGS_KEYS; k++)
+        keyName(k, keyNames[k]);
+
+    for (size_t i = 0; i < SETTINGS_GROUPS; i++)
+    {
+        size += (size_t)snprintf(pContent + size, capacity - size, "%s = {\n", keyName(i, pKey));
+
+        for (size_t k = 0; k < SETTINGS_KEYS; k++)
+            size += (size_t)snprintf(pContent + size, capacity - size, "    %s = %zu\n", keyNames[k], k);
+
+        size += (size_t)snprintf(pContent + size, capacity - size, "}\n");
+    }
+
+    pDocument->pSettings = noodleParse(pContent, NULL, NULL, NULL, NULL, 0);
+    free(pContent);
+    if (!pDocument->pSettings) return NOODLE_FALSE;
+
+    pDocument->ppGroups = malloc(sizeof(NoodleGroup_t*) * SETTINGS_GROUPS);
+    if (!pDocument->ppGroups) return NOODLE_FALSE;
+
+    for (size_t i = 0; i < SETTINGS_GROUPS; i++)
+        pDocument->ppGroups[i] = noodleGroupFrom(pDocument->pSettings, keyName(i, pKey));
+
+    uint32_t random = 12345;
+
+    for (size_t i = SETTINGS_GROUPS - 1; i > 0; i--)
+    {
+        random = random * 1664525u + 1013904223u;
+        size_t j = random % (i + 1);
+
+        NoodleGroup_t* pTemp = pDocument->ppGroups[i];
+        pDocument->ppGroups[i] = pDocument->ppGroups[j];
+        pDocument->ppGroups[j] = pTemp;
+    }
+
+    for (size_t k = 0; k < SETTINGS_LOOKUPS; k++)
+        pDocument->ppKeys[k] = keyNames[(k * 7) % SETTINGS_KEYS];
+
+    return NOODLE_TRUE;
+}
+
+static NOODLE_BOOL benchmarkParse(const Document_t* pDocument)
+{
+    NoodleGroup_t* pRoot = noodleParse(pDocument->pContent, NULL, NULL, NULL, NULL, 0);
+    noodleCleanup(pRoot);
+
+    return pRoot != NULL;
+}
+
+static NOODLE_BOOL benchmarkParseWith(const Document_t* pDocument)
+{
+    NoodleGroup_t* pRoot = noodleParseWith(pContext, pDocument->pContent, NULL, NULL, 0);
+    noodleCleanup(pRoot);
+
+    return pRoot != NULL;
+}
+
+static NOODLE_BOOL benchmarkParseDeferred(const Document_t* pDocument)
+{
+    // Only the parse is on this thread, the cleanup happens in the background
+    NoodleGroup_t* pRoot = noodleParse(pDocument->pContent, NULL, NULL, NULL, NULL, 0);
+    noodleCleanupDeferred(pRoot);
+
+    return pRoot != NULL;
+}
+
+static NOODLE_BOOL benchmarkRecords(const Document_t* pDocument)
+{
+    NoodleRecords_t* pRecords = noodleRecordsOpen(pDocument->pContent, pDocument->size, NULL, NULL);
+    if (!pRecords) return NOODLE_FALSE;
+
+    NoodleGroup_t* pRecord = NULL;
+    NOODLE_BOOL succeeded = NOODLE_TRUE;
+
+    while (noodleRecordsNext(pRecords, &pRecord, NULL, 0))
+    {
+        if (!pRecord) succeeded = NOODLE_FALSE;
+        noodleCleanup(pRecord);
+    }
+
+    noodleRecordsClose(pRecords);
+    return succeeded;
+}
+
+static NOODLE_BOOL dropRecord(void* pUser, size_t index, NoodleGroup_t* pRecord, const char* pError)
+{
+    (void)pUser;
+    (void)index;
+    (void)pError;
+
+    noodleCleanup(pRecord);
+    return pRecord != NULL;
+}
+
+static NOODLE_BOOL benchmarkParseRecords(const Document_t* pDocument)
+{
+    return noodleParseRecords(pDocument->pContent, pDocument->size, 0, dropRecord, NULL);
+}
+
+static NOODLE_BOOL benchmarkParseLazy(const Document_t* pDocument)
+{
+    NoodleGroup_t* pRoot = noodleParseLazy(pDocument->pContent, NULL, NULL, NULL, 0);
+    noodleCleanup(pRoot);
+
+    return pRoot != NULL;
+}
+
+static NOODLE_BOOL benchmarkParseTape(const Document_t* pDocument)
+{
+    NoodleTape_t* pTape = noodleParseTape(pDocument->pContent, NULL, NULL, 0);
+    noodleTapeCleanup(pTape);
+
+    return pTape != NULL;
+}
+
+static NOODLE_BOOL benchmarkValidate(const Document_t* pDocument)
+{
+    return noodleValidate(pDocument->pContent, pDocument->size, NULL, 0);
+}
+
+static NOODLE_BOOL benchmarkToJson(const Document_t* pDocument)
+{
+    output.size = 0;
+    return noodleToJson(pDocument->pArrays, pDocument->arraysSize, writeOutput, &output, NULL, 0);
+}
+
+static void putArray(const NoodleArray_t* pArray, NOODLE_BOOL floats)
+{
+    char pNumber[32];
+
+    writeOutput(&output, "[", 1);
+
+    for (size_t i = 0; i < noodleCount((const Noodle_t*)pArray); i++)
+    {
+        int length = floats 
+            ? snprintf(pNumber, sizeof(pNumber), i ? ",%g" : "%g", noodleFloatAt(pArray, i)) 
+            : snprintf(pNumber, sizeof(pNumber), i ? ",%d" : "%d", noodleIntAt(pArray, i));
+
+        writeOutput(&output, pNumber, (size_t)length);
+    }
+
+    writeOutput(&output, "]", 1);
+}
+
+static NOODLE_BOOL putGroup(Noodle_t* pNoodle)
+{
+    NoodleGroup_t* pGroup = (NoodleGroup_t*)pNoodle;
+
+    writeOutput(&output, "\"", 1);
+    writeOutput(&output, pNoodle->pName, strlen(pNoodle->pName));
+    writeOutput(&output, "\":{\"indices\":", 13);
+    putArray(noodleArrayFrom(pGroup, "indices"), NOODLE_FALSE);
+    writeOutput(&output, ",\"weights\":", 11);
+    putArray(noodleArrayFrom(pGroup, "weights"), NOODLE_TRUE);
+    writeOutput(&output, "},", 2);
+
+    return NOODLE_TRUE;
+}
+
+// What converting takes without the converters, the document is parsed into
+// a tree which is then written out through the getters
+static NOODLE_BOOL benchmarkTreeToJson(const Document_t* pDocument)
+{
+    NoodleGroup_t* pRoot = noodleParse(pDocument->pArrays, NULL, NULL, NULL, NULL, 0);
+    if (!pRoot) return NOODLE_FALSE;
+
+    output.size = 0;
+    writeOutput(&output, "{", 1);
+    noodleGroupForeach(pRoot, putGroup);
+    writeOutput(&output, "}\n", 2);
+
+    noodleCleanup(pRoot);
+    return NOODLE_TRUE;
+}
+
+static NOODLE_BOOL benchmarkFromJson(const Document_t* pDocument)
+{
+    output.size = 0;
+    return noodleFromJson(pDocument->pJson, pDocument->jsonSize, writeOutput, &output, NULL, 0);
+}
+
+static NOODLE_BOOL benchmarkFromLoop(const Document_t* pDocument)
+{
+    size_t found = 0;
+
+    for (size_t i = 0; i < SETTINGS_GROUPS; i++)
+        for (size_t k = 0; k < SETTINGS_LOOKUPS; k++)
+            found += noodleFrom(pDocument->ppGroups[i], pDocument->ppKeys[k]) != NULL;
+
+    sink = found;
+    return found == (size_t)SETTINGS_GROUPS * SETTINGS_LOOKUPS;
+}
+
+static NOODLE_BOOL benchmarkGetMany(const Document_t* pDocument)
+{
+    Noodle_t* ppNoodles[SETTINGS_LOOKUPS];
+    size_t found = 0;
+
+    for (size_t i = 0; i < SETTINGS_GROUPS; i++)
+        found += noodleGetMany(pDocument->ppGroups[i], pDocument->ppKeys, SETTINGS_LOOKUPS, ppNoodles);
+
+    sink = found;
+    return found == (size_t)SETTINGS_GROUPS * SETTINGS_LOOKUPS;
+}
+
+static const Benchmark_t benchmarks[] = {
+    {"noodleParse", benchmarkParse, BENCHMARK_RATE_CONTENT},
+    {"noodleParseWith", benchmarkParseWith, BENCHMARK_RATE_CONTENT},
+    {"noodleCleanupDeferred", benchmarkParseDeferred, BENCHMARK_RATE_CONTENT},
+    {"noodleRecordsNext", benchmarkRecords, BENCHMARK_RATE_CONTENT},
+    {"noodleParseRecords", benchmarkParseRecords, BENCHMARK_RATE_CONTENT},
+    {"noodleParseLazy", benchmarkParseLazy, BENCHMARK_RATE_CONTENT},
+    {"noodleParseTape", benchmarkParseTape, BENCHMARK_RATE_CONTENT},
+    {"noodleValidate", benchmarkValidate, BENCHMARK_RATE_CONTENT},
+    {"noodleToJson", benchmarkToJson, BENCHMARK_RATE_ARRAYS},
+    {"tree to JSON", benchmarkTreeToJson, BENCHMARK_RATE_ARRAYS},
+    {"noodleFromJson", benchmarkFromJson, BENCHMARK_RATE_JSON},
+    {"noodleFrom x40", benchmarkFromLoop, BENCHMARK_RATE_LOOKUPS},
+    {"noodleGetMany x40", benchmarkGetMany, BENCHMARK_RATE_LOOKUPS},
+};
+
+int main(int argc, const char* argv[])
+{
+    // Usage: Benchmark [size in MiB] [iterations]
+    size_t mebibytes = argc > 1 ? strtoul(argv[1], NULL, 10) : 64;
+    int iterations = argc > 2 ? atoi(argv[2]) : 5;
+
+    if (mebibytes == 0 || iterations <= 0)
+    {
+        printf("Usage: %s [size in MiB] [iterations]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    Document_t document = {0};
+    pContext = noodleContextCreate(NULL);
+
+    if (!pContext || !generateDocument(&document, mebibytes << 20) || !generateArrays(&document, mebibytes << 20) || !generateSettings(&document))
+    {
+        printf("Could not allocate the document!\n");
+        return EXIT_FAILURE;
+    }
+
+    printf("%-24s %12s %12s\n", "benchmark", "best (ms)", "rate");
+
+    int failed = 0;
+
+    for (size_t b = 0; b < sizeof(benchmarks) / sizeof(benchmarks[0]); b++)
+    {
+        // The best run is reported, it's the least disturbed by everything else
+        double best = 0.0;
+
+        for (int i = 0; i < iterations; i++)
+        {
+            double start = timeNow();
+            NOODLE_BOOL succeeded = benchmarks[b].function(&document);
+            double elapsed = timeNow() - start;
+
+            if (!succeeded)
+            {
+                printf("%-24s failed!\n", benchmarks[b].pName);
+                failed = 1;
+                break;
+            }
+
+            if (i == 0 || elapsed < best) best = elapsed;
+        }
+
+        switch (benchmarks[b].rate)
+        {
+            case BENCHMARK_RATE_CONTENT:
+                printf("%-24s %12.2f %12.1f MB/s\n", benchmarks[b].pName, best * 1e3, (double)document.size / 1e6 / best);
+                break;
+            case BENCHMARK_RATE_ARRAYS:
+                printf("%-24s %12.2f %12.1f MB/s\n", benchmarks[b].pName, best * 1e3, (double)document.arraysSize / 1e6 / best);
+                break;
+            case BENCHMARK_RATE_JSON:
+                printf("%-24s %12.2f %12.1f MB/s\n", benchmarks[b].pName, best * 1e3, (double)document.jsonSize / 1e6 / best);
+                break;
+            case BENCHMARK_RATE_LOOKUPS:
+                printf("%-24s %12.2f %12.1f Mkeys/s\n", benchmarks[b].pName, best * 1e3, (double)SETTINGS_GROUPS * SETTINGS_LOOKUPS / 1e6 / best);
+                break;
+        }
+    }
+
+    noodleCleanupWait();
+    noodleCleanup(document.pSettings);
+    noodleContextDestroy(pContext);
+    free(document.ppGroups);
+    free(document.pJson);
+    free(document.pArrays);
+    free(document.pContent);
+    return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,66 @@
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+#include "noodle.hpp"
+
+static const char* pContent = R"(
+audio = {
+    weapons = [ "sword", "bow", "staff" ],
+    music = { enabled = true, volume = 0.4 }
+    volume = 0.8,
+}
+window = {
+    fullscreen = true,
+    width = 1580,
+    sizes = [ 20, 40, 60, 80 ],
+    title = "My Game Window",
+}
+)";
+
+// Literal keys are hashed while compiling
+static_assert(noodle::Key("volume").hash() == noodle::hash("volume"));
+
+int main()
+{
+    std::printf("Basic Noodle Parser Example written in C++!\n");
+
+    std::string error;
+    noodle::Document config = noodle::Document::parse(pContent, &error);
+
+    if (!config)
+    {
+        std::printf("%s\n", error.c_str());
+        return EXIT_FAILURE;
+    }
+
+    noodle::Group audio = config.get<noodle::Group>("audio").value_or(noodle::Group());
+    noodle::Group window = config.root().get<noodle::Group>("window").value_or(noodle::Group());
+
+    std::printf("volume = %f\n", audio.get<float>("volume", 0.0f));
+    std::printf("music enabled = %d\n", audio.get<noodle::Group>("music").value_or(noodle::Group()).get<bool>("enabled", false));
+
+    // A value of another type is missing rather than an error
+    if (!window.get<int>("title")) std::printf("title is not an integer\n");
+
+    std::string_view title = window.get<std::string_view>("title").value_or("untitled");
+    std::printf("title = %.*s\n", static_cast<int>(title.size()), title.data());
+
+    if (auto sizes = window.get<noodle::Span<int>>("sizes"))
+    {
+        for (int size : *sizes)
+            std::printf("size = %d\n", size);
+    }
+
+    if (auto weapons = audio.get<noodle::Span<const char*>>("weapons"))
+    {
+        for (const char* pWeapon : *weapons)
+            std::printf("weapon = %s\n", pWeapon);
+    }
+
+    // Keys built at runtime are hashed then
+    std::string key = "width";
+    std::printf("width = %d\n", window.get<int>(noodle::Key::runtime(key.c_str()), 0));
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,152 @@
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "noodle.h"
+
+// Writes a document of at least the given size, almost all of it comments so
+// that parsing it needs little memory. The values at the end sit past 4 GiB.
+static int writeDocument(const char* pPath, unsigned long long size)
+{
+    FILE* pFile = fopen(pPath, "wb");
+    if (!pFile) return 0;
+
+    char pLine[4096];
+    memset(pLine, 'x', sizeof(pLine));
+    pLine[0] = '#';
+    pLine[sizeof(pLine) - 1] = '\n';
+
+    fputs("head = { value = 1 }\n", pFile);
+
+    for (unsigned long long written = 0; written < size; written += sizeof(pLine))
+    {
+        if (fwrite(pLine, 1, sizeof(pLine), pFile) != sizeof(pLine))
+        {
+            fclose(pFile);
+            return 0;
+        }
+    }
+
+    // The parser stops at the null-terminator, so the file carries its own
+    fputs("tail = { value = 42, name = \"end\", numbers = [ 1, 2, 3 ] }\n", pFile);
+    fputc('\0', pFile);
+
+    return fclose(pFile) == 0;
+}
+
+static const char* mapDocument(const char* pPath, size_t* pSize)
+{
+#ifdef _WIN32
+    HANDLE file = CreateFileA(pPath, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE) return NULL;
+
+    LARGE_INTEGER size;
+    GetFileSizeEx(file, &size);
+
+    HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    CloseHandle(file);
+    if (!mapping) return NULL;
+
+    const char* pContent = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    CloseHandle(mapping);
+
+    *pSize = (size_t)size.QuadPart;
+    return pContent;
+#else
+    int file = open(pPath, O_RDONLY);
+    if (file < 0) return NULL;
+
+    struct stat info;
+    fstat(file, &info);
+
+    void* pContent = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+    close(file);
+    if (pContent == MAP_FAILED) return NULL;
+
+    *pSize = (size_t)info.st_size;
+    return pContent;
+#endif
+}
+
+static void unmapDocument(const char* pContent, size_t size)
+{
+#ifdef _WIN32
+    (void)size;
+    UnmapViewOfFile(pContent);
+#else
+    munmap((void*)pContent, size);
+#endif
+}
+
+static int checkDocument(NoodleGroup_t* pRoot)
+{
+    NoodleGroup_t* pHead = noodleGroupFrom(pRoot, "head");
+    NoodleGroup_t* pTail = noodleGroupFrom(pRoot, "tail");
+    if (!pHead || !pTail) return 0;
+
+    const NoodleArray_t* pNumbers = noodleArrayFrom(pTail, "numbers");
+
+    return noodleIntFrom(pHead, "value", NULL) == 1 
+        && noodleIntFrom(pTail, "value", NULL) == 42 
+        && strcmp(noodleStringFrom(pTail, "name", NULL), "end") == 0
+        && pNumbers && noodleCount((const Noodle_t*)pNumbers) == 3 && noodleIntAt(pNumbers, 2) == 3;
+}
+
+int main(int argc, const char* argv[])
+{
+    // Usage: LargeInput [path] [size in GiB]
+    const char* pPath = argc > 1 ? argv[1] : "large.noodle";
+    unsigned long long gibibytes = argc > 2 ? strtoull(argv[2], NULL, 10) : 4;
+
+    if (sizeof(size_t) < 8)
+    {
+        printf("Large inputs need a 64-bit build!\n");
+        return EXIT_FAILURE;
+    }
+
+    printf("Writing %llu GiB to %s...\n", gibibytes, pPath);
+
+    if (!writeDocument(pPath, gibibytes << 30))
+    {
+        printf("Could not write %s!\n", pPath);
+        return EXIT_FAILURE;
+    }
+
+    size_t size = 0;
+    const char* pContent = mapDocument(pPath, &size);
+    if (!pContent)
+    {
+        printf("Could not map %s!\n", pPath);
+        remove(pPath);
+        return EXIT_FAILURE;
+    }
+
+    char pErrorBuffer[256] = {0};
+    int succeeded = 1;
+
+    NoodleGroup_t* pRoot = noodleParse(pContent, NULL, NULL, NULL, pErrorBuffer, sizeof(pErrorBuffer));
+    succeeded &= pRoot && checkDocument(pRoot);
+    printf("noodleParse: %s %s\n", succeeded ? "passed" : "failed", pErrorBuffer);
+    noodleCleanup(pRoot);
+
+    pRoot = noodleParseLazy(pContent, NULL, NULL, pErrorBuffer, sizeof(pErrorBuffer));
+    succeeded &= pRoot && checkDocument(pRoot);
+    printf("noodleParseLazy: %s %s\n", succeeded ? "passed" : "failed", pErrorBuffer);
+    noodleCleanup(pRoot);
+
+    unmapDocument(pContent, size);
+    remove(pPath);
+
+    return succeeded ? EXIT_SUCCESS : EXIT_FAILURE;
+}
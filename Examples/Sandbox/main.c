@@ -51,7 +51,7 @@ int main(int argc, const char* argv[])
 
 	printf("Basic Noodle Parser Example written in C!\n");
 
-  	NoodleGroup_t* pConfig = noodleParse(pContent, pErrorBuffer, sizeof(pErrorBuffer) / sizeof(pErrorBuffer[0]));
+  	NoodleGroup_t* pConfig = noodleParse(pContent, NULL, NULL, NULL, pErrorBuffer, sizeof(pErrorBuffer) / sizeof(pErrorBuffer[0]));
 		if (!pConfig) 
 	{
 		printf("%s\n", pErrorBuffer);
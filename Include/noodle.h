@@ -1,9 +1,13 @@
 #ifndef NOODLE_PARSER_H
 #define NOODLE_PARSER_H
 
+#include <stddef.h>
 #include <stdint.h>
 #include <stdbool.h>
 
+#ifdef __cplusplus
+extern "C" {
+#endif
 
 #ifndef NOODLE_BOOL
 #define NOODLE_BOOL bool
@@ -26,6 +30,10 @@
 #define NOODLE_MALLOC(size) malloc(size)
 #endif
 
+#ifndef NOODLE_REALLOC
+#define NOODLE_REALLOC(ptr, size) realloc(ptr, size)
+#endif
+
 #ifndef NOODLE_FREE
 #define NOODLE_FREE(ptr) free(ptr)
 #endif
@@ -40,14 +48,39 @@ typedef enum NoodleType_t
     NOODLE_TYPE_STRING,
 } NoodleType_t;
 
+#define NOODLE_TYPE_COUNT (NOODLE_TYPE_STRING + 1)
+
 
 // Every noodle type can be cast to Noodle_t to get it's type and name
 typedef struct Noodle_t Noodle_t;
 typedef struct NoodleGroup_t NoodleGroup_t;
 typedef struct NoodleArray_t NoodleArray_t;
 typedef struct NoodleValue_t NoodleValue_t;
+typedef struct NoodleStringTable_t NoodleStringTable_t;
+typedef struct NoodleTape_t NoodleTape_t;
+typedef struct NoodleQuery_t NoodleQuery_t;
+typedef struct NoodleContext_t NoodleContext_t;
+typedef struct NoodleRecords_t NoodleRecords_t;
+typedef struct NoodlePublisher_t NoodlePublisher_t;
+typedef struct NoodleSubscriber_t NoodleSubscriber_t;
+
+#define NOODLE_TAPE_NONE SIZE_MAX
+
+typedef enum NoodleChange_t
+{
+    NOODLE_CHANGE_ADDED,
+    NOODLE_CHANGE_REMOVED,
+    NOODLE_CHANGE_CHANGED, // Same key with a different value or type
+} NoodleChange_t;
 
 typedef NOODLE_BOOL (* NoodleForeachGroupCallback_t)(Noodle_t* pNoodle); // Return false to break
+typedef NOODLE_BOOL (* NoodleDiffCallback_t)(void* pUser, NoodleChange_t change, const char* pPath, const Noodle_t* NOODLE_NULLABLE pOld, const Noodle_t* NOODLE_NULLABLE pNew); // Return false to break
+typedef void* (* NoodleAllocFunction_t)(void* pUser, size_t size);
+typedef void* (* NoodleReallocFunction_t)(void* pUser, void* pMemory, size_t size);
+typedef void (* NoodleFreeFunction_t)(void* pUser, void* pMemory);
+typedef void (* NoodleParseCallback_t)(void* pUser, const char* pPath, NoodleGroup_t* NOODLE_NULLABLE pGroup, const char* NOODLE_NULLABLE pError); // The group is owned by the callback
+typedef NOODLE_BOOL (* NoodleRecordCallback_t)(void* pUser, size_t index, NoodleGroup_t* NOODLE_NULLABLE pRecord, const char* NOODLE_NULLABLE pError); // The record is owned by the callback, return false to stop
+typedef size_t (* NoodleWriteFunction_t)(void* pUser, const void* pData, size_t size); // Writing fewer bytes than given stops with an error
 
 typedef struct Noodle_t
 {
@@ -56,24 +89,272 @@ typedef struct Noodle_t
     char*               pName;
 } Noodle_t;
 
+// Used for every allocation a document makes, it's copied into the root so
+// the same functions are used when the document is cleaned up. When NULL is
+// passed the NOODLE_MALLOC, NOODLE_REALLOC and NOODLE_FREE macros are used.
+typedef struct NoodleAllocator_t
+{
+    NoodleAllocFunction_t   pfnAlloc;
+    NoodleReallocFunction_t pfnRealloc;
+    NoodleFreeFunction_t    pfnFree;
+    void*                   pUser;
+} NoodleAllocator_t;
+
+// Optionally filled out by the parser to describe the document it built
+typedef struct NoodleParseStats_t
+{
+    size_t              tokenCount;                     // Tokens produced by the lexer, arrays are lexed twice
+    size_t              nodeCounts[NOODLE_TYPE_COUNT];  // Indexed by NoodleType_t, includes the root group
+    size_t              allocationCount;                // Allocations retained by the resulting tree
+    size_t              allocationBytes;                // Bytes requested by those allocations
+    size_t              maxDepth;                       // Deepest group nesting, the root is depth zero
+    size_t              longestChain;                   // Longest hash bucket chain of any group
+    double              lexSeconds;                     // Time spent inside the lexer
+    double              buildSeconds;                   // Time spent building the tree
+} NoodleParseStats_t;
+
+
+// Strings are UTF-8 and may hold the escapes \" \\ \/ \b \f \n \r \t and 
+// \uXXXX, with surrogate pairs for characters past U+FFFF, which are decoded
+// as they're parsed. Other characters, new lines included, are written as 
+// they are. Bad escapes and invalid UTF-8 are reported as errors, as are 
+// numbers of 64 characters or more.
+// A group may contain include "path" in place of a key, which grafts in the
+// entries of another file. Relative paths start from the directory of the 
+// including file, or the working directory for noodleParse. Included files
+// are parsed once per process and shared, their groups and arrays are not 
+// copied into each document. A file is parsed again once its modification 
+// time or size changes. noodleParseTape doesn't support includes. Borrowed
+// groups and arrays keep the included file's document: their pParent chain
+// leads to its root and noodleAllocator gives its allocator. Keys interned 
+// into the including document still find entries of borrowed groups.
+// noodleParseFromFile recognizes files compressed with gzip or zstd by their
+// first bytes, when support for them was built. Such files are decompressed 
+// on another thread while they're parsed, and only the entry being parsed
+// and a few blocks of decompressed content are held at once.
+NoodleGroup_t*          noodleParse(const char* pContent, const NoodleAllocator_t* NOODLE_NULLABLE pAllocator, NoodleStringTable_t* NOODLE_NULLABLE pStrings, NoodleParseStats_t* NOODLE_NULLABLE pStats, char* NOODLE_NULLABLE pErrorBuffer, size_t NOODLE_NULLABLE bufferSize);
+NoodleGroup_t*          noodleParseFromFile(const char* pPath, const NoodleAllocator_t* NOODLE_NULLABLE pAllocator, NoodleStringTable_t* NOODLE_NULLABLE pStrings, NoodleParseStats_t* NOODLE_NULLABLE pStats, char* NOODLE_NULLABLE pErrorBuffer, size_t NOODLE_NULLABLE bufferSize);
+
+// Queues a file to be parsed and returns right away, callback is called from
+// a loader thread once it's done, with a NULL group and pError on failure. On
+// Linux the files are read through io_uring, every file queued while the 
+// loader is busy is submitted in one batch and parsed as its read completes,
+// so reading the others carries on meanwhile. Elsewhere, or when io_uring is
+// unavailable, a small pool of threads reads and parses them. Returns false
+// when the file couldn't be queued.
+NOODLE_BOOL             noodleParseFromFileAsync(const char* pPath, NoodleParseCallback_t callback, void* NOODLE_NULLABLE pUser);
+
+// Blocks until every queued file has been parsed and its callback returned,
+// must not be called from a callback
+void                    noodleParseAsyncWait(void);
+
+// A context is kept between parses of similar documents, such as reloads of
+// the same file. Documents parsed with it take their memory from pools that
+// their cleanup returns memory to, share the context's key names and start
+// each group at the size it had in the last document. Once a reload has been
+// parsed, parsing it again allocates close to nothing. Parsing and cleaning
+// up documents of one context must not happen on multiple threads at once,
+// and they must all be cleaned up before the context is destroyed.
+NoodleContext_t*        noodleContextCreate(const NoodleAllocator_t* NOODLE_NULLABLE pAllocator);
+void                    noodleContextDestroy(NoodleContext_t* pContext);
+NoodleGroup_t*          noodleParseWith(NoodleContext_t* pContext, const char* pContent, NoodleParseStats_t* NOODLE_NULLABLE pStats, char* NOODLE_NULLABLE pErrorBuffer, size_t NOODLE_NULLABLE bufferSize);
+
+// Reads a sequence of records, such as a log of "event = { ... }" entries,
+// where every top-level entry is parsed into a document of its own holding
+// only that entry. Reading stops at length or a null-terminator, whichever
+// is first, pContent must outlive the iterator. noodleRecordsNext returns 
+// false once there are no more records. A record that fails to parse gives
+// a NULL document and an error, the records after it are still read. A 
+// record missing its value ends before the key of the next one. The records
+// share a string table and are cleaned up with noodleCleanup.
+NoodleRecords_t*        noodleRecordsOpen(const char* pContent, size_t length, const NoodleAllocator_t* NOODLE_NULLABLE pAllocator, NoodleStringTable_t* NOODLE_NULLABLE pStrings);
+NOODLE_BOOL             noodleRecordsNext(NoodleRecords_t* pRecords, NoodleGroup_t** ppRecord, char* NOODLE_NULLABLE pErrorBuffer, size_t NOODLE_NULLABLE bufferSize);
+void                    noodleRecordsClose(NoodleRecords_t* pRecords);
+
+// Parses records like noodleRecordsNext on threadCount threads, or one per
+// processor when zero, including the calling thread. Each thread takes the
+// next batch of records in turn and calls back with every record it parses,
+// so callbacks run at once and out of order, index gives a record's place.
+// Returns once every record was parsed, false when a callback stopped it.
+NOODLE_BOOL             noodleParseRecords(const char* pContent, size_t length, size_t threadCount, NoodleRecordCallback_t callback, void* NOODLE_NULLABLE pUser);
+
+// Drops the cache's hold on every included file, so changed or deleted files 
+// are let go. Documents still using an included file keep it alive.
+void                    noodleIncludeCacheClear(void);
+
+// Only matches up the curlies and parses the root's own entries, any other 
+// group is parsed the first time it's searched. That is safe from multiple 
+// threads. pContent is not copied and must outlive the document. Errors in 
+// groups that haven't been parsed yet aren't reported, such groups are empty.
+NoodleGroup_t*          noodleParseLazy(const char* pContent, const NoodleAllocator_t* NOODLE_NULLABLE pAllocator, NoodleStringTable_t* NOODLE_NULLABLE pStrings, char* NOODLE_NULLABLE pErrorBuffer, size_t NOODLE_NULLABLE bufferSize);
+
+// Checks the syntax of a document without building it or allocating any 
+// memory. Reading stops at length or a null-terminator, whichever is first.
+// Unlike the parsers, groups left open at the end are reported as errors.
+NOODLE_BOOL             noodleValidate(const char* pContent, size_t length, char* NOODLE_NULLABLE pErrorBuffer, size_t NOODLE_NULLABLE bufferSize);
+
+// Converts between noodle and JSON straight from the lexer, output is handed
+// to write in pieces as it's made. No tree is built and memory use doesn't 
+// grow with the document. noodleToJson writes compact JSON and can't convert
+// includes. noodleFromJson needs an object at the top, keys that are letters
+// and underscores, and arrays of a single type that aren't empty or nested. 
+// Integers in arrays that also hold floats become floats, exponents are 
+// written out in full. There is nothing for null or negative numbers, nor
+// for the character U+0000 in strings, other control characters stay escaped.
+NOODLE_BOOL             noodleToJson(const char* pContent, size_t length, NoodleWriteFunction_t write, void* NOODLE_NULLABLE pUser, char* NOODLE_NULLABLE pErrorBuffer, size_t NOODLE_NULLABLE bufferSize);
+NOODLE_BOOL             noodleFromJson(const char* pContent, size_t length, NoodleWriteFunction_t write, void* NOODLE_NULLABLE pUser, char* NOODLE_NULLABLE pErrorBuffer, size_t NOODLE_NULLABLE bufferSize);
 
-NoodleGroup_t*          noodleParse(const char* pContent, char* NOODLE_NULLABLE pErrorBuffer, size_t NOODLE_NULLABLE bufferSize);
-NoodleGroup_t*          noodleParseFromFile(const char* pPath, char* NOODLE_NULLABLE pErrorBuffer, size_t NOODLE_NULLABLE bufferSize);
 Noodle_t*               noodleFrom(const NoodleGroup_t* pGroup, const char* pName);
+Noodle_t*               noodleFromInterned(const NoodleGroup_t* pGroup, const char* pKey);
 NoodleGroup_t*          noodleGroupFrom(const NoodleGroup_t* pGroup, const char* pName);
 int                     noodleIntFrom(const NoodleGroup_t* pGroup, const char* pName, NOODLE_BOOL* NOODLE_NULLABLE pSucceeded);
 float                   noodleFloatFrom(const NoodleGroup_t* pGroup, const char* pName, NOODLE_BOOL* NOODLE_NULLABLE pSucceeded);
 NOODLE_BOOL             noodleBoolFrom(const NoodleGroup_t* pGroup, const char* pName, NOODLE_BOOL* NOODLE_NULLABLE pSucceeded);
 const char*             noodleStringFrom(const NoodleGroup_t* pGroup, const char* pName, NOODLE_BOOL* NOODLE_NULLABLE pSucceeded);
 const NoodleArray_t*    noodleArrayFrom(const NoodleGroup_t* pGroup, const char* pName);
+
+// Same as noodleFrom with the hash of the name worked out ahead of time, as
+// noodle.hpp does for literals at compile time. The hash is sdbm over the
+// name's chars, hash = c + (hash << 6) + (hash << 16) - hash starting from 
+// zero with a size_t. A wrong hash finds nothing.
+Noodle_t*               noodleFromHashed(const NoodleGroup_t* pGroup, const char* pName, size_t hash);
+
+// Read a noodle found by any of the lookups. Unlike the getters above these
+// don't assert when the noodle is of another type, they fail instead.
+int                     noodleIntOf(const Noodle_t* pNoodle, NOODLE_BOOL* NOODLE_NULLABLE pSucceeded);
+float                   noodleFloatOf(const Noodle_t* pNoodle, NOODLE_BOOL* NOODLE_NULLABLE pSucceeded);
+NOODLE_BOOL             noodleBoolOf(const Noodle_t* pNoodle, NOODLE_BOOL* NOODLE_NULLABLE pSucceeded);
+const char*             noodleStringOf(const Noodle_t* pNoodle); // NULL when it's not a string
+
+// Looks up many keys of one group at once. Every key is hashed up front and
+// the memory each lookup needs is prefetched in stages, so the cache misses 
+// overlap. Missing keys give NULL, or zero and false through pSucceeded for 
+// the typed variants. The number of keys found is returned.
+size_t                  noodleGetMany(const NoodleGroup_t* pGroup, const char* const* ppNames, size_t count, Noodle_t** ppNoodles);
+size_t                  noodleGetManyInts(const NoodleGroup_t* pGroup, const char* const* ppNames, size_t count, int* pValues, NOODLE_BOOL* NOODLE_NULLABLE pSucceeded);
+size_t                  noodleGetManyFloats(const NoodleGroup_t* pGroup, const char* const* ppNames, size_t count, float* pValues, NOODLE_BOOL* NOODLE_NULLABLE pSucceeded);
+size_t                  noodleGetManyBools(const NoodleGroup_t* pGroup, const char* const* ppNames, size_t count, NOODLE_BOOL* pValues, NOODLE_BOOL* NOODLE_NULLABLE pSucceeded);
+size_t                  noodleGetManyStrings(const NoodleGroup_t* pGroup, const char* const* ppNames, size_t count, const char** ppValues, NOODLE_BOOL* NOODLE_NULLABLE pSucceeded);
+
 size_t                  noodleCount(const Noodle_t* noodle);
 int                     noodleIntAt(const NoodleArray_t* pArray, size_t index);
 float                   noodleFloatAt(const NoodleArray_t* pArray, size_t index);
 NOODLE_BOOL             noodleBoolAt(const NoodleArray_t* pArray, size_t index);
 const char*             noodleStringAt(const NoodleArray_t* pArray, size_t index);
+NoodleType_t            noodleArrayType(const NoodleArray_t* pArray); // Of the elements
+const void*             noodleArrayData(const NoodleArray_t* pArray); // The elements in order, int, float, NOODLE_BOOL or const char* by type
 void                    noodleCleanup(NoodleGroup_t* pGroup);
 
+// Hands a document over to a background thread which cleans it up, so this
+// returns at once however large the document is. The document's allocator
+// is called from that thread. Documents parsed with a context are cleaned 
+// up right away instead, as is everything when the thread can't be started.
+// noodleCleanupWait blocks until every document handed over is cleaned up.
+void                    noodleCleanupDeferred(NoodleGroup_t* pGroup);
+void                    noodleCleanupWait(void);
+
 NOODLE_BOOL             noodleHas(const NoodleGroup_t* pGroup, const char* pName);
 void                    noodleGroupForeach(NoodleGroup_t* pGroup, NoodleForeachGroupCallback_t callback);
+size_t                  noodleMemoryUsage(const Noodle_t* pNoodle);
+const NoodleAllocator_t* noodleAllocator(const Noodle_t* pNoodle);
+
+// Rebuilds every group of the document into an immutable minimal perfect hash 
+// table, lookups then take a single key compare. Getters work as before.
+// Groups with a key written more than once keep their regular index and make
+// this return false, as do the rare groups where two keys hash the same.
+NOODLE_BOOL             noodleFreeze(NoodleGroup_t* pRoot);
+
+// A 64-bit structural hash of a subtree, equal subtrees have equal ones no
+// matter the order their keys were written in. The noodle's own name is not
+// part of it. Every group caches its fingerprint, noodleParse computes them 
+// as groups close and other documents on first use, so comparing two groups
+// takes constant time afterwards. Only stable within one process.
+uint64_t                noodleFingerprint(const Noodle_t* pNoodle);
+
+// Reports every key that was added, removed or changed between two groups,
+// pPath joins the keys from the given groups down with dots. Keys are looked
+// up through the index of the other group, and subtrees with the same 
+// fingerprint are skipped whole. A group that was added or removed is one 
+// event. Returns false when the callback breaks or memory runs out.
+NOODLE_BOOL             noodleDiff(const NoodleGroup_t* pOld, const NoodleGroup_t* pNew, NoodleDiffCallback_t callback, void* NOODLE_NULLABLE pUser);
+
+// Selectors are keys joined with dots, such as audio.*.volume. A * matches
+// every key of a group and ** matches any number of nested groups, even 
+// none, so **.enabled finds enabled at any depth. Keys are found through the
+// group's index and only groups are searched further. Up to capacity matches
+// are written to ppResults, the number of matches found is returned. Each 
+// match is found once, however many paths through ** lead to it. Selectors 
+// with more than one ** keep track of the groups they passed with the 
+// query's allocator and return SIZE_MAX when that runs out of memory.
+NoodleQuery_t*          noodleQueryCompile(const char* pSelector, const NoodleAllocator_t* NOODLE_NULLABLE pAllocator, char* NOODLE_NULLABLE pErrorBuffer, size_t NOODLE_NULLABLE bufferSize);
+size_t                  noodleQueryRun(const NoodleQuery_t* pQuery, const NoodleGroup_t* pGroup, Noodle_t** NOODLE_NULLABLE ppResults, size_t capacity);
+void                    noodleQueryCleanup(NoodleQuery_t* pQuery);
+
+// Key names are interned into a string table, by default each document owns 
+// its own. A table can instead be shared between documents by passing it to 
+// noodleParse, documents keep it alive until they are cleaned up. Parsing 
+// into the same table from multiple threads at once is not supported.
+NoodleStringTable_t*    noodleStringTableCreate(const NoodleAllocator_t* NOODLE_NULLABLE pAllocator);
+void                    noodleStringTableDestroy(NoodleStringTable_t* pStrings);
+const char*             noodleIntern(const Noodle_t* pNoodle, const char* pName); // NULL when no key has this name
+
+// Combines groups of other documents into a read-only view without copying 
+// them, later layers override earlier ones. Groups found in several layers 
+// are merged the first time they're looked up, any other value comes from 
+// the last layer that has it. Merging takes a lock, later lookups of a 
+// merged group don't, so views can be read from many threads at once. The 
+// layers must outlive the view and must not change while it's used, cleaning
+// up the view with noodleCleanup leaves them untouched. Overlays can be 
+// layers of overlays.
+NoodleGroup_t*          noodleOverlay(const NoodleGroup_t* const* ppLayers, size_t count, const NoodleAllocator_t* NOODLE_NULLABLE pAllocator);
+
+// Deep copies any group, including an overlay, into a new document
+NoodleGroup_t*          noodleFlatten(const NoodleGroup_t* pGroup, const NoodleAllocator_t* NOODLE_NULLABLE pAllocator, NoodleStringTable_t* NOODLE_NULLABLE pStrings);
+
+// A flat alternative to the tree, the whole document is one array of words
+// plus one buffer of strings. Values are addressed by their index on the 
+// tape, the root group is at index zero. Lookups skip nested groups and 
+// arrays in a single step. NOODLE_TAPE_NONE is returned when nothing is found.
+NoodleTape_t*           noodleParseTape(const char* pContent, const NoodleAllocator_t* NOODLE_NULLABLE pAllocator, char* NOODLE_NULLABLE pErrorBuffer, size_t NOODLE_NULLABLE bufferSize);
+NoodleTape_t*           noodleTapeClone(const NoodleTape_t* pTape, const NoodleAllocator_t* NOODLE_NULLABLE pAllocator);
+void                    noodleTapeCleanup(NoodleTape_t* pTape);
+size_t                  noodleTapeFrom(const NoodleTape_t* pTape, size_t group, const char* pName);
+size_t                  noodleTapeAt(const NoodleTape_t* pTape, size_t array, size_t index);
+NoodleType_t            noodleTapeType(const NoodleTape_t* pTape, size_t index);
+size_t                  noodleTapeCount(const NoodleTape_t* pTape, size_t index);
+int                     noodleTapeInt(const NoodleTape_t* pTape, size_t index);
+float                   noodleTapeFloat(const NoodleTape_t* pTape, size_t index);
+NOODLE_BOOL             noodleTapeBool(const NoodleTape_t* pTape, size_t index);
+const char*             noodleTapeString(const NoodleTape_t* pTape, size_t index);
+
+// Shares a tape between the processes of a host through shared memory. The
+// publisher copies each tape it publishes into a segment of its own, which
+// subscribers map read-only and read with the tape getters without parsing 
+// or copying it. Names follow shm_open, a slash followed by a short name, 
+// and must leave room for a generation to be added to them. Processes must
+// run the same build of the library.
+//
+// Every publish moves the generation on, noodleSubscriberTape checks it and
+// maps the newest tape when it changed, so it's cheap to call before every 
+// use. A tape it returned stays valid until the next call, which may unmap
+// it, and can be copied with noodleTapeClone to keep it longer. A subscriber
+// is meant for one thread, each thread reading a tape subscribes on its own.
+// Tapes of a subscriber are never given to noodleTapeCleanup, they go away
+// with noodleUnsubscribe. NULL is returned until something is published. Destroying the publisher leaves the last tape published, 
+// another publisher of the same name carries on from it. noodleUnpublish 
+// removes it, subscribers keep what they have mapped and have to subscribe 
+// again to see anything published after.
+NoodlePublisher_t*      noodlePublisherCreate(const char* pName, const NoodleAllocator_t* NOODLE_NULLABLE pAllocator, char* NOODLE_NULLABLE pErrorBuffer, size_t NOODLE_NULLABLE bufferSize);
+void                    noodlePublisherDestroy(NoodlePublisher_t* pPublisher);
+NOODLE_BOOL             noodlePublish(NoodlePublisher_t* pPublisher, const NoodleTape_t* pTape);
+void                    noodleUnpublish(const char* pName);
+NoodleSubscriber_t*     noodleSubscribe(const char* pName, const NoodleAllocator_t* NOODLE_NULLABLE pAllocator, char* NOODLE_NULLABLE pErrorBuffer, size_t NOODLE_NULLABLE bufferSize);
+void                    noodleUnsubscribe(NoodleSubscriber_t* pSubscriber);
+const NoodleTape_t*     noodleSubscriberTape(NoodleSubscriber_t* pSubscriber);
+uint64_t                noodleSubscriberGeneration(const NoodleSubscriber_t* pSubscriber); // Of the tape last returned, zero before any
+
+#ifdef __cplusplus
+}
+#endif
 
 #endif // NOODLE_PARSER_H
\ No newline at end of file
@@ -0,0 +1,314 @@
+#ifndef NOODLE_PARSER_HPP
+#define NOODLE_PARSER_HPP
+
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+#if __cplusplus >= 202002L || (defined(_MSVC_LANG) && _MSVC_LANG >= 202002L)
+#include <span>
+#define NOODLE_HAS_SPAN 1
+#endif
+
+// Literal keys must be hashed while compiling when consteval is there,
+// before C++20 the hash is constexpr and left to the optimizer, NOODLE_KEY
+// makes sure of it then
+#ifdef __cpp_consteval
+#define NOODLE_CONSTEVAL consteval
+#else
+#define NOODLE_CONSTEVAL constexpr
+#endif
+
+#include "noodle.h"
+
+
+// A header-only C++17 layer over noodle.h. Keys written as literals carry
+// their hash so lookups don't hash at runtime, getters give std::optional
+// rather than asserting on the type, strings are std::string_view, arrays
+// are spans over the parsed elements and documents clean themselves up.
+namespace noodle
+{
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+// KEYS
+////////////////////////////////////////////////////////////////////////////////
+
+
+
+// The sdbm hash noodleFromHashed expects
+constexpr std::size_t hash(std::string_view name) noexcept
+{
+    std::size_t value = 0;
+
+    for (char c : name)
+        value = static_cast<std::size_t>(c) + (value << 6) + (value << 16) - value;
+
+    return value;
+}
+
+// A key name along with its hash, the name must be null-terminated and
+// outlive the key. Lookups take keys, so a literal passed to them is hashed
+// while compiling. Arrays are hashed up to their first null-terminator,
+// like the C lookups read the name.
+class Key
+{
+public:
+    template <std::size_t N>
+    NOODLE_CONSTEVAL Key(const char (&name)[N]) noexcept
+        : m_pName(name), m_hash(noodle::hash(std::string_view(name, length(name)))) {}
+
+    // Buffers filled at runtime, char pName[32] for example, are hashed here
+    template <std::size_t N>
+    constexpr Key(char (&name)[N]) noexcept
+        : m_pName(name), m_hash(noodle::hash(std::string_view(name, length(name)))) {}
+
+    // For names only known at runtime, which are hashed here
+    static Key runtime(const char* pName) noexcept { return Key(pName, noodle::hash(pName)); }
+
+    // For a hash that was already worked out, see NOODLE_KEY
+    template <std::size_t N>
+    static constexpr Key hashed(const char (&name)[N], std::size_t hash) noexcept { return Key(name, hash); }
+
+    constexpr const char* name() const noexcept { return m_pName; }
+    constexpr std::size_t hash() const noexcept { return m_hash; }
+
+private:
+    constexpr Key(const char* pName, std::size_t hash) noexcept : m_pName(pName), m_hash(hash) {}
+
+    template <std::size_t N>
+    static constexpr std::size_t length(const char (&name)[N]) noexcept
+    {
+        std::size_t length = 0;
+        while (length < N && name[length]) length++;
+
+        return length;
+    }
+
+    const char*     m_pName;
+    std::size_t     m_hash;
+};
+
+
+
+// Hashes a literal key while compiling in C++17 as well, the hash is taken
+// as a template argument. group.get<int>(NOODLE_KEY("width")) for example.
+#define NOODLE_KEY(name) (::noodle::Key::hashed(name, std::integral_constant<std::size_t, ::noodle::hash(name)>::value))
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+// ARRAYS
+////////////////////////////////////////////////////////////////////////////////
+
+
+
+// Arrays are viewed in place, the elements belong to the document
+#ifdef NOODLE_HAS_SPAN
+template <typename T>
+using Span = std::span<const T>;
+#else
+template <typename T>
+class Span
+{
+public:
+    constexpr Span() noexcept = default;
+    constexpr Span(const T* pData, std::size_t size) noexcept : m_pData(pData), m_size(size) {}
+
+    constexpr const T* data() const noexcept { return m_pData; }
+    constexpr std::size_t size() const noexcept { return m_size; }
+    constexpr bool empty() const noexcept { return m_size == 0; }
+    constexpr const T* begin() const noexcept { return m_pData; }
+    constexpr const T* end() const noexcept { return m_pData + m_size; }
+    constexpr const T& operator[](std::size_t index) const noexcept { return m_pData[index]; }
+
+private:
+    const T*        m_pData = nullptr;
+    std::size_t     m_size = 0;
+};
+#endif
+
+namespace detail
+{
+    template <typename T>
+    struct ArrayOf { using Element = void; };
+
+    template <typename T>
+    struct ArrayOf<Span<T>> { using Element = T; };
+
+    // The element type each array type is stored as
+    template <typename T>
+    constexpr NoodleType_t elementType() noexcept
+    {
+        if constexpr (std::is_same_v<T, int>) return NOODLE_TYPE_INTEGER;
+        else if constexpr (std::is_same_v<T, float>) return NOODLE_TYPE_FLOAT;
+        else if constexpr (std::is_same_v<T, NOODLE_BOOL>) return NOODLE_TYPE_BOOLEAN;
+        else if constexpr (std::is_same_v<T, const char*>) return NOODLE_TYPE_STRING;
+        else return NOODLE_TYPE_COUNT;
+    }
+
+    template <typename T>
+    constexpr bool unsupported = false;
+}
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+// GROUPS
+////////////////////////////////////////////////////////////////////////////////
+
+
+
+// Views a group of a document, it's only valid while the document is
+class Group
+{
+public:
+    constexpr Group() noexcept = default;
+    constexpr explicit Group(const NoodleGroup_t* pGroup) noexcept : m_pGroup(pGroup) {}
+
+    constexpr explicit operator bool() const noexcept { return m_pGroup != nullptr; }
+    constexpr const NoodleGroup_t* raw() const noexcept { return m_pGroup; }
+
+    std::size_t size() const noexcept { return m_pGroup ? noodleCount(reinterpret_cast<const Noodle_t*>(m_pGroup)) : 0; }
+    bool has(Key key) const noexcept { return find(key) != nullptr; }
+
+    const Noodle_t* find(Key key) const noexcept
+    {
+        return m_pGroup ? noodleFromHashed(m_pGroup, key.name(), key.hash()) : nullptr;
+    }
+
+    // T is int, float, bool, std::string_view, Group or a Span of int, float,
+    // NOODLE_BOOL or const char*. Nothing is returned when the key is missing
+    // or its value is of another type.
+    template <typename T>
+    std::optional<T> get(Key key) const noexcept
+    {
+        const Noodle_t* pNoodle = find(key);
+        if (!pNoodle) return std::nullopt;
+
+        NOODLE_BOOL succeeded = NOODLE_FALSE;
+
+        if constexpr (std::is_same_v<T, int>)
+        {
+            int value = noodleIntOf(pNoodle, &succeeded);
+            if (succeeded) return value;
+        }
+        else if constexpr (std::is_same_v<T, float>)
+        {
+            float value = noodleFloatOf(pNoodle, &succeeded);
+            if (succeeded) return value;
+        }
+        else if constexpr (std::is_same_v<T, bool>)
+        {
+            bool value = noodleBoolOf(pNoodle, &succeeded) != NOODLE_FALSE;
+            if (succeeded) return value;
+        }
+        else if constexpr (std::is_same_v<T, std::string_view>)
+        {
+            const char* pValue = noodleStringOf(pNoodle);
+            if (pValue) return std::string_view(pValue);
+        }
+        else if constexpr (std::is_same_v<T, Group>)
+        {
+            if (pNoodle->type == NOODLE_TYPE_GROUP) return Group(reinterpret_cast<const NoodleGroup_t*>(pNoodle));
+        }
+        else if constexpr (!std::is_void_v<typename detail::ArrayOf<T>::Element>)
+        {
+            using Element = typename detail::ArrayOf<T>::Element;
+            static_assert(detail::elementType<Element>() != NOODLE_TYPE_COUNT, "Arrays hold int, float, NOODLE_BOOL or const char*");
+
+            const NoodleArray_t* pArray = reinterpret_cast<const NoodleArray_t*>(pNoodle);
+
+            if (pNoodle->type == NOODLE_TYPE_ARRAY && noodleArrayType(pArray) == detail::elementType<Element>())
+                return T(static_cast<const Element*>(noodleArrayData(pArray)), noodleCount(pNoodle));
+        }
+        else
+        {
+            static_assert(detail::unsupported<T>, "Values are int, float, bool, std::string_view, Group or a Span");
+        }
+
+        return std::nullopt;
+    }
+
+    template <typename T>
+    T get(Key key, T fallback) const noexcept { return get<T>(key).value_or(fallback); }
+
+private:
+    const NoodleGroup_t* m_pGroup = nullptr;
+};
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+// DOCUMENTS
+////////////////////////////////////////////////////////////////////////////////
+
+
+
+// Owns a parsed document and cleans it up once it goes out of scope
+class Document
+{
+public:
+    Document() noexcept = default;
+    explicit Document(NoodleGroup_t* pRoot) noexcept : m_pRoot(pRoot) {}
+    ~Document() { noodleCleanup(m_pRoot); }
+
+    Document(const Document&) = delete;
+    Document& operator=(const Document&) = delete;
+
+    Document(Document&& other) noexcept : m_pRoot(std::exchange(other.m_pRoot, nullptr)) {}
+
+    Document& operator=(Document&& other) noexcept
+    {
+        if (this != &other)
+        {
+            noodleCleanup(m_pRoot);
+            m_pRoot = std::exchange(other.m_pRoot, nullptr);
+        }
+
+        return *this;
+    }
+
+    // An empty document is returned on failure, along with the reason
+    static Document parse(const char* pContent, std::string* pError = nullptr)
+    {
+        char pBuffer[512];
+        Document document(noodleParse(pContent, nullptr, nullptr, nullptr, pBuffer, sizeof(pBuffer)));
+        if (!document && pError) *pError = pBuffer;
+
+        return document;
+    }
+
+    static Document parseFile(const char* pPath, std::string* pError = nullptr)
+    {
+        char pBuffer[512];
+        Document document(noodleParseFromFile(pPath, nullptr, nullptr, nullptr, pBuffer, sizeof(pBuffer)));
+        if (!document && pError) *pError = pBuffer;
+
+        return document;
+    }
+
+    explicit operator bool() const noexcept { return m_pRoot != nullptr; }
+    NoodleGroup_t* raw() const noexcept { return m_pRoot; }
+    Group root() const noexcept { return Group(m_pRoot); }
+
+    // Gives up ownership, the caller cleans it up
+    NoodleGroup_t* release() noexcept { return std::exchange(m_pRoot, nullptr); }
+
+    template <typename T>
+    std::optional<T> get(Key key) const noexcept { return root().get<T>(key); }
+
+    template <typename T>
+    T get(Key key, T fallback) const noexcept { return root().get<T>(key, fallback); }
+
+private:
+    NoodleGroup_t*  m_pRoot = nullptr;
+};
+
+} // namespace noodle
+
+#endif // NOODLE_PARSER_HPP
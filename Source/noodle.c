@@ -1,8 +1,68 @@
 #include <assert.h>
+#include <limits.h>
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
-
+#include <sys/stat.h>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#if defined(_M_X64) || defined(_M_IX86)
+#include <xmmintrin.h>
+#endif
+#else
+#include <time.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#endif
+
+// Strings are scanned 16 bytes at a time with SSE2 or NEON when it's there
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define NOODLE_SSE2 1
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+#define NOODLE_NEON 1
+#include <arm_neon.h>
+#endif
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+// Files loaded asynchronously are read through io_uring when the kernel 
+// headers have it, it's used through the raw system calls so nothing more 
+// has to be linked. Define NOODLE_NO_IO_URING to always use the thread pool.
+#if defined(__linux__) && !defined(NOODLE_NO_IO_URING) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#define NOODLE_IO_URING 1
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <linux/io_uring.h>
+#endif
+#endif
+
+// Static tracepoints for perf and bpftrace are built in when NOODLE_TRACE is 
+// defined and systemtap's sys/sdt.h is found, see the NOODLE_PROBE macros
+#if defined(NOODLE_TRACE) && defined(__has_include)
+#if __has_include(<sys/sdt.h>)
+#define NOODLE_TRACE_PROBES 1
+#include <sys/sdt.h>
+#endif
+#endif
+
+#ifdef NOODLE_ZLIB
+#include <zlib.h>
+#endif
+
+#ifdef NOODLE_ZSTD
+#include <zstd.h>
+#endif
 
 #include "noodle.h"
 
@@ -13,7 +73,99 @@
 
 
 
-#define NOODLE_GROUP_BUCKETS_COUNT 16
+#define NOODLE_GROUP_INITIAL_CAPACITY 4
+#define NOODLE_FROZEN_KEYS_PER_BUCKET 4
+#define NOODLE_FROZEN_ATTEMPTS 4
+#define NOODLE_TAPE_INITIAL_CAPACITY 64
+#define NOODLE_TAPE_PAYLOAD_MASK 0x00ffffffffffffffull
+#define NOODLE_TAPE_OFFSET_MASK 0x000000ffffffffffull
+#define NOODLE_TAPE_KEY_HASH_SHIFT 40
+#define NOODLE_LAZY_PENDING 0
+#define NOODLE_LAZY_READY 1
+#define NOODLE_LAZY_FAILED 2
+#define NOODLE_PATH_MAX 4096
+#define NOODLE_GET_MANY_BATCH 32
+#define NOODLE_WRITER_CAPACITY 16384
+#define NOODLE_JSON_MAX_EXPONENT 64
+#define NOODLE_NUMBER_MAX_LENGTH 64
+#define NOODLE_LOADER_THREADS 4
+#define NOODLE_RING_ENTRIES 64
+#define NOODLE_RING_MAX_READ (1u << 30)
+#define NOODLE_STREAM_BLOCKS 4
+#define NOODLE_STREAM_BLOCK_SIZE (256 * 1024)
+#define NOODLE_STREAM_INPUT_SIZE (64 * 1024)
+#define NOODLE_POOL_CLASSES 20
+#define NOODLE_POOL_MIN_SIZE 16
+#define NOODLE_RECORD_BATCH_SIZE (256 * 1024)
+#define NOODLE_RECORD_ERROR_SIZE 512
+#define NOODLE_SHARED_NAME_MAX 256
+#define NOODLE_SHARED_MAGIC 0x31656c646f6f6eull // "noodle1"
+#define NOODLE_SHARED_ATTEMPTS 8
+
+#if defined(__GNUC__) || defined(__clang__)
+#define NOODLE_PREFETCH(pAddress) __builtin_prefetch(pAddress)
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#define NOODLE_PREFETCH(pAddress) _mm_prefetch((const char*)(pAddress), _MM_HINT_T0)
+#else
+#define NOODLE_PREFETCH(pAddress) ((void)(pAddress))
+#endif
+
+// Each probe is a single nop until a tracer attaches to it, the arguments are
+// only read then. Durations are measured by the tracer between a start and 
+// a done probe, so the library never reads the clock for them. Without 
+// probes the arguments are never evaluated, sizeof only keeps them used.
+#ifdef NOODLE_TRACE_PROBES
+#define NOODLE_PROBE1(name, a) DTRACE_PROBE1(noodlec, name, a)
+#define NOODLE_PROBE2(name, a, b) DTRACE_PROBE2(noodlec, name, a, b)
+#define NOODLE_PROBE3(name, a, b, c) DTRACE_PROBE3(noodlec, name, a, b, c)
+#else
+#define NOODLE_PROBE1(name, a) ((void)sizeof(a))
+#define NOODLE_PROBE2(name, a, b) ((void)sizeof(a), (void)sizeof(b))
+#define NOODLE_PROBE3(name, a, b, c) ((void)sizeof(a), (void)sizeof(b), (void)sizeof(c))
+#endif
+
+#ifdef _WIN32
+#define NOODLE_IS_SEPARATOR(c) ((c) == '/' || (c) == '\\')
+#else
+#define NOODLE_IS_SEPARATOR(c) ((c) == '/')
+#endif
+
+// Files larger than 2 GiB need 64-bit offsets, long is 32 bits on Windows
+#ifdef _WIN32
+#define NOODLE_FSEEK(pFile, offset, origin) _fseeki64((pFile), (offset), (origin))
+#define NOODLE_FTELL(pFile) _ftelli64(pFile)
+#else
+#define NOODLE_FSEEK(pFile, offset, origin) fseeko((pFile), (off_t)(offset), (origin))
+#define NOODLE_FTELL(pFile) ftello(pFile)
+#endif
+
+#ifdef _WIN32
+#define NOODLE_LOAD_ACQUIRE(pValue) InterlockedCompareExchange((volatile LONG*)(pValue), 0, 0)
+#define NOODLE_STORE_RELEASE(pValue, value) InterlockedExchange((volatile LONG*)(pValue), (value))
+#define NOODLE_LOAD_ACQUIRE64(pValue) (uint64_t)InterlockedCompareExchange64((volatile LONG64*)(pValue), 0, 0)
+#define NOODLE_STORE_RELEASE64(pValue, value) InterlockedExchange64((volatile LONG64*)(pValue), (LONG64)(value))
+#define NOODLE_INCREMENT(pValue) InterlockedIncrement((volatile LONG*)(pValue))
+#define NOODLE_DECREMENT(pValue) InterlockedDecrement((volatile LONG*)(pValue))
+#define NOODLE_LOAD_ACQUIRE_POINTER(pValue) InterlockedCompareExchangePointer((PVOID volatile*)(pValue), NULL, NULL)
+#define NOODLE_STORE_RELEASE_POINTER(pValue, value) InterlockedExchangePointer((PVOID volatile*)(pValue), (PVOID)(value))
+#else
+#define NOODLE_LOAD_ACQUIRE(pValue) __atomic_load_n((pValue), __ATOMIC_ACQUIRE)
+#define NOODLE_STORE_RELEASE(pValue, value) __atomic_store_n((pValue), (value), __ATOMIC_RELEASE)
+#define NOODLE_LOAD_ACQUIRE64(pValue) __atomic_load_n((pValue), __ATOMIC_ACQUIRE)
+#define NOODLE_STORE_RELEASE64(pValue, value) __atomic_store_n((pValue), (value), __ATOMIC_RELEASE)
+#define NOODLE_INCREMENT(pValue) __atomic_add_fetch((pValue), 1, __ATOMIC_ACQ_REL)
+#define NOODLE_DECREMENT(pValue) __atomic_sub_fetch((pValue), 1, __ATOMIC_ACQ_REL)
+#define NOODLE_LOAD_ACQUIRE_POINTER(pValue) __atomic_load_n((pValue), __ATOMIC_ACQUIRE)
+#define NOODLE_STORE_RELEASE_POINTER(pValue, value) __atomic_store_n((pValue), (value), __ATOMIC_RELEASE)
+#endif
+
+// Loads from memory other processes write, which may be mapped read-only so 
+// the load can't be an interlocked exchange
+#ifdef _WIN32
+#define NOODLE_LOAD_SHARED64(pValue) (uint64_t)ReadAcquire64((volatile const LONG64*)(pValue))
+#else
+#define NOODLE_LOAD_SHARED64(pValue) __atomic_load_n((pValue), __ATOMIC_ACQUIRE)
+#endif
 
 
 
@@ -23,20 +175,8 @@
 
 
 
-typedef struct NoodleNode_t
-{
-    struct NoodleNode_t* pNext;
-    Noodle_t* pNoodle;
-} NoodleNode_t;
-
-typedef struct NoodleGroup_t
-{
-    Noodle_t        base;
-    size_t          count;
-    size_t          bucketCount;
-    NoodleNode_t*   ppBuckets[NOODLE_GROUP_BUCKETS_COUNT]; // Each must be freed
-} NoodleGroup_t;
-
+// Every entry of a group, scalars are stored inline while groups and arrays
+// are allocated separately and pointed to.
 typedef struct NoodleValue_t
 {
     Noodle_t    base;
@@ -46,9 +186,461 @@ typedef struct NoodleValue_t
         float       f;
         NOODLE_BOOL b;
         char*       s; // Must be freed
+        Noodle_t*   pChild; // Groups and arrays, must be freed
     };
 } NoodleValue_t;
 
+// A frozen group replaces its index with a CHD style minimal perfect hash,
+// a key's bucket picks a seed which places it in exactly one slot. The 
+// displacements and slots live in the same allocation as this header.
+typedef struct NoodleFrozen_t
+{
+    size_t          count;
+    size_t          bucketCount;
+    uint32_t*       pSeeds; // One per bucket
+    uint32_t*       pSlots; // One entry index per key, placed by the perfect hash
+} NoodleFrozen_t;
+
+typedef struct NoodleGroup_t
+{
+    Noodle_t        base;
+    uint32_t        count;
+    uint32_t        capacity;
+    uint32_t        indexCapacity; // Always a power of two
+    NOODLE_BOOL     lazy; // Actually a NoodleLazyGroup_t, see below
+    NOODLE_BOOL     overlay; // Actually a NoodleOverlay_t, see below
+    NOODLE_BOOL     included; // Belongs to an included file, which interns its keys into its own table
+    NoodleValue_t*  pEntries; // In insertion order
+    uint32_t*       pIndex; // Open addressing, an entry index plus one or zero when empty
+    NoodleFrozen_t* pFrozen; // Replaces the index when not NULL
+    volatile uint64_t fingerprint; // Zero until it's computed, see noodleFingerprint
+} NoodleGroup_t;
+
+// Every key name is stored once inside of a string table, names given to
+// noodles point to pData so the header can be found from the name.
+typedef struct NoodleString_t
+{
+    size_t  hash;
+    size_t  length;
+    char    pData[];
+} NoodleString_t;
+
+typedef struct NoodleStringTable_t
+{
+    NoodleAllocator_t   allocator;
+    volatile long       references; // Documents sharing it may be cleaned up on any thread
+    size_t              count;
+    size_t              capacity; // Always a power of two
+    size_t              bytes;
+    NoodleString_t**    ppSlots; // Open addressing, linear probing
+} NoodleStringTable_t;
+
+#ifdef _WIN32
+typedef SRWLOCK NoodleMutex_t;
+typedef CONDITION_VARIABLE NoodleCondition_t;
+typedef HANDLE NoodleThread_t;
+typedef DWORD NoodleThreadResult_t;
+#define NOODLE_MUTEX_INITIALIZER SRWLOCK_INIT
+#define NOODLE_CONDITION_INITIALIZER CONDITION_VARIABLE_INIT
+#define NOODLE_THREAD_CALL WINAPI
+#else
+typedef pthread_mutex_t NoodleMutex_t;
+typedef pthread_cond_t NoodleCondition_t;
+typedef pthread_t NoodleThread_t;
+typedef void* NoodleThreadResult_t;
+#define NOODLE_MUTEX_INITIALIZER PTHREAD_MUTEX_INITIALIZER
+#define NOODLE_CONDITION_INITIALIZER PTHREAD_COND_INITIALIZER
+#define NOODLE_THREAD_CALL
+#endif
+
+typedef NoodleThreadResult_t (NOODLE_THREAD_CALL * NoodleThreadFunction_t)(void* pUser);
+
+// Every group of a lazily parsed document is laid out up front by a scan of
+// the curlies, in the order they open. Only the range of the body is known 
+// until the group is first searched, then its entries are parsed. Groups 
+// nested inside directly follow it, so whole subtrees can be skipped.
+typedef struct NoodleLazyGroup_t
+{
+    NoodleGroup_t   group;
+    volatile long   state; // NOODLE_LAZY_PENDING, READY or FAILED
+    size_t          start; // Just past the opening curly
+    size_t          next; // Just past the closing curly
+    size_t          nextLine; // Line of the closing curly
+    size_t          nextLineStart; // Offset of that line, gives the column after skipping the body
+    size_t          descendants; // Lazy groups nested at any depth
+} NoodleLazyGroup_t;
+
+// The root group of a document also owns the document wide state
+typedef struct NoodleRoot_t
+{
+    NoodleGroup_t           group;
+    NoodleAllocator_t       allocator;
+    NoodleStringTable_t*    pStrings;
+    NOODLE_BOOL             sharedStrings;
+    const char*             pSource; // Lazy documents only, owned by the caller
+    size_t                  sourceLength;
+    NoodleLazyGroup_t*      pLazyGroups;
+    size_t                  lazyCount;
+    NoodleMutex_t           lock; // Held while a lazy group is parsed or an overlay is extended
+    struct NoodleInclude_t** ppIncludes; // Kept alive while their groups are borrowed
+    size_t                  includeCount;
+} NoodleRoot_t;
+
+// A file parsed once for every document that includes it. The document is 
+// frozen and never changes, its groups and arrays are borrowed by the groups
+// that include it rather than copied. A borrowed noodle's parent is not the 
+// group borrowing it, which is how it's told apart from an owned one.
+typedef struct NoodleInclude_t
+{
+    struct NoodleInclude_t* pNext; // In the cache
+    size_t                  references; // One for the cache while it's listed, one per document
+    NoodleGroup_t*          pDocument;
+    int64_t                 modified;
+    int64_t                 size;
+    char                    pPath[]; // Canonical, the cache is keyed by it
+} NoodleInclude_t;
+
+// Every block a context hands out is preceded by this header. Blocks are
+// sized to a power of two so a freed block serves any later request of its
+// class, blocks too large for every class are freed right away.
+typedef struct NoodlePoolBlock_t
+{
+    union
+    {
+        struct NoodlePoolBlock_t*   pNext; // Next free block of the same class
+        size_t                      capacity; // Unpooled blocks only, they're never free listed
+    };
+    size_t                          sizeClass; // NOODLE_POOL_CLASSES when not pooled
+} NoodlePoolBlock_t;
+
+// The size a group reached in the last document of a context, groups are
+// listed in the order they opened
+typedef struct NoodleGroupHint_t
+{
+    const char*     pName; // Interned, so compared by pointer
+    uint32_t        count;
+} NoodleGroupHint_t;
+
+// Outlives the documents parsed with it so their memory, key names and the
+// sizes of their groups are reused by the next parse
+typedef struct NoodleContext_t
+{
+    NoodleAllocator_t       allocator; // Backs the pools, hints and string table
+    NoodleAllocator_t       pool; // Given to the documents, see noodlePoolAlloc
+    NoodlePoolBlock_t*      ppFree[NOODLE_POOL_CLASSES];
+    size_t                  liveBlocks; // Handed out and not freed yet
+    NoodleStringTable_t*    pStrings;
+    NoodleGroupHint_t*      pHints;
+    size_t                  hintCount;
+    size_t                  hintCapacity;
+} NoodleContext_t;
+
+// Where scanning for the next record carries on, records are top-level 
+// entries and each one is parsed as a document of its own
+typedef struct NoodleRecordCursor_t
+{
+    size_t      position;
+    size_t      index; // Of the next record
+    size_t      line;
+    size_t      lineStart; // Offset of the line, gives the record's column
+} NoodleRecordCursor_t;
+
+typedef struct NoodleRecords_t
+{
+    const char*             pContent;
+    size_t                  length;
+    NoodleRecordCursor_t    cursor;
+    NoodleAllocator_t       allocator;
+    NoodleStringTable_t*    pStrings; // Shared by every record
+} NoodleRecords_t;
+
+// Shared by the threads of noodleParseRecords, each takes the next batch of 
+// records while holding the lock and parses it after letting go
+typedef struct NoodleRecordJob_t
+{
+    const char*             pContent;
+    size_t                  length;
+    NoodleRecordCallback_t  callback;
+    void*                   pUser;
+    NoodleMutex_t           lock;
+    NoodleRecordCursor_t    cursor;
+    volatile long           stopped; // Set once a callback returns false
+} NoodleRecordJob_t;
+
+// The files currently being included, innermost first, to catch cycles
+typedef struct NoodleIncludeFrame_t
+{
+    const char*                         pPath; // Canonical
+    const struct NoodleIncludeFrame_t*  pPrevious;
+} NoodleIncludeFrame_t;
+
+// The nested overlays made so far, by name. Slots only ever go from NULL to
+// a finished overlay, so they're read without the lock. A full table is 
+// replaced by a larger copy, the old one stays valid for readers still in
+// it until the overlay is cleaned up.
+typedef struct NoodleOverlayTable_t
+{
+    size_t                          capacity; // Always a power of two
+    size_t                          count;
+    struct NoodleOverlayTable_t*    pPrevious; // Replaced by this one
+    struct NoodleOverlay_t* volatile pSlots[];
+} NoodleOverlayTable_t;
+
+// A read-only view over groups that belong to other documents. Lookups try
+// the layers from the last to the first, a group found in more than one 
+// layer becomes a nested overlay the first time it's looked up. Only the 
+// outermost overlay is a root, the others only use its group and allocator.
+typedef struct NoodleOverlay_t
+{
+    NoodleRoot_t            root;
+    size_t                  count;
+    const NoodleGroup_t**   ppLayers; // Same allocation as the overlay, first is the bottom
+    NoodleOverlayTable_t* volatile pTable; // Published with release, NULL until a group is merged
+    struct NoodleOverlay_t* pChildren; // Nested overlays made so far
+    struct NoodleOverlay_t* pNext; // The next of the parent's nested overlays
+} NoodleOverlay_t;
+
+typedef NOODLE_BOOL (* NoodleVisitFunction_t)(void* pUser, Noodle_t* pNoodle); // Return false to stop
+
+// An overlay visiting the keys of one of its layers
+typedef struct NoodleVisitLayer_t
+{
+    const NoodleOverlay_t*  pOverlay;
+    size_t                  index;
+    NoodleVisitFunction_t   visit;
+    void*                   pUser;
+} NoodleVisitLayer_t;
+
+// The entries of a group summed so their order doesn't matter
+typedef struct NoodleFingerprint_t
+{
+    uint64_t    sum;
+    size_t      count;
+} NoodleFingerprint_t;
+
+// The state of one noodleDiff walk, pPath holds the dotted path of the key
+// being compared
+typedef struct NoodleDiff_t
+{
+    NoodleDiffCallback_t        callback;
+    void*                       pUser;
+    const NoodleAllocator_t*    pAllocator;
+    char*                       pPath;
+    size_t                      length;
+    size_t                      capacity;
+} NoodleDiff_t;
+
+// A pair of groups being compared, keys are visited from the old group and
+// then from the new one to find the added keys
+typedef struct NoodleDiffLevel_t
+{
+    NoodleDiff_t*           pDiff;
+    const NoodleGroup_t*    pOld;
+    const NoodleGroup_t*    pNew;
+    NOODLE_BOOL             added;
+} NoodleDiffLevel_t;
+
+typedef enum NoodleQueryStepKind_t
+{
+    NOODLE_QUERY_STEP_KEY, // A single key found through the index
+    NOODLE_QUERY_STEP_ANY, // *, every key of the group
+    NOODLE_QUERY_STEP_DESCENDANTS, // **, any number of nested groups including none
+} NoodleQueryStepKind_t;
+
+typedef struct NoodleQueryStep_t
+{
+    NoodleQueryStepKind_t   kind;
+    const char*             pName; // Keys only, stored after the steps
+    size_t                  hash;
+} NoodleQueryStep_t;
+
+// A compiled selector, the steps and their names share one allocation
+typedef struct NoodleQuery_t
+{
+    NoodleAllocator_t   allocator;
+    size_t              count;
+    size_t              descents; // Steps that are **
+    NoodleQueryStep_t   pSteps[];
+} NoodleQuery_t;
+
+// A group reached while matching a step, see NoodleQueryRun_t
+typedef struct NoodleQueryVisit_t
+{
+    const NoodleGroup_t*    pGroup;
+    size_t                  step;
+} NoodleQueryVisit_t;
+
+// Where a query writes its matches, count keeps going past the capacity.
+// With more than one ** a group can be reached along several paths for the
+// same step, the visits are kept so each one is only matched once.
+typedef struct NoodleQueryRun_t
+{
+    const NoodleQuery_t*    pQuery;
+    Noodle_t**              ppResults;
+    size_t                  capacity;
+    size_t                  count;
+    NoodleQueryVisit_t*     pVisits; // Open addressing, linear probing
+    size_t                  visitCapacity; // Always a power of two
+    size_t                  visitCount;
+    NOODLE_BOOL             failed; // Visits couldn't be kept, the count is unreliable
+} NoodleQueryRun_t;
+
+// The step a group's children are being matched against
+typedef struct NoodleQueryLevel_t
+{
+    NoodleQueryRun_t*   pRun;
+    size_t              step;
+} NoodleQueryLevel_t;
+
+// Output of the converters is gathered here and handed to the caller's write
+// function in large pieces
+typedef struct NoodleWriter_t
+{
+    NoodleWriteFunction_t   write;
+    void*                   pUser;
+    size_t                  size;
+    NOODLE_BOOL             failed;
+    char                    pBuffer[NOODLE_WRITER_CAPACITY];
+} NoodleWriter_t;
+
+// A file queued by noodleParseFromFileAsync
+typedef struct NoodleLoad_t
+{
+    struct NoodleLoad_t*    pNext;
+    NoodleParseCallback_t   callback;
+    void*                   pUser;
+    char*                   pContent; // Only used by the ring, read into in place
+    size_t                  size;
+    size_t                  read;
+    int                     file;
+    char                    pPath[];
+} NoodleLoad_t;
+
+// Loader threads are started on the first asynchronous load and live for the
+// rest of the process
+typedef struct NoodleLoader_t
+{
+    NoodleMutex_t       lock;
+    NoodleCondition_t   wake; // Signaled when loads are queued
+    NoodleCondition_t   idle; // Broadcast when the last pending load is done
+    NoodleLoad_t*       pFirst; // Queued in order, not yet taken by a thread
+    NoodleLoad_t*       pLast;
+    size_t              pending; // Queued or loading
+    NOODLE_BOOL         started;
+} NoodleLoader_t;
+
+// Documents handed over by noodleCleanupDeferred, linked through the parent
+// pointers of their roots which are otherwise always NULL
+typedef struct NoodleReclaimer_t
+{
+    NoodleMutex_t       lock;
+    NoodleCondition_t   wake; // Signaled when documents are queued
+    NoodleCondition_t   idle; // Broadcast once every queued document is cleaned up
+    NoodleGroup_t*      pFirst; // Not yet taken by the thread
+    size_t              pending; // Queued or being cleaned up
+    NOODLE_BOOL         started;
+} NoodleReclaimer_t;
+
+// Published tapes are mapped at a different address in every process, so
+// nothing in shared memory is a pointer. The control segment only holds the
+// generation of the current image, every image is a segment of its own 
+// named after its generation which is never written once it's published.
+typedef struct NoodleSharedControl_t
+{
+    uint64_t            magic;
+    volatile uint64_t   generation; // Zero until something is published
+} NoodleSharedControl_t;
+
+typedef struct NoodleSharedImage_t
+{
+    uint64_t    magic;
+    uint64_t    generation;
+    uint64_t    size; // Of the whole image, the tape follows this header
+    uint64_t    reserved;
+} NoodleSharedImage_t;
+
+struct NoodlePublisher_t
+{
+    NoodleAllocator_t       allocator;
+    NoodleSharedControl_t*  pControl;
+    NoodleSharedImage_t*    pImage; // The last one published, kept mapped so it lives on
+    size_t                  imageSize;
+    char                    pName[NOODLE_SHARED_NAME_MAX];
+};
+
+struct NoodleSubscriber_t
+{
+    NoodleAllocator_t               allocator;
+    const NoodleSharedControl_t*    pControl;
+    const NoodleSharedImage_t*      pImage; // NULL until the first image is mapped
+    size_t                          imageSize;
+    char                            pName[NOODLE_SHARED_NAME_MAX];
+};
+
+typedef enum NoodleCompression_t
+{
+    NOODLE_COMPRESSION_NONE,
+    NOODLE_COMPRESSION_GZIP,
+    NOODLE_COMPRESSION_ZSTD,
+} NoodleCompression_t;
+
+typedef struct NoodleStreamBlock_t
+{
+    size_t  size;
+    char    pData[NOODLE_STREAM_BLOCK_SIZE];
+} NoodleStreamBlock_t;
+
+// A compressed file is decompressed on its own thread into a few blocks, 
+// which the lexer appends to its window as it runs out of content. The 
+// parser drops the start of the window between entries, so only the entry 
+// being parsed and the blocks in flight are held at once.
+typedef struct NoodleStream_t
+{
+    NoodleCompression_t compression;
+    const NoodleAllocator_t* pAllocator; // Of the parse, the window grows through it
+    FILE*               pFile; // Read from when not NULL, otherwise pMemory is
+    const char*         pMemory;
+    size_t              memorySize;
+    size_t              memoryRead;
+    char*               pWindow; // Always null-terminated at the lexer's length
+    size_t              windowCapacity;
+    size_t              discarded; // Bytes cut from the front of the window so far
+    NoodleMutex_t       lock;
+    NoodleCondition_t   produced; // Signaled when a block is filled or nothing more will be
+    NoodleCondition_t   consumed; // Signaled when a block is taken or the stream is cancelled
+    size_t              filled; // Blocks filled since the start
+    size_t              taken; // Blocks appended to the window since the start
+    NOODLE_BOOL         finished; // No more blocks will be filled
+    NOODLE_BOOL         failed;
+    NOODLE_BOOL         cancelled; // The parser is done, stop decompressing
+    NoodleStreamBlock_t pBlocks[NOODLE_STREAM_BLOCKS];
+} NoodleStream_t;
+
+#ifdef NOODLE_IO_URING
+// The parts of an io_uring instance that are mapped from the kernel
+typedef struct NoodleRing_t
+{
+    int                     file;
+    unsigned                entries;
+    unsigned*               pSqHead;
+    unsigned*               pSqTail;
+    unsigned*               pSqMask;
+    unsigned*               pSqArray;
+    struct io_uring_sqe*    pSqes;
+    unsigned*               pCqHead;
+    unsigned*               pCqTail;
+    unsigned*               pCqMask;
+    struct io_uring_cqe*    pCqes;
+} NoodleRing_t;
+#endif
+
+// Where noodleFlatten is copying to
+typedef struct NoodleCopy_t
+{
+    NoodleRoot_t*   pRoot;
+    NoodleGroup_t*  pTarget;
+} NoodleCopy_t;
+
 typedef struct NoodleElement_t
 {
     union
@@ -65,7 +657,7 @@ typedef struct NoodleArray_t
 {
     Noodle_t        base;
     NoodleType_t    type;
-    int             count;
+    size_t          count;
     union
     {
         int*        pIntegers;
@@ -75,6 +667,37 @@ typedef struct NoodleArray_t
     };
 } NoodleArray_t;
 
+typedef enum NoodleTapeTag_t
+{
+    NOODLE_TAPE_TAG_GROUP_OPEN = '{',
+    NOODLE_TAPE_TAG_GROUP_CLOSE = '}',
+    NOODLE_TAPE_TAG_ARRAY_OPEN = '[',
+    NOODLE_TAPE_TAG_ARRAY_CLOSE = ']',
+    NOODLE_TAPE_TAG_KEY = 'k',
+    NOODLE_TAPE_TAG_INTEGER = 'i',
+    NOODLE_TAPE_TAG_FLOAT = 'f',
+    NOODLE_TAPE_TAG_BOOLEAN = 'b',
+    NOODLE_TAPE_TAG_STRING = 's',
+} NoodleTapeTag_t;
+
+// Every word holds a tag in its top byte and a payload below it. Opening 
+// words hold the index just past their matching close, closing words hold
+// the number of keys or elements. Keys hold 16 bits of their hash above a 
+// 40 bit offset into pStrings, strings hold just the offset. The header and 
+// words share one allocation, the strings are the other. A published tape 
+// is a single block instead, its strings follow the words.
+typedef struct NoodleTape_t
+{
+    NoodleAllocator_t   allocator;
+    size_t              count;
+    size_t              capacity;
+    char*               pStrings; // Null-terminated strings back to back
+    size_t              stringsSize;
+    size_t              stringsCapacity;
+    size_t              stringsOffset; // From the tape to its strings when they follow the words, otherwise zero
+    uint64_t            pWords[];
+} NoodleTape_t;
+
 typedef enum NoodleTokenKind_t
 {
     NOODLE_TOKEN_KIND_UNEXPECTED,
@@ -97,18 +720,33 @@ typedef enum NoodleTokenKind_t
 typedef struct NoodleToken_t
 {
     NoodleTokenKind_t kind;
-    int start;
-    int end;
+    size_t start; // Byte offsets into the content
+    size_t end;
+    NOODLE_BOOL escaped; // Strings holding escapes have to be decoded
 } NoodleToken_t;
 
 typedef struct NoodleLexer_t
 {
     const char* pContent;
-    int current;
-    int line;
-    int character;
+    size_t current;
+    size_t line;
+    size_t character;
+    size_t length; // Anything past this reads as a null-terminator
+    struct NoodleStream_t* pStream; // Appends more content once length is reached, see noodleLexerRefill
 } NoodleLexer_t;
 
+// Every included file of the process, newest first
+static NoodleMutex_t gNoodleIncludeLock = NOODLE_MUTEX_INITIALIZER;
+static NoodleInclude_t* gpNoodleIncludes = NULL;
+
+static NoodleLoader_t gNoodleLoader = {NOODLE_MUTEX_INITIALIZER, NOODLE_CONDITION_INITIALIZER, NOODLE_CONDITION_INITIALIZER, NULL, NULL, 0, NOODLE_FALSE};
+
+static NoodleReclaimer_t gNoodleReclaimer = {NOODLE_MUTEX_INITIALIZER, NOODLE_CONDITION_INITIALIZER, NOODLE_CONDITION_INITIALIZER, NULL, 0, NOODLE_FALSE};
+
+#ifdef NOODLE_IO_URING
+static NoodleRing_t gNoodleRing;
+#endif
+
 
 
 
@@ -118,44 +756,200 @@ typedef struct NoodleLexer_t
 
 
 
-char*           noodleStringDuplicate(const char* str);
+void*           noodleDefaultAlloc(void* pUser, size_t size);
+void*           noodleDefaultRealloc(void* pUser, void* pMemory, size_t size);
+void            noodleDefaultFree(void* pUser, void* pMemory);
+void*           noodleAlloc(const NoodleAllocator_t* pAllocator, size_t size);
+void*           noodleRealloc(const NoodleAllocator_t* pAllocator, void* pMemory, size_t size);
+void            noodleDealloc(const NoodleAllocator_t* pAllocator, void* pMemory);
+
+char*           noodleStringDuplicate(const NoodleAllocator_t* pAllocator, const char* str);
+double          noodleTimeNow(void);
 const char*     noodleStringFromTokenKind(NoodleTokenKind_t kind);
 
-NoodleToken_t   noodleToken(NoodleTokenKind_t kind, int start, int end);
+NoodleToken_t   noodleToken(NoodleTokenKind_t kind, size_t start, size_t end);
+int             noodleTokenPrintLength(const NoodleToken_t* pToken);
 
 char            noodleLexerGet(NoodleLexer_t* pLexer);
-char            noodleLexerPeek(const NoodleLexer_t* pLexer);
+char            noodleLexerPeek(NoodleLexer_t* pLexer);
+char            noodleLexerRefill(NoodleLexer_t* pLexer);
 void            noodleLexerSkipComment(NoodleLexer_t* pLexer);
 void            noodleLexerSkipSpaces(NoodleLexer_t* pLexer);
 void            noodleLexerAtom(NoodleLexer_t* pLexer, NoodleTokenKind_t kind, NoodleToken_t* pToken);
 void            noodleLexerIdentifierOrBool(NoodleLexer_t* pLexer, NoodleToken_t* pToken);
 void            noodleLexerNumber(NoodleLexer_t* pLexer, NoodleToken_t* pToken);
 void            noodleLexerString(NoodleLexer_t* pLexer, NoodleToken_t* pToken);
+NOODLE_BOOL     noodleLexerEscape(NoodleLexer_t* pLexer);
+NOODLE_BOOL     noodleLexerHex(NoodleLexer_t* pLexer, uint32_t* pUnit);
+NOODLE_BOOL     noodleLexerUtf8(NoodleLexer_t* pLexer);
+size_t          noodleStringRun(const char* pString, size_t length);
+size_t          noodleContentLength(const char* pContent, size_t length);
+size_t          noodleStringDecode(const char* pSource, size_t length, char* pDecoded);
+size_t          noodleUtf8Encode(uint32_t codepoint, char* pBytes);
+unsigned        noodleLowestBit(uint64_t mask);
 
 NOODLE_BOOL     noodleLexerIsIdentifier(char);
 NOODLE_BOOL     noodleLexerIsNumber(char);
 NOODLE_BOOL     noodleLexerIsSpace(char);
 
-NoodleLexer_t   noodleLexer(const char* pContent);
+NoodleLexer_t   noodleLexer(const char* pContent, size_t length);
 NOODLE_BOOL     noodleLexerNextToken(NoodleLexer_t* pLexer, NoodleToken_t* pToken);
+NOODLE_BOOL     noodleParseNextToken(NoodleLexer_t* pLexer, NoodleToken_t* pToken, NoodleParseStats_t* pStats);
 
 int             noodleParseInt(const NoodleLexer_t* pLexer, const NoodleToken_t* pToken);
 float           noodleParseFloat(const NoodleLexer_t* pLexer, const NoodleToken_t* pToken);
+void            noodleTokenCopy(const NoodleLexer_t* pLexer, const NoodleToken_t* pToken, char* pNumber);
 NOODLE_BOOL     noodleParseBool(const NoodleLexer_t* pLexer, const NoodleToken_t* pToken);
-char*           noodleParseString(const NoodleLexer_t* pLexer, const NoodleToken_t* pToken);
-
-NoodleGroup_t*  noodleGroup(char* pName, NoodleGroup_t* pParent);
-NoodleArray_t*  noodleArray(char* pName, NoodleType_t type, NoodleGroup_t* pParent);
-NoodleValue_t*  noodleValue(char* pName, NoodleType_t type, NoodleGroup_t* pParent);
-NoodleValue_t*  noodleInt(char* pName, int value, NoodleGroup_t* pParent);
-NoodleValue_t*  noodleFloat(char* pName, float value, NoodleGroup_t* pParent);
-NoodleValue_t*  noodleBool(char* pName, NOODLE_BOOL value, NoodleGroup_t* pParent);
-NoodleValue_t*  noodleString(char* pName, char* value, NoodleGroup_t* pParent);
+char*           noodleParseString(const NoodleAllocator_t* pAllocator, const NoodleLexer_t* pLexer, const NoodleToken_t* pToken);
+Noodle_t*       noodleParseValue(const NoodleAllocator_t* pAllocator, NoodleLexer_t* pLexer, NoodleToken_t* pToken, NoodleParseStats_t* pStats, char* pIdentifier, NoodleGroup_t* pParent, const char** ppErrorExpected);
+
+NoodleRoot_t*   noodleRoot(const NoodleAllocator_t* pAllocator, NoodleStringTable_t* pStrings);
+NoodleGroup_t*  noodleGroup(const NoodleAllocator_t* pAllocator, char* pName, NoodleGroup_t* pParent);
+NoodleArray_t*  noodleArray(const NoodleAllocator_t* pAllocator, char* pName, NoodleType_t type, NoodleGroup_t* pParent);
+NoodleValue_t*  noodleValue(const NoodleAllocator_t* pAllocator, char* pName, NoodleType_t type, NoodleGroup_t* pParent);
+NoodleValue_t*  noodleInt(const NoodleAllocator_t* pAllocator, char* pName, int value, NoodleGroup_t* pParent);
+NoodleValue_t*  noodleFloat(const NoodleAllocator_t* pAllocator, char* pName, float value, NoodleGroup_t* pParent);
+NoodleValue_t*  noodleBool(const NoodleAllocator_t* pAllocator, char* pName, NOODLE_BOOL value, NoodleGroup_t* pParent);
+NoodleValue_t*  noodleString(const NoodleAllocator_t* pAllocator, char* pName, char* value, NoodleGroup_t* pParent);
 
 size_t          noodleGroupHashFunction(const char* pName);
-NOODLE_BOOL     noodleGroupInsert(NoodleGroup_t* pGroup, const char* pName, Noodle_t* pNoodle);
-
-void            noodleFree(Noodle_t* pNoodle);
+size_t          noodleHashBytes(const char* pBytes, size_t length);
+
+NoodleString_t* noodleStringHeader(const char* pName);
+char*           noodleStringTableFind(const NoodleStringTable_t* pStrings, const char* pStr, size_t length, size_t hash);
+char*           noodleStringTableIntern(NoodleStringTable_t* pStrings, const char* pStr, size_t length);
+NOODLE_BOOL     noodleStringTableGrow(NoodleStringTable_t* pStrings);
+void            noodleStringTableRelease(NoodleStringTable_t* pStrings);
+NoodleValue_t*  noodleGroupInsert(const NoodleAllocator_t* pAllocator, NoodleGroup_t* pGroup, char* pName, NoodleType_t type);
+NOODLE_BOOL     noodleGroupIndexGrow(const NoodleAllocator_t* pAllocator, NoodleGroup_t* pGroup);
+void            noodleGroupShrink(const NoodleAllocator_t* pAllocator, NoodleGroup_t* pGroup);
+NOODLE_BOOL     noodleGroupReserve(const NoodleAllocator_t* pAllocator, NoodleGroup_t* pGroup, uint32_t capacity);
+NoodleValue_t*  noodleGroupFind(const NoodleGroup_t* pGroup, size_t hash, const char* pName, NOODLE_BOOL interned);
+Noodle_t*       noodleEntryNoodle(NoodleValue_t* pEntry);
+
+uint64_t        noodleHashMix(uint64_t hash);
+size_t          noodleFrozenSlot(const NoodleFrozen_t* pFrozen, size_t hash);
+NOODLE_BOOL     noodleGroupFreeze(const NoodleAllocator_t* pAllocator, NoodleGroup_t* pGroup);
+NoodleFrozen_t* noodleFrozenBuild(const NoodleAllocator_t* pAllocator, const NoodleValue_t* pEntries, size_t count, size_t bucketCount);
+
+uint64_t        noodleTapeWord(NoodleTapeTag_t tag, uint64_t payload);
+NoodleTapeTag_t noodleTapeTag(uint64_t word);
+uint64_t        noodleTapePayload(uint64_t word);
+NOODLE_BOOL     noodleTapePush(NoodleTape_t** ppTape, uint64_t word);
+NOODLE_BOOL     noodleTapePushString(NoodleTape_t* pTape, const char* pStr, size_t length, NOODLE_BOOL escaped, uint64_t* pOffset);
+NOODLE_BOOL     noodleTapePushValue(NoodleTape_t** ppTape, const NoodleLexer_t* pLexer, const NoodleToken_t* pToken);
+
+void            noodleMutexInit(NoodleMutex_t* pMutex);
+void            noodleMutexDestroy(NoodleMutex_t* pMutex);
+void            noodleMutexLock(NoodleMutex_t* pMutex);
+void            noodleMutexUnlock(NoodleMutex_t* pMutex);
+void            noodleConditionInit(NoodleCondition_t* pCondition);
+void            noodleConditionDestroy(NoodleCondition_t* pCondition);
+void            noodleConditionWait(NoodleCondition_t* pCondition, NoodleMutex_t* pMutex);
+void            noodleConditionSignal(NoodleCondition_t* pCondition);
+void            noodleConditionBroadcast(NoodleCondition_t* pCondition);
+NOODLE_BOOL     noodleThreadStart(NoodleThreadFunction_t function, void* pUser, NoodleThread_t* pThread);
+void            noodleThreadJoin(NoodleThread_t thread);
+NOODLE_BOOL     noodleLazyScan(NoodleRoot_t* pRoot, size_t* pStray);
+NOODLE_BOOL     noodleLazyParse(NoodleRoot_t* pRoot, NoodleGroup_t* pGroup, size_t start, size_t firstChild, char* pErrorBuffer, size_t bufferSize);
+NOODLE_BOOL     noodleGroupReady(const NoodleGroup_t* pGroup);
+void            noodleGroupClear(const NoodleAllocator_t* pAllocator, NoodleGroup_t* pGroup);
+Noodle_t*       noodleGroupRelease(const NoodleAllocator_t* pAllocator, NoodleGroup_t* pGroup, Noodle_t* pPending);
+
+NoodleRoot_t*   noodleRootOf(const Noodle_t* pNoodle);
+Noodle_t*       noodleOverlayFrom(const NoodleOverlay_t* pOverlay, const char* pName);
+NoodleOverlay_t* noodleOverlayFind(const NoodleOverlayTable_t* pTable, size_t hash, const char* pName);
+NOODLE_BOOL     noodleOverlayInsert(const NoodleAllocator_t* pAllocator, NoodleOverlay_t* pOverlay, NoodleOverlay_t* pChild, size_t hash);
+void            noodleOverlayFree(NoodleOverlay_t* pOverlay);
+NOODLE_BOOL     noodleVisit(const NoodleGroup_t* pGroup, NoodleVisitFunction_t visit, void* pUser);
+NOODLE_BOOL     noodleVisitLayer(void* pUser, Noodle_t* pNoodle);
+NOODLE_BOOL     noodleVisitForeach(void* pUser, Noodle_t* pNoodle);
+NOODLE_BOOL     noodleVisitCount(void* pUser, Noodle_t* pNoodle);
+NOODLE_BOOL     noodleVisitCopy(void* pUser, Noodle_t* pNoodle);
+NOODLE_BOOL     noodleVisitFingerprint(void* pUser, Noodle_t* pNoodle);
+uint64_t        noodleGroupFingerprint(const NoodleGroup_t* pGroup);
+uint64_t        noodleArrayFingerprint(const NoodleArray_t* pArray);
+uint64_t        noodleElementFingerprint(NoodleType_t type, const void* pValue);
+NOODLE_BOOL     noodleDiffGroups(NoodleDiff_t* pDiff, const NoodleGroup_t* pOld, const NoodleGroup_t* pNew);
+NOODLE_BOOL     noodleDiffPush(NoodleDiff_t* pDiff, const char* pName);
+NOODLE_BOOL     noodleVisitDiff(void* pUser, Noodle_t* pNoodle);
+NOODLE_BOOL     noodleEqual(const Noodle_t* pA, const Noodle_t* pB);
+void            noodleWriterPut(NoodleWriter_t* pWriter, const char* pData, size_t size);
+void            noodleWriterFlush(NoodleWriter_t* pWriter);
+void            noodleWriterIndent(NoodleWriter_t* pWriter, size_t depth);
+void            noodleJsonPutNumber(NoodleWriter_t* pWriter, const char* pNumber, size_t length);
+void            noodleJsonPutString(NoodleWriter_t* pWriter, const char* pString, size_t length);
+char            noodleJsonPeek(const char* pContent, size_t length, size_t position);
+size_t          noodleJsonSkipSpaces(const char* pContent, size_t length, size_t position);
+NOODLE_BOOL     noodleJsonValue(NoodleWriter_t* pWriter, const char* pContent, size_t length, size_t* pPosition, NOODLE_BOOL asFloat, NoodleType_t* pType, const char** ppErrorExpected);
+NOODLE_BOOL     noodleJsonNumber(NoodleWriter_t* pWriter, const char* pContent, size_t length, size_t* pPosition, NOODLE_BOOL asFloat, const char** ppErrorExpected);
+NOODLE_BOOL     noodleJsonString(NoodleWriter_t* pWriter, const char* pContent, size_t length, size_t* pPosition, const char** ppErrorExpected);
+NOODLE_BOOL     noodleJsonHex(const char* pContent, size_t length, size_t position, uint32_t* pUnit);
+void            noodleJsonPutCodepoint(NoodleWriter_t* pWriter, uint32_t codepoint);
+size_t          noodleGetManyTyped(const NoodleGroup_t* pGroup, const char* const* ppNames, size_t count, NoodleType_t type, void* pValues, size_t valueSize, NOODLE_BOOL* pSucceeded);
+void            noodleQueryMatch(NoodleQueryRun_t* pRun, const NoodleGroup_t* pGroup, size_t step);
+NOODLE_BOOL     noodleQueryVisit(NoodleQueryRun_t* pRun, const NoodleGroup_t* pGroup, size_t step);
+void            noodleQueryMatched(NoodleQueryRun_t* pRun, Noodle_t* pNoodle, size_t step);
+NOODLE_BOOL     noodleVisitQueryAny(void* pUser, Noodle_t* pNoodle);
+NOODLE_BOOL     noodleVisitQueryDescendants(void* pUser, Noodle_t* pNoodle);
+NOODLE_BOOL     noodleArrayCopy(const NoodleAllocator_t* pAllocator, const NoodleArray_t* pArray, char* pName, NoodleGroup_t* pParent);
+
+void            noodleFree(const NoodleAllocator_t* pAllocator, Noodle_t* pNoodle);
+void            noodleFreePending(const NoodleAllocator_t* pAllocator, Noodle_t* pPending);
+size_t          noodlePoolClass(size_t size);
+void*           noodlePoolAlloc(void* pUser, size_t size);
+void*           noodlePoolRealloc(void* pUser, void* pMemory, size_t size);
+void            noodlePoolFree(void* pUser, void* pMemory);
+void            noodleContextReserve(NoodleContext_t* pContext, NoodleGroup_t* pGroup, size_t order);
+NOODLE_BOOL     noodleContextRecord(NoodleContext_t* pContext, const NoodleGroup_t* pGroup);
+size_t          noodleSkipRecordSpaces(const char* pContent, size_t length, size_t position, NoodleRecordCursor_t* pCursor);
+size_t          noodleSkipRecordString(const char* pContent, size_t length, size_t position, NoodleRecordCursor_t* pCursor);
+NOODLE_BOOL     noodleRecordNext(const char* pContent, size_t length, NoodleRecordCursor_t* pCursor, NoodleLexer_t* pRecord);
+NoodleThreadResult_t NOODLE_THREAD_CALL noodleRecordWorker(void* pUser);
+size_t          noodleProcessorCount(void);
+void            noodleMeasure(const Noodle_t* pNoodle, size_t depth, NoodleParseStats_t* pStats);
+
+NoodleGroup_t*  noodleParseDocument(const char* pContent, NoodleStream_t* pStream, const NoodleLexer_t* pSpan, NoodleContext_t* pContext, const NoodleAllocator_t* pAllocator, NoodleStringTable_t* pStrings, NoodleParseStats_t* pStats, const NoodleIncludeFrame_t* pFrame, char* pErrorBuffer, size_t bufferSize);
+NoodleGroup_t*  noodleParseFile(const char* pPath, const NoodleAllocator_t* pAllocator, NoodleStringTable_t* pStrings, NoodleParseStats_t* pStats, const NoodleIncludeFrame_t* pIncluder, char* pErrorBuffer, size_t bufferSize);
+NOODLE_BOOL     noodleParseIncludeDirective(NoodleLexer_t* pLexer, NoodleToken_t* pToken);
+NOODLE_BOOL     noodlePathCanonical(const char* pPath, char* pCanonical);
+NOODLE_BOOL     noodleInclude(NoodleRoot_t* pRoot, NoodleGroup_t* pGroup, const NoodleLexer_t* pLexer, const NoodleToken_t* pToken, const NoodleIncludeFrame_t* pFrame, char* pErrorBuffer, size_t bufferSize);
+NoodleInclude_t* noodleIncludeLoad(const char* pPath, const NoodleIncludeFrame_t* pIncluder, char* pErrorBuffer, size_t bufferSize);
+void            noodleIncludeRelease(NoodleInclude_t* pInclude);
+NoodleGroup_t*  noodleParseFileContent(const char* pPath, const char* pContent, NoodleStream_t* pStream, const NoodleAllocator_t* pAllocator, NoodleStringTable_t* pStrings, NoodleParseStats_t* pStats, const NoodleIncludeFrame_t* pIncluder, char* pErrorBuffer, size_t bufferSize);
+NoodleCompression_t noodleCompressionOf(const char* pMagic, size_t size);
+NoodleGroup_t*  noodleParseCompressed(const char* pPath, NoodleCompression_t compression, FILE* pFile, const char* pMemory, size_t memorySize, const NoodleAllocator_t* pAllocator, NoodleStringTable_t* pStrings, NoodleParseStats_t* pStats, const NoodleIncludeFrame_t* pIncluder, char* pErrorBuffer, size_t bufferSize);
+void            noodleStreamCompact(NoodleLexer_t* pLexer, NoodleToken_t* pToken);
+size_t          noodleStreamRead(NoodleStream_t* pStream, void* pData, size_t size);
+NoodleStreamBlock_t* noodleStreamAcquire(NoodleStream_t* pStream);
+void            noodleStreamPublish(NoodleStream_t* pStream);
+NoodleThreadResult_t NOODLE_THREAD_CALL noodleStreamDecompress(void* pUser);
+#ifdef NOODLE_ZLIB
+NOODLE_BOOL     noodleStreamInflate(NoodleStream_t* pStream);
+#endif
+#ifdef NOODLE_ZSTD
+NOODLE_BOOL     noodleStreamZstd(NoodleStream_t* pStream);
+#endif
+NOODLE_BOOL     noodleLoaderStart(void);
+NoodleLoad_t*   noodleLoaderTake(size_t limit);
+void            noodleLoadFinish(NoodleLoad_t* pLoad, NoodleGroup_t* pGroup, const char* pError);
+NoodleThreadResult_t NOODLE_THREAD_CALL noodleLoaderPool(void* pUser);
+#ifdef NOODLE_IO_URING
+NOODLE_BOOL     noodleRingInit(NoodleRing_t* pRing);
+void            noodleRingRead(NoodleRing_t* pRing, NoodleLoad_t* pLoad);
+int             noodleRingEnter(NoodleRing_t* pRing, unsigned submit, unsigned wait);
+NoodleThreadResult_t NOODLE_THREAD_CALL noodleLoaderRing(void* pUser);
+#endif
+NOODLE_BOOL     noodleOwns(const NoodleGroup_t* pGroup, const NoodleValue_t* pEntry);
+void            noodleGroupInclude(NoodleGroup_t* pGroup);
+NoodleThreadResult_t NOODLE_THREAD_CALL noodleReclaimer(void* pUser);
+const char*     noodleTapeStrings(const NoodleTape_t* pTape);
+NOODLE_BOOL     noodleSharedName(char* pName, const char* pBase, uint64_t generation);
+void*           noodleSharedCreate(const char* pName, size_t size);
+const void*     noodleSharedOpen(const char* pName, size_t* pSize);
+void            noodleSharedUnmap(const void* pMemory, size_t size);
+void            noodleSharedRemove(const char* pName);
+NOODLE_BOOL     noodleSubscriberMap(NoodleSubscriber_t* pSubscriber, uint64_t generation);
 
 
 
@@ -165,299 +959,412 @@ void            noodleFree(Noodle_t* pNoodle);
 
 
 
-NoodleGroup_t* noodleParse(const char* pContent, char* pErrorBuffer, size_t bufferSize)
+NoodleGroup_t* noodleParse(const char* pContent, const NoodleAllocator_t* pAllocator, NoodleStringTable_t* pStrings, NoodleParseStats_t* pStats, char* pErrorBuffer, size_t bufferSize)
 {
-    if (!pContent) goto cleanupArgument;
+    return noodleParseDocument(pContent, NULL, NULL, NULL, pAllocator, pStrings, pStats, NULL, pErrorBuffer, bufferSize);
+}
 
-    if (pErrorBuffer && bufferSize > 1 )
-    {
-        memset(pErrorBuffer, '\0', bufferSize);
-        bufferSize--; // Allow for at least one null-terminator
-    }
-    else
-    {
-        // If the user doesn't want to receive errors, do nothing
-        pErrorBuffer = NULL;
-        bufferSize = 0;
-    }
+NoodleGroup_t* noodleParseFromFile(const char* pPath, const NoodleAllocator_t* pAllocator, NoodleStringTable_t* pStrings, NoodleParseStats_t* pStats, char* pErrorBuffer, size_t bufferSize)
+{
+    return noodleParseFile(pPath, pAllocator, pStrings, pStats, NULL, pErrorBuffer, bufferSize);
+}
 
-    // Create the root group to contain the other noodles
-    NoodleGroup_t* pRoot = noodleGroup(NULL, NULL);
-    if (!pRoot) goto cleanupMemory;
-    
-    // Create the lexer and begin parsing
-    NoodleLexer_t lexer = noodleLexer(pContent);
-    NoodleToken_t token = {0};
+NOODLE_BOOL noodleParseFromFileAsync(const char* pPath, NoodleParseCallback_t callback, void* pUser)
+{
+    if (!pPath || !callback) return NOODLE_FALSE;
 
-    noodleLexerNextToken(&lexer, &token);
+    size_t length = strlen(pPath);
 
-    const char* pErrorExpected = ""; // On failure use this value is set to hint what the error is
-    NoodleGroup_t* pCurrent = pRoot; // Used to parent noodles
+    NoodleLoad_t* pLoad = NOODLE_MALLOC(sizeof(NoodleLoad_t) + length + 1);
+    if (!pLoad) return NOODLE_FALSE;
 
-    while (token.kind != NOODLE_TOKEN_KIND_END)
-    {
-        
-        if (token.kind != NOODLE_TOKEN_KIND_IDENTIFIER)
-        {
-            pErrorExpected = "Identifier";
-            goto cleanupParse;
-        }
+    memset(pLoad, 0, sizeof(NoodleLoad_t));
+    memcpy(pLoad->pPath, pPath, length + 1);
+    pLoad->callback = callback;
+    pLoad->pUser = pUser;
+    pLoad->file = -1;
 
-        char* pIdentifier = noodleParseString(&lexer, &token);
+    noodleMutexLock(&gNoodleLoader.lock);
 
-        // Get the equals token
-        noodleLexerNextToken(&lexer, &token);
+    if (!gNoodleLoader.started && !noodleLoaderStart())
+    {
+        noodleMutexUnlock(&gNoodleLoader.lock);
+        NOODLE_FREE(pLoad);
+        return NOODLE_FALSE;
+    }
 
-        if (token.kind != NOODLE_TOKEN_KIND_EQUAL)
-        {
-            pErrorExpected = "Equals Symbol";
-            goto cleanupParse;
-        }
+    if (gNoodleLoader.pLast) gNoodleLoader.pLast->pNext = pLoad;
+    else gNoodleLoader.pFirst = pLoad;
 
-        // This next token will determine the type of noodle to create
-        noodleLexerNextToken(&lexer, &token);
+    gNoodleLoader.pLast = pLoad;
+    gNoodleLoader.pending++;
 
-        Noodle_t* pNewNoodle = NULL;
+    noodleConditionSignal(&gNoodleLoader.wake);
+    noodleMutexUnlock(&gNoodleLoader.lock);
 
-        switch (token.kind)
-        {
-            case NOODLE_TOKEN_KIND_LEFTCURLY:
-                pNewNoodle = (Noodle_t*)noodleGroup(pIdentifier, pCurrent);
-                break;
-            case NOODLE_TOKEN_KIND_INTEGER:
-                pNewNoodle = (Noodle_t*)noodleInt(pIdentifier, noodleParseInt(&lexer, &token), pCurrent);
-                break;
-            case NOODLE_TOKEN_KIND_FLOAT:
-                pNewNoodle = (Noodle_t*)noodleFloat(pIdentifier, noodleParseFloat(&lexer, &token), pCurrent);
-                break;
-            case NOODLE_TOKEN_KIND_BOOLEAN:
-                pNewNoodle = (Noodle_t*)noodleBool(pIdentifier, noodleParseBool(&lexer, &token), pCurrent);
-                break;
-            case NOODLE_TOKEN_KIND_STRING:
-            {
-                char* pString = noodleParseString(&lexer, &token);
-                if (!pString) goto cleanupMemory;
+    return NOODLE_TRUE;
+}
 
-                pNewNoodle = (Noodle_t*)noodleString(pIdentifier, pString, pCurrent);
-                break;
-            }
-            case NOODLE_TOKEN_KIND_LEFTBRACKET:
-            {
-                int arrayStart = token.start;
+void noodleParseAsyncWait(void)
+{
+    noodleMutexLock(&gNoodleLoader.lock);
 
-                // Get the next token to get it's type and ensure it can be in an array 
-                noodleLexerNextToken(&lexer, &token);
+    while (gNoodleLoader.pending > 0)
+        noodleConditionWait(&gNoodleLoader.idle, &gNoodleLoader.lock);
 
-                if (token.kind != NOODLE_TOKEN_KIND_INTEGER && 
-                    token.kind != NOODLE_TOKEN_KIND_FLOAT &&
-                    token.kind != NOODLE_TOKEN_KIND_BOOLEAN &&
-                    token.kind != NOODLE_TOKEN_KIND_STRING)
-                {
-                    pErrorExpected = "Integer, Float, Boolean, or String";
-                    goto cleanupParse;
-                }
+    noodleMutexUnlock(&gNoodleLoader.lock);
+}
 
-                // Get the next few tokens until the end of the array
-                NoodleTokenKind_t expected = token.kind;
-                
-                NoodleArray_t* pArray = noodleArray(pIdentifier, NOODLE_TYPE_ARRAY, pCurrent);
-                if (!pArray) goto cleanupMemory;
+NoodleContext_t* noodleContextCreate(const NoodleAllocator_t* pAllocator)
+{
+    NoodleAllocator_t allocator = {noodleDefaultAlloc, noodleDefaultRealloc, noodleDefaultFree, NULL};
+    if (pAllocator) allocator = *pAllocator;
 
-                // Loop through all the tokens of the array to get the count and verification of type
-                while (token.kind != NOODLE_TOKEN_KIND_RIGHTBRACKET)
-                {
-                    // Make sure that the token is the one we expect in the array
-                    if (token.kind != expected)
-                    {
-                        pErrorExpected = noodleStringFromTokenKind(expected);
-                        goto cleanupParse;
-                    }
+    NoodleContext_t* pContext = noodleAlloc(&allocator, sizeof(NoodleContext_t));
+    if (!pContext) return NULL;
 
-                    pArray->count++;
+    memset(pContext, 0, sizeof(NoodleContext_t));
+    pContext->allocator = allocator;
+    pContext->pool = (NoodleAllocator_t){noodlePoolAlloc, noodlePoolRealloc, noodlePoolFree, pContext};
 
-                    // Expect a ',' or a ']'
-                    noodleLexerNextToken(&lexer, &token);
+    pContext->pStrings = noodleStringTableCreate(&allocator);
+    if (!pContext->pStrings)
+    {
+        noodleDealloc(&allocator, pContext);
+        return NULL;
+    }
 
-                    if (token.kind == NOODLE_TOKEN_KIND_COMMA)
-                    {
-                        noodleLexerNextToken(&lexer, &token);
-                        continue;
-                    }
-                }
+    return pContext;
+}
 
-                // Kinda hacky but reset the lexer back to the array start position
-                lexer.current = arrayStart;
+void noodleContextDestroy(NoodleContext_t* pContext)
+{
+    if (!pContext) return;
 
-                // Allocate the array of values
-                switch (expected)
-                {
-                    case NOODLE_TOKEN_KIND_INTEGER:
-                        pArray->type = NOODLE_TYPE_INTEGER;
-                        pArray->pIntegers = NOODLE_MALLOC(sizeof(int) * pArray->count);
-                        break;
+    assert(!pContext->liveBlocks && "Documents parsed with a context must be cleaned up before it's destroyed!");
 
-                    case NOODLE_TOKEN_KIND_FLOAT:
-                        pArray->type = NOODLE_TYPE_FLOAT;
-                        pArray->pFloats = NOODLE_MALLOC(sizeof(float) * pArray->count);
-                        break;
+    for (size_t c = 0; c < NOODLE_POOL_CLASSES; c++)
+    {
+        NoodlePoolBlock_t* pBlock = pContext->ppFree[c];
 
-                    case NOODLE_TOKEN_KIND_BOOLEAN:
-                        pArray->type = NOODLE_TYPE_BOOLEAN;
-                        pArray->pBooleans = NOODLE_MALLOC(sizeof(NOODLE_BOOL) * pArray->count);
-                        break;
+        while (pBlock)
+        {
+            NoodlePoolBlock_t* pNext = pBlock->pNext;
+            noodleDealloc(&pContext->allocator, pBlock);
+            pBlock = pNext;
+        }
+    }
 
-                    case NOODLE_TOKEN_KIND_STRING:
-                        pArray->type = NOODLE_TYPE_STRING;
-                        pArray->ppStrings = NOODLE_MALLOC(sizeof(char*) * pArray->count);
-                        break;
-                }
+    noodleStringTableRelease(pContext->pStrings);
+    noodleDealloc(&pContext->allocator, pContext->pHints);
 
-                // Check if the array was allocated correctly using ints value of the union 
-                if (!pArray->pIntegers) goto cleanupMemory;
+    // Copy the allocator out first, it's freed along with the context
+    NoodleAllocator_t allocator = pContext->allocator;
+    noodleDealloc(&allocator, pContext);
+}
 
-                // Iterate through the values once again, to set the array
-                noodleLexerNextToken(&lexer, &token);
+NoodleGroup_t* noodleParseWith(NoodleContext_t* pContext, const char* pContent, NoodleParseStats_t* pStats, char* pErrorBuffer, size_t bufferSize)
+{
+    assert(pContext);
+    return noodleParseDocument(pContent, NULL, NULL, pContext, &pContext->pool, pContext->pStrings, pStats, NULL, pErrorBuffer, bufferSize);
+}
 
-                int i = 0;
-                while (token.kind != NOODLE_TOKEN_KIND_RIGHTBRACKET)
-                {
-                    switch (expected)
-                    {
-                        case NOODLE_TOKEN_KIND_INTEGER:
-                            pArray->pIntegers[i] = noodleParseInt(&lexer, &token);
-                            break;
-                        case NOODLE_TOKEN_KIND_FLOAT:
-                            pArray->pFloats[i] = noodleParseFloat(&lexer, &token);
-                            break;
-                        case NOODLE_TOKEN_KIND_BOOLEAN:
-                            pArray->pBooleans[i] = noodleParseBool(&lexer, &token); 
-                            break;
-                        case NOODLE_TOKEN_KIND_STRING:
-                        {
-                            char* pString = noodleParseString(&lexer, &token);
-                            if (!pString) goto cleanupMemory;
+NoodleRecords_t* noodleRecordsOpen(const char* pContent, size_t length, const NoodleAllocator_t* pAllocator, NoodleStringTable_t* pStrings)
+{
+    NoodleAllocator_t allocator = {noodleDefaultAlloc, noodleDefaultRealloc, noodleDefaultFree, NULL};
+    if (pAllocator) allocator = *pAllocator;
 
-                            pArray->ppStrings[i] = pString;
-                            break;
-                        }
-                    }
+    NoodleRecords_t* pRecords = noodleAlloc(&allocator, sizeof(NoodleRecords_t));
+    if (!pRecords) return NULL;
 
-                    i++;
+    memset(pRecords, 0, sizeof(NoodleRecords_t));
+    pRecords->pContent = pContent;
+    pRecords->length = length;
+    pRecords->allocator = allocator;
 
-                    noodleLexerNextToken(&lexer, &token);
-                    
-                    if (token.kind == NOODLE_TOKEN_KIND_COMMA)
-                    {
-                        noodleLexerNextToken(&lexer, &token);
-                        continue;
-                    }
-                }
+    // Records use the given table or one of their own, either way every 
+    // record shares it so a key is only stored once
+    if (pStrings)
+    {
+        NOODLE_INCREMENT(&pStrings->references);
+        pRecords->pStrings = pStrings;
+    }
+    else
+    {
+        pRecords->pStrings = noodleStringTableCreate(&allocator);
 
-                pNewNoodle = (Noodle_t*)pArray;
-                break;
-            }
+        if (!pRecords->pStrings)
+        {
+            noodleDealloc(&allocator, pRecords);
+            return NULL;
         }
+    }
 
-        if (!pNewNoodle || 
-            !noodleGroupInsert(pCurrent, pIdentifier, pNewNoodle)) 
-            goto cleanupMemory;
+    return pRecords;
+}
 
-        if (pNewNoodle->type == NOODLE_TYPE_GROUP)
-        {
-            pCurrent = (NoodleGroup_t*)pNewNoodle;
-        }
+NOODLE_BOOL noodleRecordsNext(NoodleRecords_t* pRecords, NoodleGroup_t** ppRecord, char* pErrorBuffer, size_t bufferSize)
+{
+    assert(pRecords && ppRecord);
 
-        noodleLexerNextToken(&lexer, &token);
-        
-        if (token.kind == NOODLE_TOKEN_KIND_COMMA)
-        {
-            noodleLexerNextToken(&lexer, &token);
+    *ppRecord = NULL;
 
-            // Spare commas are not recommended, but are allowed after a value 
-            // even if it's the last one
-            if (token.kind == NOODLE_TOKEN_KIND_RIGHTCURLY)
-                goto parseEndGroups;
+    NoodleLexer_t record;
+    if (!noodleRecordNext(pRecords->pContent, pRecords->length, &pRecords->cursor, &record)) return NOODLE_FALSE;
 
-            continue;
-        }
+    *ppRecord = noodleParseDocument(pRecords->pContent, NULL, &record, NULL, &pRecords->allocator, pRecords->pStrings, NULL, NULL, pErrorBuffer, bufferSize);
+    return NOODLE_TRUE;
+}
 
-        
-    parseEndGroups:
+void noodleRecordsClose(NoodleRecords_t* pRecords)
+{
+    if (!pRecords) return;
 
-        while (token.kind == NOODLE_TOKEN_KIND_RIGHTCURLY)
-        {
-            Noodle_t* pTemp = (Noodle_t*)pCurrent;
+    // Records still alive keep the table
+    noodleStringTableRelease(pRecords->pStrings);
 
-            if (!pTemp->pParent)
-            {
-                pErrorExpected = "Identifier";
-                goto cleanupParse;
-            }
+    NoodleAllocator_t allocator = pRecords->allocator;
+    noodleDealloc(&allocator, pRecords);
+}
 
-            pCurrent = pTemp->pParent;
+NOODLE_BOOL noodleParseRecords(const char* pContent, size_t length, size_t threadCount, NoodleRecordCallback_t callback, void* pUser)
+{
+    assert(pContent && callback);
 
-            noodleLexerNextToken(&lexer, &token);
-        }
+    NoodleRecordJob_t job = {0};
+    job.pContent = pContent;
+    job.length = length;
+    job.callback = callback;
+    job.pUser = pUser;
+    noodleMutexInit(&job.lock);
 
-    }
+    if (threadCount == 0) threadCount = noodleProcessorCount();
 
-    return pRoot;
+    NoodleThread_t* pThreads = threadCount > 1 ? NOODLE_MALLOC(sizeof(NoodleThread_t) * (threadCount - 1)) : NULL;
+    size_t started = 0;
 
-cleanupArgument:
-    snprintf(pErrorBuffer, bufferSize, "Invalid argument!");
-    return NULL;
+    // The calling thread works too, so too few threads only slows it down
+    while (pThreads && started < threadCount - 1 && noodleThreadStart(noodleRecordWorker, &job, &pThreads[started]))
+        started++;
 
-cleanupMemory:
-    snprintf(pErrorBuffer, bufferSize, "Could not allocate memory!");
-    noodleFree((Noodle_t*)pRoot);
-    return NULL;
+    noodleRecordWorker(&job);
 
-cleanupParse:
-    snprintf(pErrorBuffer, bufferSize, "(Ln %i, Col %i) Unexpected token found, \"%.*s\", expected token, \"%s\"!", lexer.line, lexer.character, token.end - token.start, pContent, pErrorExpected);
-    noodleFree((Noodle_t*)pRoot);
-    return NULL;
+    for (size_t i = 0; i < started; i++)
+        noodleThreadJoin(pThreads[i]);
 
+    NOODLE_FREE(pThreads);
+    noodleMutexDestroy(&job.lock);
+
+    return !job.stopped;
 }
 
-NoodleGroup_t* noodleParseFromFile(const char* pPath, char* pErrorBuffer, size_t bufferSize)
+NoodleGroup_t* noodleParseLazy(const char* pContent, const NoodleAllocator_t* pAllocator, NoodleStringTable_t* pStrings, char* pErrorBuffer, size_t bufferSize)
 {
-    assert(pPath);
+    if (!pContent) goto cleanupArgument;
 
-    if (!pErrorBuffer || bufferSize < 1)
+    if (pErrorBuffer && bufferSize > 1 )
+    {
+        memset(pErrorBuffer, '\0', bufferSize);
+        bufferSize--; // Allow for at least one null-terminator
+    }
+    else
     {
         pErrorBuffer = NULL;
         bufferSize = 0;
     }
 
-    FILE* pFile = fopen(pPath, "rb");
-    if (!pFile) goto cleanupFile;
+    NoodleRoot_t* pRootState = noodleRoot(pAllocator, pStrings);
+    if (!pRootState) goto cleanupRoot;
 
-    // Get file size
-    fseek(pFile, 0, SEEK_END);
-    size_t size = ftell(pFile);
-    fseek(pFile, 0, SEEK_SET);
+    pRootState->pSource = pContent;
+    noodleMutexInit(&pRootState->lock);
 
-    // Allocate the file in memory
-    char* pContent = NOODLE_MALLOC(size);
-    if (!pContent) goto cleanupMemory;
+    // Only the curlies are matched up front, nothing inside them is parsed
+    size_t stray = 0;
+    if (!noodleLazyScan(pRootState, &stray))
+    {
+        if (stray == SIZE_MAX) goto cleanupMemory;
+        goto cleanupStray;
+    }
 
-    // Copy the file to memory
-    if (fread(pContent, 1, size, pFile) != size) goto cleanupRead;
+    // The root is always needed so its own entries are parsed right away
+    if (!noodleLazyParse(pRootState, &pRootState->group, 0, 0, pErrorBuffer, bufferSize)) goto cleanupParse;
 
-    return noodleParse(pContent, pErrorBuffer, bufferSize);
+    return &pRootState->group;
 
-cleanupFile:
-    snprintf(pErrorBuffer, bufferSize, "Could not open file!");
+cleanupArgument:
+    snprintf(pErrorBuffer, bufferSize, "Invalid argument!");
     return NULL;
 
-cleanupRead:
-    snprintf(pErrorBuffer, bufferSize, "Could not read file!");
+cleanupRoot:
+    snprintf(pErrorBuffer, bufferSize, "Could not allocate memory!");
     return NULL;
 
 cleanupMemory:
     snprintf(pErrorBuffer, bufferSize, "Could not allocate memory!");
+    noodleCleanup(&pRootState->group);
+    return NULL;
+
+cleanupStray:
+{
+    size_t line = 0;
+    size_t character = 0;
+
+    for (size_t i = 0; i <= stray; i++)
+    {
+        if (pContent[i] == '\n')
+        {
+            line++;
+            character = 0;
+        }
+        else
+        {
+            character++;
+        }
+    }
+
+    snprintf(pErrorBuffer, bufferSize, "(Ln %zu, Col %zu) Unexpected token found, \"}\", expected token, \"Identifier\"!", line, character);
+    noodleCleanup(&pRootState->group);
+    return NULL;
+}
+
+cleanupParse:
+    noodleCleanup(&pRootState->group);
     return NULL;
+}
+
+NOODLE_BOOL noodleValidate(const char* pContent, size_t length, char* pErrorBuffer, size_t bufferSize)
+{
+    if (!pContent) goto cleanupArgument;
+
+    if (pErrorBuffer && bufferSize > 1 )
+    {
+        memset(pErrorBuffer, '\0', bufferSize);
+        bufferSize--; // Allow for at least one null-terminator
+    }
+    else
+    {
+        pErrorBuffer = NULL;
+        bufferSize = 0;
+    }
+
+    // Follows the same grammar as noodleParse, but only the depth of the
+    // groups is kept so nothing is allocated
+    NoodleLexer_t lexer = noodleLexer(pContent, noodleContentLength(pContent, length));
+    NoodleToken_t token = {0};
+    const char* pErrorExpected = "";
+    size_t depth = 0;
+
+    noodleLexerNextToken(&lexer, &token);
+
+    while (token.kind != NOODLE_TOKEN_KIND_END)
+    {
+        if (token.kind != NOODLE_TOKEN_KIND_IDENTIFIER)
+        {
+            pErrorExpected = "Identifier";
+            goto cleanupParse;
+        }
+
+        // Only the syntax of an include is checked, the file isn't opened
+        if (!noodleParseIncludeDirective(&lexer, &token))
+        {
+            noodleLexerNextToken(&lexer, &token);
+
+            if (token.kind != NOODLE_TOKEN_KIND_EQUAL)
+            {
+                pErrorExpected = "Equals Symbol";
+                goto cleanupParse;
+            }
+
+            noodleLexerNextToken(&lexer, &token);
+
+            switch (token.kind)
+            {
+                case NOODLE_TOKEN_KIND_LEFTCURLY:
+                    depth++;
+                    break;
+                case NOODLE_TOKEN_KIND_INTEGER:
+                case NOODLE_TOKEN_KIND_FLOAT:
+                case NOODLE_TOKEN_KIND_BOOLEAN:
+                case NOODLE_TOKEN_KIND_STRING:
+                    break;
+                case NOODLE_TOKEN_KIND_LEFTBRACKET:
+                {
+                    noodleLexerNextToken(&lexer, &token);
+
+                    if (token.kind != NOODLE_TOKEN_KIND_INTEGER && 
+                        token.kind != NOODLE_TOKEN_KIND_FLOAT &&
+                        token.kind != NOODLE_TOKEN_KIND_BOOLEAN &&
+                        token.kind != NOODLE_TOKEN_KIND_STRING)
+                    {
+                        pErrorExpected = "Integer, Float, Boolean, or String";
+                        goto cleanupParse;
+                    }
+
+                    NoodleTokenKind_t expected = token.kind;
+
+                    while (token.kind != NOODLE_TOKEN_KIND_RIGHTBRACKET)
+                    {
+                        if (token.kind != expected)
+                        {
+                            pErrorExpected = noodleStringFromTokenKind(expected);
+                            goto cleanupParse;
+                        }
+
+                        noodleLexerNextToken(&lexer, &token);
+
+                        if (token.kind == NOODLE_TOKEN_KIND_COMMA)
+                            noodleLexerNextToken(&lexer, &token);
+                    }
+
+                    break;
+                }
+                default:
+                    pErrorExpected = "Value";
+                    goto cleanupParse;
+            }
+        }
 
+        noodleLexerNextToken(&lexer, &token);
+
+        if (token.kind == NOODLE_TOKEN_KIND_COMMA)
+        {
+            noodleLexerNextToken(&lexer, &token);
+
+            if (token.kind != NOODLE_TOKEN_KIND_RIGHTCURLY)
+                continue;
+        }
+
+        while (token.kind == NOODLE_TOKEN_KIND_RIGHTCURLY)
+        {
+            if (depth == 0)
+            {
+                pErrorExpected = "Identifier";
+                goto cleanupParse;
+            }
+
+            depth--;
+            noodleLexerNextToken(&lexer, &token);
+        }
+    }
+
+    // noodleParse closes groups left open at the end, but that's most likely 
+    // a mistake so it's reported here
+    if (depth > 0)
+    {
+        pErrorExpected = noodleStringFromTokenKind(NOODLE_TOKEN_KIND_RIGHTCURLY);
+        goto cleanupParse;
+    }
+
+    return NOODLE_TRUE;
+
+cleanupArgument:
+    snprintf(pErrorBuffer, bufferSize, "Invalid argument!");
+    return NOODLE_FALSE;
+
+cleanupParse:
+    snprintf(pErrorBuffer, bufferSize, "(Ln %zu, Col %zu) Unexpected token found, \"%.*s\", expected token, \"%s\"!", lexer.line, lexer.character, noodleTokenPrintLength(&token), pContent + token.start, pErrorExpected);
+    return NOODLE_FALSE;
 }
 
 Noodle_t* noodleFrom(const NoodleGroup_t* pGroup, const char* pName)
@@ -465,20 +1372,28 @@ Noodle_t* noodleFrom(const NoodleGroup_t* pGroup, const char* pName)
     assert(pGroup);
     assert(pName);
 
-    size_t index = noodleGroupHashFunction(pName) % NOODLE_GROUP_BUCKETS_COUNT;
+    if (pGroup->overlay) return noodleOverlayFrom((const NoodleOverlay_t*)pGroup, pName);
 
-    NoodleNode_t* pCurrent = pGroup->ppBuckets[index];
-    
-    while (pCurrent)
-    {
-        if (strcmp(pCurrent->pNoodle->pName, pName) == 0) break;
+    NoodleValue_t* pEntry = noodleGroupFind(pGroup, noodleGroupHashFunction(pName), pName, NOODLE_FALSE);
+    if (!pEntry) return NULL;
 
-        pCurrent = pCurrent->pNext;
-    }
+    return noodleEntryNoodle(pEntry);
+}
+
+Noodle_t* noodleFromInterned(const NoodleGroup_t* pGroup, const char* pKey)
+{
+    assert(pGroup);
+    assert(pKey);
 
-    if (!pCurrent) return NULL;
+    // The layers of an overlay have their own string tables
+    if (pGroup->overlay) return noodleOverlayFrom((const NoodleOverlay_t*)pGroup, pKey);
 
-    return pCurrent->pNoodle;
+    // The key must come from noodleIntern with this document's string table,
+    // groups borrowed from an included file compare it by name instead
+    NoodleValue_t* pEntry = noodleGroupFind(pGroup, noodleStringHeader(pKey)->hash, pKey, !pGroup->included);
+    if (!pEntry) return NULL;
+
+    return noodleEntryNoodle(pEntry);
 }
 
 NoodleGroup_t* noodleGroupFrom(const NoodleGroup_t* pGroup, const char* pName)
@@ -577,11 +1492,147 @@ const NoodleArray_t* noodleArrayFrom(const NoodleGroup_t* pGroup, const char* pN
     return (NoodleArray_t*)pNoodle; 
 }
 
+Noodle_t* noodleFromHashed(const NoodleGroup_t* pGroup, const char* pName, size_t hash)
+{
+    assert(pGroup);
+    assert(pName);
+
+    if (pGroup->overlay) return noodleOverlayFrom((const NoodleOverlay_t*)pGroup, pName);
+
+    NoodleValue_t* pEntry = noodleGroupFind(pGroup, hash, pName, NOODLE_FALSE);
+    if (!pEntry) return NULL;
+
+    return noodleEntryNoodle(pEntry);
+}
+
+int noodleIntOf(const Noodle_t* pNoodle, NOODLE_BOOL* pSucceeded)
+{
+    NOODLE_BOOL succeeded = pNoodle && pNoodle->type == NOODLE_TYPE_INTEGER;
+    if (pSucceeded) *pSucceeded = succeeded;
+
+    return succeeded ? ((const NoodleValue_t*)pNoodle)->i : 0;
+}
+
+float noodleFloatOf(const Noodle_t* pNoodle, NOODLE_BOOL* pSucceeded)
+{
+    NOODLE_BOOL succeeded = pNoodle && pNoodle->type == NOODLE_TYPE_FLOAT;
+    if (pSucceeded) *pSucceeded = succeeded;
+
+    return succeeded ? ((const NoodleValue_t*)pNoodle)->f : 0.0f;
+}
+
+NOODLE_BOOL noodleBoolOf(const Noodle_t* pNoodle, NOODLE_BOOL* pSucceeded)
+{
+    NOODLE_BOOL succeeded = pNoodle && pNoodle->type == NOODLE_TYPE_BOOLEAN;
+    if (pSucceeded) *pSucceeded = succeeded;
+
+    return succeeded ? ((const NoodleValue_t*)pNoodle)->b : NOODLE_FALSE;
+}
+
+const char* noodleStringOf(const Noodle_t* pNoodle)
+{
+    if (!pNoodle || pNoodle->type != NOODLE_TYPE_STRING) return NULL;
+    return ((const NoodleValue_t*)pNoodle)->s;
+}
+
+size_t noodleGetMany(const NoodleGroup_t* pGroup, const char* const* ppNames, size_t count, Noodle_t** ppNoodles)
+{
+    assert(pGroup);
+    assert((ppNames && ppNoodles) || count == 0);
+
+    size_t found = 0;
+
+    // Overlays search their layers one key at a time
+    if (pGroup->overlay || !noodleGroupReady(pGroup))
+    {
+        for (size_t i = 0; i < count; i++)
+        {
+            ppNoodles[i] = noodleFrom(pGroup, ppNames[i]);
+            if (ppNoodles[i]) found++;
+        }
+
+        return found;
+    }
+
+    const NoodleFrozen_t* pFrozen = pGroup->pFrozen;
+    size_t pHashes[NOODLE_GET_MANY_BATCH];
+
+    // Each stage touches memory the previous one prefetched, so the misses 
+    // of a whole batch overlap instead of one lookup waiting on the next
+    for (size_t first = 0; first < count; first += NOODLE_GET_MANY_BATCH)
+    {
+        size_t batch = count - first < NOODLE_GET_MANY_BATCH ? count - first : NOODLE_GET_MANY_BATCH;
+
+        for (size_t i = 0; i < batch; i++)
+        {
+            pHashes[i] = noodleGroupHashFunction(ppNames[first + i]);
+            uint64_t mixed = noodleHashMix(pHashes[i]);
+
+            if (pFrozen)
+                NOODLE_PREFETCH(&pFrozen->pSeeds[mixed % pFrozen->bucketCount]);
+            else if (pGroup->indexCapacity)
+                NOODLE_PREFETCH(&pGroup->pIndex[mixed & (pGroup->indexCapacity - 1)]);
+        }
+
+        for (size_t i = 0; i < batch; i++)
+        {
+            if (pFrozen)
+            {
+                NOODLE_PREFETCH(&pFrozen->pSlots[noodleFrozenSlot(pFrozen, pHashes[i])]);
+            }
+            else if (pGroup->indexCapacity)
+            {
+                uint32_t index = pGroup->pIndex[noodleHashMix(pHashes[i]) & (pGroup->indexCapacity - 1)];
+                if (index) NOODLE_PREFETCH(&pGroup->pEntries[index - 1]);
+            }
+        }
+
+        for (size_t i = 0; i < batch; i++)
+        {
+            NoodleValue_t* pEntry = noodleGroupFind(pGroup, pHashes[i], ppNames[first + i], NOODLE_FALSE);
+
+            ppNoodles[first + i] = pEntry ? noodleEntryNoodle(pEntry) : NULL;
+            if (pEntry) found++;
+        }
+    }
+
+    return found;
+}
+
+size_t noodleGetManyInts(const NoodleGroup_t* pGroup, const char* const* ppNames, size_t count, int* pValues, NOODLE_BOOL* pSucceeded)
+{
+    return noodleGetManyTyped(pGroup, ppNames, count, NOODLE_TYPE_INTEGER, pValues, sizeof(int), pSucceeded);
+}
+
+size_t noodleGetManyFloats(const NoodleGroup_t* pGroup, const char* const* ppNames, size_t count, float* pValues, NOODLE_BOOL* pSucceeded)
+{
+    return noodleGetManyTyped(pGroup, ppNames, count, NOODLE_TYPE_FLOAT, pValues, sizeof(float), pSucceeded);
+}
+
+size_t noodleGetManyBools(const NoodleGroup_t* pGroup, const char* const* ppNames, size_t count, NOODLE_BOOL* pValues, NOODLE_BOOL* pSucceeded)
+{
+    return noodleGetManyTyped(pGroup, ppNames, count, NOODLE_TYPE_BOOLEAN, pValues, sizeof(NOODLE_BOOL), pSucceeded);
+}
+
+size_t noodleGetManyStrings(const NoodleGroup_t* pGroup, const char* const* ppNames, size_t count, const char** ppValues, NOODLE_BOOL* pSucceeded)
+{
+    return noodleGetManyTyped(pGroup, ppNames, count, NOODLE_TYPE_STRING, (void*)ppValues, sizeof(const char*), pSucceeded);
+}
+
 size_t noodleCount(const Noodle_t* pNoodle)
 {
     switch (pNoodle->type)
     {
-    case NOODLE_TYPE_GROUP: return ((NoodleGroup_t*)pNoodle)->count;
+    case NOODLE_TYPE_GROUP:
+    {
+        const NoodleGroup_t* pGroup = (const NoodleGroup_t*)pNoodle;
+        if (!pGroup->overlay) return noodleGroupReady(pGroup) ? pGroup->count : 0;
+
+        // Keys found in several layers are only counted once
+        size_t count = 0;
+        noodleVisit(pGroup, noodleVisitCount, &count);
+        return count;
+    }
     case NOODLE_TYPE_ARRAY: return ((NoodleArray_t*)pNoodle)->count;
     default:
         assert(false && "Type not a valid array or group!");
@@ -625,691 +1676,6654 @@ const char* noodleStringAt(const NoodleArray_t* pArray, size_t index)
     return pArray->ppStrings[index];
 }
 
-void noodleCleanup(NoodleGroup_t* pGroup)
+NoodleType_t noodleArrayType(const NoodleArray_t* pArray)
 {
-    noodleFree((Noodle_t*)pGroup);
+    assert(pArray);
+    return pArray->type;
 }
 
-NOODLE_BOOL noodleHas(const NoodleGroup_t* pGroup, const char* pName)
+const void* noodleArrayData(const NoodleArray_t* pArray)
 {
-    assert(pGroup);
-    assert(pName);
+    assert(pArray);
+    return pArray->pIntegers;
+}
 
-    size_t index = noodleGroupHashFunction(pName) % pGroup->bucketCount;
+void noodleCleanup(NoodleGroup_t* pGroup)
+{
+    if (!pGroup) return;
 
-    NoodleNode_t* pNode = pGroup->ppBuckets[index];
+    assert(!pGroup->base.pParent && "Only the root group of a document can be cleaned up!");
 
-    while (pNode)
+    if (pGroup->overlay)
     {
-        if (strcmp(pName, pNode->pNoodle->pName) == 0)
-            return NOODLE_TRUE;
-
-        pNode = pNode->pNext;
+        noodleOverlayFree((NoodleOverlay_t*)pGroup);
+        return;
     }
 
-    return NOODLE_FALSE;
+    // Copy the allocator out first, it's freed along with the root
+    NoodleRoot_t* pRoot = (NoodleRoot_t*)pGroup;
+    NoodleAllocator_t allocator = pRoot->allocator;
+    NoodleStringTable_t* pStrings = pRoot->pStrings;
+    NoodleLazyGroup_t* pLazyGroups = pRoot->pLazyGroups;
+    NoodleInclude_t** ppIncludes = pRoot->ppIncludes;
+    size_t includeCount = pRoot->includeCount;
+
+    if (pRoot->pSource) noodleMutexDestroy(&pRoot->lock);
+
+    NOODLE_PROBE1(free__start, pGroup);
+
+    // Lazy groups only free what they parsed, the groups themselves go at once
+    noodleFree(&allocator, (Noodle_t*)pGroup);
+    noodleDealloc(&allocator, pLazyGroups);
+    noodleStringTableRelease(pStrings);
+
+    // Nothing borrows from the included files anymore
+    for (size_t i = 0; i < includeCount; i++)
+        noodleIncludeRelease(ppIncludes[i]);
+
+    noodleDealloc(&allocator, ppIncludes);
+
+    NOODLE_PROBE1(free__done, pGroup);
 }
 
-void noodleGroupForeach(NoodleGroup_t* pGroup, NoodleForeachGroupCallback_t callback)
+void noodleCleanupDeferred(NoodleGroup_t* pGroup)
 {
-    assert(pGroup);
-    assert(callback);
+    if (!pGroup) return;
 
-    for (int i = 0; i < NOODLE_GROUP_BUCKETS_COUNT; i++)
+    assert(!pGroup->base.pParent && "Only the root group of a document can be cleaned up!");
+
+    // The pools of a context can't be used from another thread
+    if (!pGroup->overlay && ((NoodleRoot_t*)pGroup)->allocator.pfnAlloc == noodlePoolAlloc)
     {
-        NoodleNode_t* pNode = pGroup->ppBuckets[i];
+        noodleCleanup(pGroup);
+        return;
+    }
 
-        while (pNode)
-        {
-            if (!callback(pNode->pNoodle)) break;
-            pNode = pNode->pNext;
-        }
+    noodleMutexLock(&gNoodleReclaimer.lock);
+
+    if (!gNoodleReclaimer.started)
+        gNoodleReclaimer.started = noodleThreadStart(noodleReclaimer, NULL, NULL);
+
+    if (!gNoodleReclaimer.started)
+    {
+        noodleMutexUnlock(&gNoodleReclaimer.lock);
+        noodleCleanup(pGroup);
+        return;
     }
-}
 
+    pGroup->base.pParent = gNoodleReclaimer.pFirst;
+    gNoodleReclaimer.pFirst = pGroup;
+    gNoodleReclaimer.pending++;
 
+    noodleConditionSignal(&gNoodleReclaimer.wake);
+    noodleMutexUnlock(&gNoodleReclaimer.lock);
+}
 
-////////////////////////////////////////////////////////////////////////////////
-// HELPER FUNCTION DEFINITIONS
-////////////////////////////////////////////////////////////////////////////////
+void noodleCleanupWait(void)
+{
+    noodleMutexLock(&gNoodleReclaimer.lock);
 
+    while (gNoodleReclaimer.pending > 0)
+        noodleConditionWait(&gNoodleReclaimer.idle, &gNoodleReclaimer.lock);
 
+    noodleMutexUnlock(&gNoodleReclaimer.lock);
+}
 
-char* noodleStringDuplicate(const char* pStr)
+NOODLE_BOOL noodleHas(const NoodleGroup_t* pGroup, const char* pName)
 {
-    size_t length = strlen(pStr) + 1;
-    char* pNewStr = NOODLE_MALLOC(length);
+    assert(pGroup);
+    assert(pName);
 
-    if (pNewStr == NULL)
-        return NULL;
+    return noodleFrom(pGroup, pName) ? NOODLE_TRUE : NOODLE_FALSE;
+}
 
-    return memcpy(pNewStr, pStr, length);
+void noodleGroupForeach(NoodleGroup_t* pGroup, NoodleForeachGroupCallback_t callback)
+{
+    assert(pGroup);
+    assert(callback);
+
+    noodleVisit(pGroup, noodleVisitForeach, &callback);
 }
 
-const char* noodleStringFromTokenKind(NoodleTokenKind_t kind)
+size_t noodleMemoryUsage(const Noodle_t* pNoodle)
 {
-    switch (kind)
-    {
-        case NOODLE_TOKEN_KIND_IDENTIFIER: return "Identifier"; 
-        case NOODLE_TOKEN_KIND_INTEGER: return "Integer"; 
-        case NOODLE_TOKEN_KIND_FLOAT: return "Float"; 
-        case NOODLE_TOKEN_KIND_BOOLEAN: return "Boolean"; 
-        case NOODLE_TOKEN_KIND_STRING: return "String"; 
-        case NOODLE_TOKEN_KIND_LEFTCURLY: return "Left Curly"; 
-        case NOODLE_TOKEN_KIND_RIGHTCURLY: return "Right Curly"; 
-        case NOODLE_TOKEN_KIND_LEFTBRACKET: return "Left Bracket"; 
-        case NOODLE_TOKEN_KIND_RIGHTBRACKET: return "Right Bracket"; 
-        case NOODLE_TOKEN_KIND_EQUAL: return "Equal"; 
-        case NOODLE_TOKEN_KIND_COMMA: return "Comma"; 
-        case NOODLE_TOKEN_KIND_END: return "End"; 
-        case NOODLE_TOKEN_KIND_COMMENT: return "Comment"; 
-        case NOODLE_TOKEN_KIND_NEWLINE: return "Newline"; 
-        
-        default:
-        case NOODLE_TOKEN_KIND_UNEXPECTED: return "Unexpected"; 
-    }
+    assert(pNoodle);
+
+    NoodleParseStats_t stats = {0};
+    noodleMeasure(pNoodle, 0, &stats);
+
+    return stats.allocationBytes;
 }
 
-NoodleToken_t noodleToken(NoodleTokenKind_t kind, int start, int end)
+const NoodleAllocator_t* noodleAllocator(const Noodle_t* pNoodle)
 {
-    return (NoodleToken_t){kind, start, end};
+    assert(pNoodle);
+
+    // Any noodle can find its document by walking up to the root
+    while (pNoodle->pParent)
+        pNoodle = (const Noodle_t*)pNoodle->pParent;
+
+    assert(pNoodle->type == NOODLE_TYPE_GROUP);
+
+    return &((const NoodleRoot_t*)pNoodle)->allocator;
 }
 
-int noodleParseInt(const NoodleLexer_t* pLexer, const NoodleToken_t* pToken)
+NOODLE_BOOL noodleFreeze(NoodleGroup_t* pRoot)
 {
-    assert(pLexer);
-    assert(pToken);
-    assert(pToken->kind == NOODLE_TOKEN_KIND_INTEGER);
+    assert(pRoot);
+    assert(!pRoot->base.pParent && "Only the root group of a document can be frozen!");
+
+    // Overlays don't own their layers, the documents under them can be frozen instead
+    if (pRoot->overlay) return NOODLE_FALSE;
 
-    return (int)strtol(pLexer->pContent + pToken->start, NULL, 10);
+    return noodleGroupFreeze(&((NoodleRoot_t*)pRoot)->allocator, pRoot);
 }
 
-float noodleParseFloat(const NoodleLexer_t* pLexer, const NoodleToken_t* pToken)
+NoodleStringTable_t* noodleStringTableCreate(const NoodleAllocator_t* pAllocator)
 {
-    assert(pLexer);
-    assert(pToken);
-    assert(pToken->kind == NOODLE_TOKEN_KIND_FLOAT);
+    NoodleAllocator_t allocator = {noodleDefaultAlloc, noodleDefaultRealloc, noodleDefaultFree, NULL};
+    if (pAllocator) allocator = *pAllocator;
 
-    return strtof(pLexer->pContent + pToken->start, NULL);
+    NoodleStringTable_t* pStrings = noodleAlloc(&allocator, sizeof(NoodleStringTable_t));
+    if (!pStrings) return NULL;
+
+    memset(pStrings, 0, sizeof(NoodleStringTable_t));
+    pStrings->allocator = allocator;
+    pStrings->references = 1;
+
+    return pStrings;
 }
 
-NOODLE_BOOL noodleParseBool(const NoodleLexer_t* pLexer, const NoodleToken_t* pToken)
+void noodleStringTableDestroy(NoodleStringTable_t* pStrings)
 {
-    assert(pLexer);
-    assert(pToken);
-    assert(pToken->kind == NOODLE_TOKEN_KIND_BOOLEAN);
-    
-    return (*(pLexer->pContent + pToken->start) == 't') ? NOODLE_TRUE : NOODLE_FALSE;   
+    // Documents using the table hold their own reference
+    noodleStringTableRelease(pStrings);
 }
 
-char* noodleParseString(const NoodleLexer_t* pLexer, const NoodleToken_t* pToken)
+const char* noodleIntern(const Noodle_t* pNoodle, const char* pName)
 {
-    // Need to allocate a new string
-    int stringLength = pToken->end - pToken->start; // Convert indexes into counts
-    char* pString = NOODLE_MALLOC(stringLength + 1);
-    if (!pString) return NULL;
+    assert(pNoodle);
+    assert(pName);
 
-    // Set the identifier string's contents
-    memset(pString, 0, stringLength + 1);
-    memcpy(pString, pLexer->pContent + pToken->start, stringLength);
-    
-    return pString;
-}
+    while (pNoodle->pParent)
+        pNoodle = (const Noodle_t*)pNoodle->pParent;
 
-NoodleGroup_t* noodleGroup(char* pName, NoodleGroup_t* pParent)
-{
-    // Allocate the group and cast to the noodle base composition
-    NoodleGroup_t* pGroup = NOODLE_MALLOC(sizeof(NoodleGroup_t));
-    Noodle_t* pNoodle = (Noodle_t*)pGroup;
-    if (!pGroup)
+    // Any layer's copy of the name works, overlays compare keys by their contents
+    if (((const NoodleGroup_t*)pNoodle)->overlay)
     {
+        const NoodleOverlay_t* pOverlay = (const NoodleOverlay_t*)pNoodle;
+
+        for (size_t i = 0; i < pOverlay->count; i++)
+        {
+            const char* pKey = noodleIntern((const Noodle_t*)pOverlay->ppLayers[i], pName);
+            if (pKey) return pKey;
+        }
+
         return NULL;
     }
 
-    memset(pGroup, 0, sizeof(NoodleGroup_t));
+    const NoodleRoot_t* pRoot = (const NoodleRoot_t*)pNoodle;
+    size_t length = strlen(pName);
 
-    // Set the values
-    pNoodle->pName = pName;
-    pNoodle->pParent = pParent;
-    pNoodle->type = NOODLE_TYPE_GROUP;
-    pGroup->bucketCount = NOODLE_GROUP_BUCKETS_COUNT;
+    const char* pKey = noodleStringTableFind(pRoot->pStrings, pName, length, noodleHashBytes(pName, length));
+    if (pKey) return pKey;
 
-    return pGroup;
+    // Names only found in borrowed groups are in the included files' tables,
+    // those groups compare keys by their contents
+    for (size_t i = 0; i < pRoot->includeCount; i++)
+    {
+        pKey = noodleIntern((const Noodle_t*)pRoot->ppIncludes[i]->pDocument, pName);
+        if (pKey) return pKey;
+    }
+
+    return NULL;
 }
 
-NoodleArray_t* noodleArray(char* pName, NoodleType_t type, NoodleGroup_t* pParent)
+NoodleTape_t* noodleParseTape(const char* pContent, const NoodleAllocator_t* pAllocator, char* pErrorBuffer, size_t bufferSize)
 {
-    assert(pName);
+    if (!pContent) goto cleanupArgument;
 
-    NoodleArray_t* pArray = NOODLE_MALLOC(sizeof(NoodleArray_t));
-    Noodle_t* pNoodle = (Noodle_t*)pArray;
-    if (!pArray)
+    if (pErrorBuffer && bufferSize > 1 )
     {
-        return NULL;
+        memset(pErrorBuffer, '\0', bufferSize);
+        bufferSize--; // Allow for at least one null-terminator
+    }
+    else
+    {
+        pErrorBuffer = NULL;
+        bufferSize = 0;
     }
 
-    pNoodle->pName = pName;
-    pNoodle->pParent = pParent;
-    pNoodle->type = NOODLE_TYPE_ARRAY;
-    pArray->type = type;
-    pArray->count = 0;
-    pArray->pIntegers = NULL;
+    NoodleAllocator_t allocator = {noodleDefaultAlloc, noodleDefaultRealloc, noodleDefaultFree, NULL};
+    if (pAllocator) allocator = *pAllocator;
 
-    return pArray;
-}
+    NoodleTape_t* pTape = noodleAlloc(&allocator, sizeof(NoodleTape_t) + sizeof(uint64_t) * NOODLE_TAPE_INITIAL_CAPACITY);
+    if (!pTape) goto cleanupTape;
 
-NoodleValue_t* noodleValue(char* pName, NoodleType_t type, NoodleGroup_t* pParent)
-{
-    assert(pName);
+    memset(pTape, 0, sizeof(NoodleTape_t));
+    pTape->allocator = allocator;
+    pTape->capacity = NOODLE_TAPE_INITIAL_CAPACITY;
 
-    NoodleValue_t* pValue = NOODLE_MALLOC(sizeof(NoodleValue_t));
-    if (!pValue) return NULL;
+    // Each open group remembers where it started and how many keys it has,
+    // the root is always at the bottom
+    size_t stackCapacity = 16;
+    size_t stackCount = 1;
+    size_t* pStack = noodleAlloc(&allocator, sizeof(size_t) * 2 * stackCapacity);
+    if (!pStack) goto cleanupMemory;
 
-    Noodle_t* pNoodle = (Noodle_t*)pValue;
-    pNoodle->pName = pName;
-    pNoodle->type = type;
-    pNoodle->pParent = pParent;
+    pStack[0] = 0;
+    pStack[1] = 0;
 
-    return pValue;
-}
+    if (!noodleTapePush(&pTape, noodleTapeWord(NOODLE_TAPE_TAG_GROUP_OPEN, 0))) goto cleanupMemory;
 
-NoodleValue_t* noodleInt(char* pName, int value, NoodleGroup_t* pParent)
-{
-    assert(pName);
+    NoodleLexer_t lexer = noodleLexer(pContent, strlen(pContent));
+    NoodleToken_t token = {0};
 
-    NoodleValue_t* pValue = noodleValue(pName, NOODLE_TYPE_INTEGER, pParent);
-    if (!pValue) return NULL;
+    noodleLexerNextToken(&lexer, &token);
 
-    pValue->i = value;
+    const char* pErrorExpected = "";
 
-    return pValue;
-}
+    while (token.kind != NOODLE_TOKEN_KIND_END)
+    {
+        if (token.kind != NOODLE_TOKEN_KIND_IDENTIFIER)
+        {
+            pErrorExpected = "Identifier";
+            goto cleanupParse;
+        }
 
-NoodleValue_t* noodleFloat(char* pName, float value, NoodleGroup_t* pParent)
-{
-    assert(pName);
+        uint64_t offset = 0;
+        size_t length = token.end - token.start;
 
-    NoodleValue_t* pValue = noodleValue(pName, NOODLE_TYPE_FLOAT, pParent);
-    if (!pValue) return NULL;
+        if (!noodleTapePushString(pTape, pContent + token.start, length, NOODLE_FALSE, &offset)) goto cleanupMemory;
 
-    pValue->f = value;
+        uint64_t hash = noodleHashBytes(pContent + token.start, length) & 0xffff;
+        if (!noodleTapePush(&pTape, noodleTapeWord(NOODLE_TAPE_TAG_KEY, (hash << NOODLE_TAPE_KEY_HASH_SHIFT) | offset))) goto cleanupMemory;
 
-    return pValue;
-}
+        pStack[(stackCount - 1) * 2 + 1]++;
 
-NoodleValue_t* noodleBool(char* pName, NOODLE_BOOL value, NoodleGroup_t* pParent)
-{
-    assert(pName);
+        noodleLexerNextToken(&lexer, &token);
 
-    NoodleValue_t* pValue = noodleValue(pName, NOODLE_TYPE_BOOLEAN, pParent);
-    if (!pValue) return NULL;
+        if (token.kind != NOODLE_TOKEN_KIND_EQUAL)
+        {
+            pErrorExpected = "Equals Symbol";
+            goto cleanupParse;
+        }
 
-    pValue->b = value;
+        noodleLexerNextToken(&lexer, &token);
 
-    return pValue;
+        switch (token.kind)
+        {
+            case NOODLE_TOKEN_KIND_LEFTCURLY:
+            {
+                if (stackCount == stackCapacity)
+                {
+                    size_t* pNewStack = noodleRealloc(&allocator, pStack, sizeof(size_t) * 2 * stackCapacity * 2);
+                    if (!pNewStack) goto cleanupMemory;
+
+                    pStack = pNewStack;
+                    stackCapacity *= 2;
+                }
+
+                pStack[stackCount * 2] = pTape->count;
+                pStack[stackCount * 2 + 1] = 0;
+                stackCount++;
+
+                // The payload is patched once the group closes
+                if (!noodleTapePush(&pTape, noodleTapeWord(NOODLE_TAPE_TAG_GROUP_OPEN, 0))) goto cleanupMemory;
+                break;
+            }
+            case NOODLE_TOKEN_KIND_INTEGER:
+            case NOODLE_TOKEN_KIND_FLOAT:
+            case NOODLE_TOKEN_KIND_BOOLEAN:
+            case NOODLE_TOKEN_KIND_STRING:
+                if (!noodleTapePushValue(&pTape, &lexer, &token)) goto cleanupMemory;
+                break;
+            case NOODLE_TOKEN_KIND_LEFTBRACKET:
+            {
+                size_t arrayOpen = pTape->count;
+                if (!noodleTapePush(&pTape, noodleTapeWord(NOODLE_TAPE_TAG_ARRAY_OPEN, 0))) goto cleanupMemory;
+
+                noodleLexerNextToken(&lexer, &token);
+
+                if (token.kind != NOODLE_TOKEN_KIND_INTEGER && 
+                    token.kind != NOODLE_TOKEN_KIND_FLOAT &&
+                    token.kind != NOODLE_TOKEN_KIND_BOOLEAN &&
+                    token.kind != NOODLE_TOKEN_KIND_STRING)
+                {
+                    pErrorExpected = "Integer, Float, Boolean, or String";
+                    goto cleanupParse;
+                }
+
+                // Unlike the tree the elements are written as they are lexed
+                NoodleTokenKind_t expected = token.kind;
+
+                while (token.kind != NOODLE_TOKEN_KIND_RIGHTBRACKET)
+                {
+                    if (token.kind != expected)
+                    {
+                        pErrorExpected = noodleStringFromTokenKind(expected);
+                        goto cleanupParse;
+                    }
+
+                    if (!noodleTapePushValue(&pTape, &lexer, &token)) goto cleanupMemory;
+
+                    noodleLexerNextToken(&lexer, &token);
+
+                    if (token.kind == NOODLE_TOKEN_KIND_COMMA)
+                        noodleLexerNextToken(&lexer, &token);
+                }
+
+                size_t elements = pTape->count - arrayOpen - 1;
+                if (!noodleTapePush(&pTape, noodleTapeWord(NOODLE_TAPE_TAG_ARRAY_CLOSE, elements))) goto cleanupMemory;
+
+                pTape->pWords[arrayOpen] = noodleTapeWord(NOODLE_TAPE_TAG_ARRAY_OPEN, pTape->count);
+                break;
+            }
+            default:
+                pErrorExpected = "Value";
+                goto cleanupParse;
+        }
+
+        noodleLexerNextToken(&lexer, &token);
+
+        if (token.kind == NOODLE_TOKEN_KIND_COMMA)
+        {
+            noodleLexerNextToken(&lexer, &token);
+
+            if (token.kind != NOODLE_TOKEN_KIND_RIGHTCURLY)
+                continue;
+        }
+
+        while (token.kind == NOODLE_TOKEN_KIND_RIGHTCURLY)
+        {
+            if (stackCount == 1)
+            {
+                pErrorExpected = "Identifier";
+                goto cleanupParse;
+            }
+
+            stackCount--;
+
+            size_t groupOpen = pStack[stackCount * 2];
+            if (!noodleTapePush(&pTape, noodleTapeWord(NOODLE_TAPE_TAG_GROUP_CLOSE, pStack[stackCount * 2 + 1]))) goto cleanupMemory;
+
+            pTape->pWords[groupOpen] = noodleTapeWord(NOODLE_TAPE_TAG_GROUP_OPEN, pTape->count);
+
+            noodleLexerNextToken(&lexer, &token);
+        }
+    }
+
+    // Like the tree, groups left open at the end are closed implicitly
+    while (stackCount > 0)
+    {
+        stackCount--;
+
+        size_t groupOpen = pStack[stackCount * 2];
+        if (!noodleTapePush(&pTape, noodleTapeWord(NOODLE_TAPE_TAG_GROUP_CLOSE, pStack[stackCount * 2 + 1]))) goto cleanupMemory;
+
+        pTape->pWords[groupOpen] = noodleTapeWord(NOODLE_TAPE_TAG_GROUP_OPEN, pTape->count);
+    }
+
+    noodleDealloc(&allocator, pStack);
+    return pTape;
+
+cleanupArgument:
+    snprintf(pErrorBuffer, bufferSize, "Invalid argument!");
+    return NULL;
+
+cleanupTape:
+    snprintf(pErrorBuffer, bufferSize, "Could not allocate memory!");
+    return NULL;
+
+cleanupMemory:
+    snprintf(pErrorBuffer, bufferSize, "Could not allocate memory!");
+    noodleDealloc(&allocator, pStack);
+    noodleTapeCleanup(pTape);
+    return NULL;
+
+cleanupParse:
+    snprintf(pErrorBuffer, bufferSize, "(Ln %zu, Col %zu) Unexpected token found, \"%.*s\", expected token, \"%s\"!", lexer.line, lexer.character, noodleTokenPrintLength(&token), pContent + token.start, pErrorExpected);
+    noodleDealloc(&allocator, pStack);
+    noodleTapeCleanup(pTape);
+    return NULL;
 }
 
-NoodleValue_t* noodleString(char* pName, char* pStrValue, NoodleGroup_t* pParent)
+NoodleTape_t* noodleTapeClone(const NoodleTape_t* pTape, const NoodleAllocator_t* pAllocator)
 {
-    assert(pName);
+    assert(pTape);
 
-    NoodleValue_t* pValue = noodleValue(pName, NOODLE_TYPE_STRING, pParent);
-    if (!pValue) return NULL;
+    // Published tapes don't have an allocator, pointers aren't shared
+    NoodleAllocator_t allocator = {noodleDefaultAlloc, noodleDefaultRealloc, noodleDefaultFree, NULL};
+    if (pAllocator) allocator = *pAllocator;
+    else if (!pTape->stringsOffset) allocator = pTape->allocator;
 
-    pValue->s = pStrValue;
+    // Nothing on the tape is a pointer so copying is just two copies
+    size_t size = sizeof(NoodleTape_t) + sizeof(uint64_t) * pTape->count;
 
-    return pValue;
+    NoodleTape_t* pClone = noodleAlloc(&allocator, size);
+    if (!pClone) return NULL;
+
+    memcpy(pClone, pTape, size);
+    pClone->allocator = allocator;
+    pClone->capacity = pTape->count;
+    pClone->stringsCapacity = pTape->stringsSize;
+    pClone->stringsOffset = 0;
+    pClone->pStrings = NULL;
+
+    if (pTape->stringsSize)
+    {
+        pClone->pStrings = noodleAlloc(&allocator, pTape->stringsSize);
+        if (!pClone->pStrings)
+        {
+            noodleDealloc(&allocator, pClone);
+            return NULL;
+        }
+
+        memcpy(pClone->pStrings, noodleTapeStrings(pTape), pTape->stringsSize);
+    }
+
+    return pClone;
 }
 
-size_t noodleGroupHashFunction(const char* pName)
+void noodleTapeCleanup(NoodleTape_t* pTape)
 {
-    // Implementation of sdbm
-    size_t hash = 0;
-    int c;
+    if (!pTape) return;
 
-    while (c = *pName++)
-        hash = c + (hash << 6) + (hash << 16) - hash;
+    // Published tapes have no allocator, they belong to their subscriber
+    assert(!pTape->stringsOffset);
+    if (pTape->stringsOffset) return;
 
-    return hash;
+    NoodleAllocator_t allocator = pTape->allocator;
+    noodleDealloc(&allocator, pTape->pStrings);
+    noodleDealloc(&allocator, pTape);
 }
 
-NOODLE_BOOL noodleGroupInsert(NoodleGroup_t* pGroup, const char* pName, Noodle_t* pNoodle)
+size_t noodleTapeFrom(const NoodleTape_t* pTape, size_t group, const char* pName)
 {
-    assert(pGroup && pName && pNoodle);
+    assert(pTape);
+    assert(pName);
+    assert(group < pTape->count && noodleTapeTag(pTape->pWords[group]) == NOODLE_TAPE_TAG_GROUP_OPEN);
 
-    // Allocate a noodle group node
-    NoodleNode_t* pNode = NOODLE_MALLOC(sizeof(NoodleNode_t));
-    if (!pNode)
+    uint64_t hash = noodleGroupHashFunction(pName) & 0xffff;
+    size_t close = (size_t)noodleTapePayload(pTape->pWords[group]) - 1;
+    size_t i = group + 1;
+
+    while (i < close)
     {
-        return false;
-    }
+        uint64_t key = noodleTapePayload(pTape->pWords[i]);
 
-    pNode->pNext = NULL;
-    pNode->pNoodle = pNoodle;
+        if ((key >> NOODLE_TAPE_KEY_HASH_SHIFT) == hash && strcmp(noodleTapeStrings(pTape) + (key & NOODLE_TAPE_OFFSET_MASK), pName) == 0)
+            return i + 1;
 
-    // Hash the name to get an index
-    size_t index = noodleGroupHashFunction(pName) % pGroup->bucketCount;
+        // Nested groups and arrays are skipped in one step
+        uint64_t value = pTape->pWords[i + 1];
+        NoodleTapeTag_t tag = noodleTapeTag(value);
 
-    // Add this node to the last value in the bucket
-    NoodleNode_t* pCurrent = pGroup->ppBuckets[index];
-    
-    if (!pCurrent)
-    {
-        pGroup->ppBuckets[index] = pNode;
-        return true;
+        if (tag == NOODLE_TAPE_TAG_GROUP_OPEN || tag == NOODLE_TAPE_TAG_ARRAY_OPEN)
+            i = (size_t)noodleTapePayload(value);
+        else
+            i += 2;
     }
 
-    while (pCurrent->pNext)
+    return NOODLE_TAPE_NONE;
+}
+
+size_t noodleTapeAt(const NoodleTape_t* pTape, size_t array, size_t index)
+{
+    assert(pTape);
+    assert(noodleTapeType(pTape, array) == NOODLE_TYPE_ARRAY);
+    assert(index < noodleTapeCount(pTape, array));
+
+    // Array elements are always a single word each
+    return array + 1 + index;
+}
+
+NoodleType_t noodleTapeType(const NoodleTape_t* pTape, size_t index)
+{
+    assert(pTape);
+    assert(index < pTape->count);
+
+    switch (noodleTapeTag(pTape->pWords[index]))
     {
-        pCurrent = pCurrent->pNext; 
+        case NOODLE_TAPE_TAG_GROUP_OPEN: return NOODLE_TYPE_GROUP;
+        case NOODLE_TAPE_TAG_ARRAY_OPEN: return NOODLE_TYPE_ARRAY;
+        case NOODLE_TAPE_TAG_INTEGER: return NOODLE_TYPE_INTEGER;
+        case NOODLE_TAPE_TAG_FLOAT: return NOODLE_TYPE_FLOAT;
+        case NOODLE_TAPE_TAG_BOOLEAN: return NOODLE_TYPE_BOOLEAN;
+        case NOODLE_TAPE_TAG_STRING: return NOODLE_TYPE_STRING;
+        default:
+            assert(false && "Index is not the start of a value!");
+            return NOODLE_TYPE_GROUP;
     }
-
-    pGroup->count++;
-    pCurrent->pNext = pNode;
-    return true;
 }
 
-NoodleLexer_t noodleLexer(const char* pContent)
+size_t noodleTapeCount(const NoodleTape_t* pTape, size_t index)
 {
-    return (NoodleLexer_t){pContent, 0, 0, 0};
+    assert(pTape);
+    assert(index < pTape->count);
+
+    NoodleTapeTag_t tag = noodleTapeTag(pTape->pWords[index]);
+    assert((tag == NOODLE_TAPE_TAG_GROUP_OPEN || tag == NOODLE_TAPE_TAG_ARRAY_OPEN) && "Type not a valid array or group!");
+    (void)tag;
+
+    // The closing word holds the count
+    size_t close = (size_t)noodleTapePayload(pTape->pWords[index]) - 1;
+    return (size_t)noodleTapePayload(pTape->pWords[close]);
 }
 
-NOODLE_BOOL noodleLexerIsIdentifier(char c)
+int noodleTapeInt(const NoodleTape_t* pTape, size_t index)
 {
-    switch (c)
+    assert(pTape);
+    assert(noodleTapeType(pTape, index) == NOODLE_TYPE_INTEGER);
+
+    return (int)(int32_t)(uint32_t)noodleTapePayload(pTape->pWords[index]);
+}
+
+float noodleTapeFloat(const NoodleTape_t* pTape, size_t index)
+{
+    assert(pTape);
+    assert(noodleTapeType(pTape, index) == NOODLE_TYPE_FLOAT);
+
+    uint32_t bits = (uint32_t)noodleTapePayload(pTape->pWords[index]);
+    float value;
+    memcpy(&value, &bits, sizeof(float));
+
+    return value;
+}
+
+NOODLE_BOOL noodleTapeBool(const NoodleTape_t* pTape, size_t index)
+{
+    assert(pTape);
+    assert(noodleTapeType(pTape, index) == NOODLE_TYPE_BOOLEAN);
+
+    return noodleTapePayload(pTape->pWords[index]) ? NOODLE_TRUE : NOODLE_FALSE;
+}
+
+const char* noodleTapeString(const NoodleTape_t* pTape, size_t index)
+{
+    assert(pTape);
+    assert(noodleTapeType(pTape, index) == NOODLE_TYPE_STRING);
+
+    return noodleTapeStrings(pTape) + noodleTapePayload(pTape->pWords[index]);
+}
+
+NoodlePublisher_t* noodlePublisherCreate(const char* pName, const NoodleAllocator_t* pAllocator, char* pErrorBuffer, size_t bufferSize)
+{
+    if (pErrorBuffer && bufferSize > 1 )
     {
-        case 'a':
-        case 'b':
-        case 'c':
-        case 'd':
-        case 'e':
-        case 'f':
-        case 'g':
-        case 'h':
-        case 'i':
-        case 'j':
-        case 'k':
-        case 'l':
-        case 'm':
-        case 'n':
-        case 'o':
-        case 'p':
-        case 'q':
-        case 'r':
-        case 's':
-        case 't':
-        case 'u':
-        case 'v':
-        case 'w':
-        case 'x':
-        case 'y':
-        case 'z':
-        case 'A':
-        case 'B':
-        case 'C':
-        case 'D':
-        case 'E':
-        case 'F':
-        case 'G':
-        case 'H':
-        case 'I':
-        case 'J':
-        case 'K':
-        case 'L':
-        case 'M':
-        case 'N':
-        case 'O':
-        case 'P':
-        case 'Q':
-        case 'R':
-        case 'S':
-        case 'T':
-        case 'U':
-        case 'V':
-        case 'W':
-        case 'X':
-        case 'Y':
-        case 'Z':
-        case '_':
-            return NOODLE_TRUE;
-        default:
-            return NOODLE_FALSE;
+        memset(pErrorBuffer, '\0', bufferSize);
+        bufferSize--; // Allow for at least one null-terminator
+    }
+    else
+    {
+        pErrorBuffer = NULL;
+        bufferSize = 0;
+    }
+
+    if (!pName || !noodleSharedName(NULL, pName, UINT64_MAX)) goto cleanupArgument;
+
+    NoodleAllocator_t allocator = {noodleDefaultAlloc, noodleDefaultRealloc, noodleDefaultFree, NULL};
+    if (pAllocator) allocator = *pAllocator;
+
+    NoodlePublisher_t* pPublisher = noodleAlloc(&allocator, sizeof(NoodlePublisher_t));
+    if (!pPublisher) goto cleanupMemory;
+
+    memset(pPublisher, 0, sizeof(NoodlePublisher_t));
+    pPublisher->allocator = allocator;
+    strcpy(pPublisher->pName, pName);
+
+    // A publisher that was started again carries on from the generation left
+    pPublisher->pControl = noodleSharedCreate(pName, sizeof(NoodleSharedControl_t));
+    if (!pPublisher->pControl) goto cleanupShared;
+
+    if (pPublisher->pControl->magic != NOODLE_SHARED_MAGIC)
+    {
+        pPublisher->pControl->magic = NOODLE_SHARED_MAGIC;
+        NOODLE_STORE_RELEASE64(&pPublisher->pControl->generation, 0);
     }
+
+    return pPublisher;
+
+cleanupArgument:
+    snprintf(pErrorBuffer, bufferSize, "Invalid argument!");
+    return NULL;
+
+cleanupMemory:
+    snprintf(pErrorBuffer, bufferSize, "Could not allocate memory!");
+    return NULL;
+
+cleanupShared:
+    snprintf(pErrorBuffer, bufferSize, "Could not create the shared memory \"%s\"!", pName);
+    noodleDealloc(&allocator, pPublisher);
+    return NULL;
 }
 
-NOODLE_BOOL noodleLexerIsNumber(char c)
+void noodlePublisherDestroy(NoodlePublisher_t* pPublisher)
 {
-    switch (c)
+    if (!pPublisher) return;
+
+    // What was published stays there for subscribers and later publishers
+    noodleSharedUnmap(pPublisher->pImage, pPublisher->imageSize);
+    noodleSharedUnmap(pPublisher->pControl, sizeof(NoodleSharedControl_t));
+
+    NoodleAllocator_t allocator = pPublisher->allocator;
+    noodleDealloc(&allocator, pPublisher);
+}
+
+NOODLE_BOOL noodlePublish(NoodlePublisher_t* pPublisher, const NoodleTape_t* pTape)
+{
+    assert(pPublisher);
+    assert(pTape);
+
+    uint64_t generation = NOODLE_LOAD_ACQUIRE64(&pPublisher->pControl->generation) + 1;
+
+    char pImageName[NOODLE_SHARED_NAME_MAX];
+    if (!noodleSharedName(pImageName, pPublisher->pName, generation)) return NOODLE_FALSE;
+
+    // The image is the header, then the tape with its strings right after it
+    size_t tapeSize = sizeof(NoodleTape_t) + sizeof(uint64_t) * pTape->count;
+    size_t size = sizeof(NoodleSharedImage_t) + tapeSize + pTape->stringsSize;
+
+    NoodleSharedImage_t* pImage = noodleSharedCreate(pImageName, size);
+    if (!pImage) return NOODLE_FALSE;
+
+    NoodleTape_t* pShared = (NoodleTape_t*)(pImage + 1);
+
+    memset(pShared, 0, sizeof(NoodleTape_t));
+    pShared->count = pTape->count;
+    pShared->capacity = pTape->count;
+    pShared->stringsSize = pTape->stringsSize;
+    pShared->stringsCapacity = pTape->stringsSize;
+    pShared->stringsOffset = tapeSize;
+
+    memcpy(pShared->pWords, pTape->pWords, sizeof(uint64_t) * pTape->count);
+    memcpy((char*)pShared + tapeSize, noodleTapeStrings(pTape), pTape->stringsSize);
+
+    pImage->generation = generation;
+    pImage->size = size;
+    pImage->reserved = 0;
+    pImage->magic = NOODLE_SHARED_MAGIC;
+
+    // Subscribers only look for the image once the generation says it's there
+    NOODLE_STORE_RELEASE64(&pPublisher->pControl->generation, generation);
+
+    // Subscribers that mapped the last image keep it until they move on
+    if (noodleSharedName(pImageName, pPublisher->pName, generation - 1)) noodleSharedRemove(pImageName);
+
+    noodleSharedUnmap(pPublisher->pImage, pPublisher->imageSize);
+    pPublisher->pImage = pImage;
+    pPublisher->imageSize = size;
+
+    return NOODLE_TRUE;
+}
+
+void noodleUnpublish(const char* pName)
+{
+    if (!pName || !noodleSharedName(NULL, pName, UINT64_MAX)) return;
+
+    size_t size = 0;
+    const NoodleSharedControl_t* pControl = noodleSharedOpen(pName, &size);
+
+    if (pControl && size >= sizeof(NoodleSharedControl_t))
     {
-        case '0':
-        case '1':
-        case '2':
-        case '3':
-        case '4':
-        case '5':
-        case '6':
-        case '7':
-        case '8':
-        case '9':
-        case '.':
-            return NOODLE_TRUE;
+        char pImageName[NOODLE_SHARED_NAME_MAX];
+        uint64_t generation = NOODLE_LOAD_SHARED64(&pControl->generation);
+
+        if (generation && noodleSharedName(pImageName, pName, generation)) noodleSharedRemove(pImageName);
+    }
+
+    noodleSharedUnmap(pControl, size);
+    noodleSharedRemove(pName);
+}
+
+NoodleSubscriber_t* noodleSubscribe(const char* pName, const NoodleAllocator_t* pAllocator, char* pErrorBuffer, size_t bufferSize)
+{
+    if (pErrorBuffer && bufferSize > 1 )
+    {
+        memset(pErrorBuffer, '\0', bufferSize);
+        bufferSize--; // Allow for at least one null-terminator
+    }
+    else
+    {
+        pErrorBuffer = NULL;
+        bufferSize = 0;
+    }
+
+    if (!pName || !noodleSharedName(NULL, pName, UINT64_MAX)) goto cleanupArgument;
+
+    NoodleAllocator_t allocator = {noodleDefaultAlloc, noodleDefaultRealloc, noodleDefaultFree, NULL};
+    if (pAllocator) allocator = *pAllocator;
+
+    NoodleSubscriber_t* pSubscriber = noodleAlloc(&allocator, sizeof(NoodleSubscriber_t));
+    if (!pSubscriber) goto cleanupMemory;
+
+    memset(pSubscriber, 0, sizeof(NoodleSubscriber_t));
+    pSubscriber->allocator = allocator;
+    strcpy(pSubscriber->pName, pName);
+
+    size_t size = 0;
+    pSubscriber->pControl = noodleSharedOpen(pName, &size);
+    if (!pSubscriber->pControl) goto cleanupShared;
+
+    if (size < sizeof(NoodleSharedControl_t) || pSubscriber->pControl->magic != NOODLE_SHARED_MAGIC)
+    {
+        noodleSharedUnmap(pSubscriber->pControl, size);
+        goto cleanupShared;
+    }
+
+    return pSubscriber;
+
+cleanupArgument:
+    snprintf(pErrorBuffer, bufferSize, "Invalid argument!");
+    return NULL;
+
+cleanupMemory:
+    snprintf(pErrorBuffer, bufferSize, "Could not allocate memory!");
+    return NULL;
+
+cleanupShared:
+    snprintf(pErrorBuffer, bufferSize, "Nothing is published as \"%s\"!", pName);
+    noodleDealloc(&allocator, pSubscriber);
+    return NULL;
+}
+
+void noodleUnsubscribe(NoodleSubscriber_t* pSubscriber)
+{
+    if (!pSubscriber) return;
+
+    noodleSharedUnmap(pSubscriber->pImage, pSubscriber->imageSize);
+    noodleSharedUnmap(pSubscriber->pControl, sizeof(NoodleSharedControl_t));
+
+    NoodleAllocator_t allocator = pSubscriber->allocator;
+    noodleDealloc(&allocator, pSubscriber);
+}
+
+const NoodleTape_t* noodleSubscriberTape(NoodleSubscriber_t* pSubscriber)
+{
+    assert(pSubscriber);
+
+    // Checking for a new image is a single load while nothing was published
+    for (size_t attempt = 0; attempt < NOODLE_SHARED_ATTEMPTS; attempt++)
+    {
+        uint64_t generation = NOODLE_LOAD_SHARED64(&pSubscriber->pControl->generation);
+
+        if (generation == 0 || (pSubscriber->pImage && pSubscriber->pImage->generation == generation)) break;
+
+        // Fails when the image was replaced again in the meantime, the 
+        // generation has moved on then so it's read again
+        if (noodleSubscriberMap(pSubscriber, generation)) break;
+    }
+
+    return pSubscriber->pImage ? (const NoodleTape_t*)(pSubscriber->pImage + 1) : NULL;
+}
+
+uint64_t noodleSubscriberGeneration(const NoodleSubscriber_t* pSubscriber)
+{
+    assert(pSubscriber);
+    return pSubscriber->pImage ? pSubscriber->pImage->generation : 0;
+}
+
+NoodleGroup_t* noodleOverlay(const NoodleGroup_t* const* ppLayers, size_t count, const NoodleAllocator_t* pAllocator)
+{
+    assert(ppLayers || count == 0);
+
+    NoodleAllocator_t allocator = {noodleDefaultAlloc, noodleDefaultRealloc, noodleDefaultFree, NULL};
+    if (pAllocator) allocator = *pAllocator;
+
+    NoodleOverlay_t* pOverlay = noodleAlloc(&allocator, sizeof(NoodleOverlay_t) + sizeof(NoodleGroup_t*) * count);
+    if (!pOverlay) return NULL;
+
+    memset(pOverlay, 0, sizeof(NoodleOverlay_t));
+
+    pOverlay->root.group.base.type = NOODLE_TYPE_GROUP;
+    pOverlay->root.group.overlay = NOODLE_TRUE;
+    pOverlay->root.allocator = allocator;
+    pOverlay->count = count;
+    pOverlay->ppLayers = (const NoodleGroup_t**)(pOverlay + 1);
+
+    for (size_t i = 0; i < count; i++)
+    {
+        assert(ppLayers[i] && "Layers can't be NULL!");
+        pOverlay->ppLayers[i] = ppLayers[i];
+    }
+
+    noodleMutexInit(&pOverlay->root.lock);
+
+    return &pOverlay->root.group;
+}
+
+NoodleGroup_t* noodleFlatten(const NoodleGroup_t* pGroup, const NoodleAllocator_t* pAllocator, NoodleStringTable_t* pStrings)
+{
+    assert(pGroup);
+
+    NoodleRoot_t* pRoot = noodleRoot(pAllocator, pStrings);
+    if (!pRoot) return NULL;
+
+    NoodleCopy_t copy = {pRoot, &pRoot->group};
+
+    if (!noodleVisit(pGroup, noodleVisitCopy, &copy))
+    {
+        noodleCleanup(&pRoot->group);
+        return NULL;
+    }
+
+    noodleGroupShrink(&pRoot->allocator, &pRoot->group);
+    return &pRoot->group;
+}
+
+uint64_t noodleFingerprint(const Noodle_t* pNoodle)
+{
+    assert(pNoodle);
+
+    switch (pNoodle->type)
+    {
+        case NOODLE_TYPE_GROUP:
+            return noodleGroupFingerprint((const NoodleGroup_t*)pNoodle);
+        case NOODLE_TYPE_ARRAY:
+            return noodleArrayFingerprint((const NoodleArray_t*)pNoodle);
         default:
-            return NOODLE_FALSE;
+            return noodleElementFingerprint(pNoodle->type, &((const NoodleValue_t*)pNoodle)->i);
     }
 }
 
-NOODLE_BOOL noodleLexerIsSpace(char c)
+NOODLE_BOOL noodleDiff(const NoodleGroup_t* pOld, const NoodleGroup_t* pNew, NoodleDiffCallback_t callback, void* pUser)
 {
-    switch (c)
+    assert(pOld);
+    assert(pNew);
+    assert(callback);
+
+    NoodleDiff_t diff = {callback, pUser, noodleAllocator(&pNew->base), NULL, 0, 0};
+
+    NOODLE_BOOL finished = noodleDiffGroups(&diff, pOld, pNew);
+
+    noodleDealloc(diff.pAllocator, diff.pPath);
+    return finished;
+}
+
+NoodleQuery_t* noodleQueryCompile(const char* pSelector, const NoodleAllocator_t* pAllocator, char* pErrorBuffer, size_t bufferSize)
+{
+    if (!pSelector) goto cleanupArgument;
+
+    if (pErrorBuffer && bufferSize > 1 )
+    {
+        memset(pErrorBuffer, '\0', bufferSize);
+        bufferSize--; // Allow for at least one null-terminator
+    }
+    else
+    {
+        pErrorBuffer = NULL;
+        bufferSize = 0;
+    }
+
+    NoodleAllocator_t allocator = {noodleDefaultAlloc, noodleDefaultRealloc, noodleDefaultFree, NULL};
+    if (pAllocator) allocator = *pAllocator;
+
+    // Every dot starts another step, the names need at most the selector's length
+    size_t length = strlen(pSelector);
+    size_t count = 1;
+
+    for (size_t i = 0; i < length; i++)
+        if (pSelector[i] == '.') count++;
+
+    NoodleQuery_t* pQuery = noodleAlloc(&allocator, sizeof(NoodleQuery_t) + sizeof(NoodleQueryStep_t) * count + length + 1);
+    if (!pQuery) goto cleanupMemory;
+
+    pQuery->allocator = allocator;
+    pQuery->count = 0;
+    pQuery->descents = 0;
+
+    char* pNames = (char*)(pQuery->pSteps + count);
+    const char* pErrorExpected = "Identifier, * or **";
+    size_t position = 0;
+
+    while (NOODLE_TRUE)
+    {
+        size_t start = position;
+
+        while (noodleLexerIsIdentifier(pSelector[position]))
+            position++;
+
+        NoodleQueryStep_t* pStep = &pQuery->pSteps[pQuery->count];
+
+        if (position > start)
+        {
+            memcpy(pNames, pSelector + start, position - start);
+            pNames[position - start] = '\0';
+
+            pStep->kind = NOODLE_QUERY_STEP_KEY;
+            pStep->pName = pNames;
+            pStep->hash = noodleGroupHashFunction(pNames);
+
+            pNames += position - start + 1;
+        }
+        else if (pSelector[position] == '*' && pSelector[position + 1] == '*')
+        {
+            position += 2;
+            pStep->kind = NOODLE_QUERY_STEP_DESCENDANTS;
+            pStep->pName = NULL;
+            pStep->hash = 0;
+        }
+        else if (pSelector[position] == '*')
+        {
+            position++;
+            pStep->kind = NOODLE_QUERY_STEP_ANY;
+            pStep->pName = NULL;
+            pStep->hash = 0;
+        }
+        else
+        {
+            goto cleanupSelector;
+        }
+
+        // Repeated ** match the same paths as one but find each match twice
+        NOODLE_BOOL repeated = pQuery->count > 0 && pStep->kind == NOODLE_QUERY_STEP_DESCENDANTS && pStep[-1].kind == NOODLE_QUERY_STEP_DESCENDANTS;
+        if (!repeated) 
+        {
+            if (pStep->kind == NOODLE_QUERY_STEP_DESCENDANTS) pQuery->descents++;
+            pQuery->count++;
+        }
+
+        if (pSelector[position] == '\0') break;
+
+        if (pSelector[position] != '.')
+        {
+            pErrorExpected = ".";
+            goto cleanupSelector;
+        }
+
+        position++;
+    }
+
+    // ** only walks groups, something has to follow it to be matched
+    if (pQuery->pSteps[pQuery->count - 1].kind == NOODLE_QUERY_STEP_DESCENDANTS)
+    {
+        pErrorExpected = ".";
+        goto cleanupSelector;
+    }
+
+    return pQuery;
+
+cleanupArgument:
+    snprintf(pErrorBuffer, bufferSize, "Invalid argument!");
+    return NULL;
+
+cleanupMemory:
+    snprintf(pErrorBuffer, bufferSize, "Could not allocate memory!");
+    return NULL;
+
+cleanupSelector:
+    if (pSelector[position] == '\0')
+        snprintf(pErrorBuffer, bufferSize, "(Col %zu) Unexpected end of selector, expected \"%s\"!", position, pErrorExpected);
+    else
+        snprintf(pErrorBuffer, bufferSize, "(Col %zu) Unexpected character found, \"%c\", expected \"%s\"!", position, pSelector[position], pErrorExpected);
+    noodleDealloc(&allocator, pQuery);
+    return NULL;
+}
+
+size_t noodleQueryRun(const NoodleQuery_t* pQuery, const NoodleGroup_t* pGroup, Noodle_t** ppResults, size_t capacity)
+{
+    assert(pQuery);
+    assert(pGroup);
+    assert(ppResults || capacity == 0);
+
+    NoodleQueryRun_t run = {pQuery, ppResults, capacity, 0, NULL, 0, 0, NOODLE_FALSE};
+    noodleQueryMatch(&run, pGroup, 0);
+
+    noodleDealloc(&pQuery->allocator, run.pVisits);
+
+    return run.failed ? SIZE_MAX : run.count;
+}
+
+void noodleQueryCleanup(NoodleQuery_t* pQuery)
+{
+    if (!pQuery) return;
+
+    NoodleAllocator_t allocator = pQuery->allocator;
+    noodleDealloc(&allocator, pQuery);
+}
+
+NOODLE_BOOL noodleToJson(const char* pContent, size_t length, NoodleWriteFunction_t write, void* pUser, char* pErrorBuffer, size_t bufferSize)
+{
+    if (!pContent || !write) goto cleanupArgument;
+
+    if (pErrorBuffer && bufferSize > 1 )
+    {
+        memset(pErrorBuffer, '\0', bufferSize);
+        bufferSize--; // Allow for at least one null-terminator
+    }
+    else
+    {
+        pErrorBuffer = NULL;
+        bufferSize = 0;
+    }
+
+    NoodleWriter_t writer;
+    writer.write = write;
+    writer.pUser = pUser;
+    writer.size = 0;
+    writer.failed = NOODLE_FALSE;
+
+    // Follows the same grammar as noodleValidate, every token is written out
+    // as soon as it's read so only the depth of the groups is kept
+    NoodleLexer_t lexer = noodleLexer(pContent, noodleContentLength(pContent, length));
+    NoodleToken_t token = {0};
+    const char* pErrorExpected = "";
+    size_t depth = 0;
+    NOODLE_BOOL separate = NOODLE_FALSE; // The next key needs a comma before it
+
+    noodleWriterPut(&writer, "{", 1);
+    noodleLexerNextToken(&lexer, &token);
+
+    while (token.kind != NOODLE_TOKEN_KIND_END)
+    {
+        if (token.kind != NOODLE_TOKEN_KIND_IDENTIFIER)
+        {
+            pErrorExpected = "Identifier";
+            goto cleanupParse;
+        }
+
+        // Included files would have to be parsed, which can't be done in bounded memory
+        if (noodleParseIncludeDirective(&lexer, &token)) goto cleanupInclude;
+
+        if (separate) noodleWriterPut(&writer, ",", 1);
+
+        noodleWriterPut(&writer, "\"", 1);
+        noodleWriterPut(&writer, pContent + token.start, token.end - token.start);
+        noodleWriterPut(&writer, "\":", 2);
+
+        noodleLexerNextToken(&lexer, &token);
+
+        if (token.kind != NOODLE_TOKEN_KIND_EQUAL)
+        {
+            pErrorExpected = "Equals Symbol";
+            goto cleanupParse;
+        }
+
+        noodleLexerNextToken(&lexer, &token);
+        separate = NOODLE_TRUE;
+
+        switch (token.kind)
+        {
+            case NOODLE_TOKEN_KIND_LEFTCURLY:
+                noodleWriterPut(&writer, "{", 1);
+                separate = NOODLE_FALSE;
+                depth++;
+                break;
+            case NOODLE_TOKEN_KIND_INTEGER:
+            case NOODLE_TOKEN_KIND_FLOAT:
+                noodleJsonPutNumber(&writer, pContent + token.start, token.end - token.start);
+                break;
+            case NOODLE_TOKEN_KIND_BOOLEAN:
+                noodleWriterPut(&writer, pContent + token.start, token.end - token.start);
+                break;
+            case NOODLE_TOKEN_KIND_STRING:
+                noodleJsonPutString(&writer, pContent + token.start, token.end - token.start);
+                break;
+            case NOODLE_TOKEN_KIND_LEFTBRACKET:
+            {
+                noodleLexerNextToken(&lexer, &token);
+
+                if (token.kind != NOODLE_TOKEN_KIND_INTEGER && 
+                    token.kind != NOODLE_TOKEN_KIND_FLOAT &&
+                    token.kind != NOODLE_TOKEN_KIND_BOOLEAN &&
+                    token.kind != NOODLE_TOKEN_KIND_STRING)
+                {
+                    pErrorExpected = "Integer, Float, Boolean, or String";
+                    goto cleanupParse;
+                }
+
+                NoodleTokenKind_t expected = token.kind;
+                noodleWriterPut(&writer, "[", 1);
+
+                for (size_t count = 0; token.kind != NOODLE_TOKEN_KIND_RIGHTBRACKET; count++)
+                {
+                    if (token.kind != expected)
+                    {
+                        pErrorExpected = noodleStringFromTokenKind(expected);
+                        goto cleanupParse;
+                    }
+
+                    if (count) noodleWriterPut(&writer, ",", 1);
+
+                    if (expected == NOODLE_TOKEN_KIND_STRING)
+                        noodleJsonPutString(&writer, pContent + token.start, token.end - token.start);
+                    else if (expected == NOODLE_TOKEN_KIND_BOOLEAN)
+                        noodleWriterPut(&writer, pContent + token.start, token.end - token.start);
+                    else
+                        noodleJsonPutNumber(&writer, pContent + token.start, token.end - token.start);
+
+                    noodleLexerNextToken(&lexer, &token);
+
+                    if (token.kind == NOODLE_TOKEN_KIND_COMMA)
+                        noodleLexerNextToken(&lexer, &token);
+                }
+
+                noodleWriterPut(&writer, "]", 1);
+                break;
+            }
+            default:
+                pErrorExpected = "Value";
+                goto cleanupParse;
+        }
+
+        noodleLexerNextToken(&lexer, &token);
+
+        if (token.kind == NOODLE_TOKEN_KIND_COMMA)
+        {
+            noodleLexerNextToken(&lexer, &token);
+
+            if (token.kind != NOODLE_TOKEN_KIND_RIGHTCURLY)
+                continue;
+        }
+
+        while (token.kind == NOODLE_TOKEN_KIND_RIGHTCURLY)
+        {
+            if (depth == 0)
+            {
+                pErrorExpected = "Identifier";
+                goto cleanupParse;
+            }
+
+            noodleWriterPut(&writer, "}", 1);
+            separate = NOODLE_TRUE;
+            depth--;
+
+            noodleLexerNextToken(&lexer, &token);
+        }
+    }
+
+    // Groups left open at the end are closed, like the parsers do
+    for (; depth > 0; depth--)
+        noodleWriterPut(&writer, "}", 1);
+
+    noodleWriterPut(&writer, "}\n", 2);
+    noodleWriterFlush(&writer);
+
+    if (writer.failed) goto cleanupWrite;
+
+    return NOODLE_TRUE;
+
+cleanupArgument:
+    snprintf(pErrorBuffer, bufferSize, "Invalid argument!");
+    return NOODLE_FALSE;
+
+cleanupParse:
+    snprintf(pErrorBuffer, bufferSize, "(Ln %zu, Col %zu) Unexpected token found, \"%.*s\", expected token, \"%s\"!", lexer.line, lexer.character, noodleTokenPrintLength(&token), pContent + token.start, pErrorExpected);
+    return NOODLE_FALSE;
+
+cleanupInclude:
+    snprintf(pErrorBuffer, bufferSize, "(Ln %zu, Col %zu) Could not include \"%.*s\", includes can't be converted!", lexer.line, lexer.character, noodleTokenPrintLength(&token), pContent + token.start);
+    return NOODLE_FALSE;
+
+cleanupWrite:
+    snprintf(pErrorBuffer, bufferSize, "Could not write output!");
+    return NOODLE_FALSE;
+}
+
+NOODLE_BOOL noodleFromJson(const char* pContent, size_t length, NoodleWriteFunction_t write, void* pUser, char* pErrorBuffer, size_t bufferSize)
+{
+    if (!pContent || !write) goto cleanupArgument;
+
+    if (pErrorBuffer && bufferSize > 1 )
+    {
+        memset(pErrorBuffer, '\0', bufferSize);
+        bufferSize--; // Allow for at least one null-terminator
+    }
+    else
+    {
+        pErrorBuffer = NULL;
+        bufferSize = 0;
+    }
+
+    NoodleWriter_t writer;
+    writer.write = write;
+    writer.pUser = pUser;
+    writer.size = 0;
+    writer.failed = NOODLE_FALSE;
+
+    // Noodle arrays only hold scalars, so objects are the only thing that 
+    // nests and their depth is all that's kept
+    const char* pErrorExpected = "";
+    size_t depth = 0;
+    size_t position = noodleJsonSkipSpaces(pContent, length, 0);
+    NOODLE_BOOL separate = NOODLE_FALSE; // The next member needs a comma before it
+
+    if (noodleJsonPeek(pContent, length, position) != '{')
+    {
+        pErrorExpected = "{";
+        goto cleanupParse;
+    }
+
+    position++;
+
+    for (;;)
+    {
+        position = noodleJsonSkipSpaces(pContent, length, position);
+        char c = noodleJsonPeek(pContent, length, position);
+
+        if (c == '}')
+        {
+            position++;
+            if (depth == 0) break;
+
+            depth--;
+            noodleWriterIndent(&writer, depth);
+            noodleWriterPut(&writer, "}\n", 2);
+            separate = NOODLE_TRUE;
+            continue;
+        }
+
+        if (separate)
+        {
+            if (c != ',')
+            {
+                pErrorExpected = ", or }";
+                goto cleanupParse;
+            }
+
+            position = noodleJsonSkipSpaces(pContent, length, position + 1);
+            c = noodleJsonPeek(pContent, length, position);
+        }
+
+        if (c != '\"')
+        {
+            pErrorExpected = "Key";
+            goto cleanupParse;
+        }
+
+        // Keys become identifiers, so they can only hold letters and underscores
+        size_t keyStart = ++position;
+
+        while (noodleLexerIsIdentifier(noodleJsonPeek(pContent, length, position)))
+            position++;
+
+        if (position == keyStart || noodleJsonPeek(pContent, length, position) != '\"')
+        {
+            pErrorExpected = "Key of letters and underscores";
+            goto cleanupParse;
+        }
+
+        size_t keyEnd = position;
+        position = noodleJsonSkipSpaces(pContent, length, position + 1);
+
+        if (noodleJsonPeek(pContent, length, position) != ':')
+        {
+            pErrorExpected = ":";
+            goto cleanupParse;
+        }
+
+        position = noodleJsonSkipSpaces(pContent, length, position + 1);
+        c = noodleJsonPeek(pContent, length, position);
+
+        noodleWriterIndent(&writer, depth);
+        noodleWriterPut(&writer, pContent + keyStart, keyEnd - keyStart);
+        noodleWriterPut(&writer, " = ", 3);
+
+        separate = NOODLE_TRUE;
+
+        if (c == '{')
+        {
+            noodleWriterPut(&writer, "{\n", 2);
+            separate = NOODLE_FALSE;
+            position++;
+            depth++;
+            continue;
+        }
+
+        if (c != '[')
+        {
+            NoodleType_t type;
+            if (!noodleJsonValue(&writer, pContent, length, &position, NOODLE_FALSE, &type, &pErrorExpected)) goto cleanupParse;
+
+            noodleWriterPut(&writer, "\n", 1);
+            continue;
+        }
+
+        position = noodleJsonSkipSpaces(pContent, length, position + 1);
+        c = noodleJsonPeek(pContent, length, position);
+
+        if (c == ']')
+        {
+            pErrorExpected = "Value, noodle arrays can't be empty";
+            goto cleanupParse;
+        }
+
+        // Noodle arrays hold a single type, integers are widened when any 
+        // number in the array is a float
+        NOODLE_BOOL asFloat = NOODLE_FALSE;
+
+        if (c >= '0' && c <= '9')
+        {
+            // Searched with memchr, it's much faster than a loop over every
+            // character. A ] inside a string would end it early, but then
+            // the array mixes types and is an error anyway.
+            const char* pEnd = memchr(pContent + position, ']', length - position);
+            size_t span = pEnd ? (size_t)(pEnd - (pContent + position)) : length - position;
+
+            asFloat = memchr(pContent + position, '.', span) || 
+                memchr(pContent + position, 'e', span) || 
+                memchr(pContent + position, 'E', span);
+        }
+
+        NoodleType_t expected = NOODLE_TYPE_GROUP; // Nothing yet
+        noodleWriterPut(&writer, "[", 1);
+
+        for (size_t count = 0;; count++)
+        {
+            if (count) noodleWriterPut(&writer, ", ", 2);
+
+            NoodleType_t type;
+            size_t start = position;
+            if (!noodleJsonValue(&writer, pContent, length, &position, asFloat, &type, &pErrorExpected)) goto cleanupParse;
+
+            if (count && type != expected)
+            {
+                position = start;
+                pErrorExpected = "Value of the same type, noodle arrays hold a single type";
+                goto cleanupParse;
+            }
+
+            expected = type;
+            position = noodleJsonSkipSpaces(pContent, length, position);
+            c = noodleJsonPeek(pContent, length, position);
+
+            if (c == ']') break;
+
+            if (c != ',')
+            {
+                pErrorExpected = ", or ]";
+                goto cleanupParse;
+            }
+
+            position = noodleJsonSkipSpaces(pContent, length, position + 1);
+        }
+
+        noodleWriterPut(&writer, "]\n", 2);
+        position++;
+    }
+
+    position = noodleJsonSkipSpaces(pContent, length, position);
+
+    if (noodleJsonPeek(pContent, length, position) != '\0')
+    {
+        pErrorExpected = "End";
+        goto cleanupParse;
+    }
+
+    noodleWriterFlush(&writer);
+    if (writer.failed) goto cleanupWrite;
+
+    return NOODLE_TRUE;
+
+cleanupArgument:
+    snprintf(pErrorBuffer, bufferSize, "Invalid argument!");
+    return NOODLE_FALSE;
+
+cleanupParse:
+{
+    size_t line = 0;
+    size_t character = 0;
+
+    for (size_t i = 0; i < position && i < length && pContent[i]; i++)
+    {
+        if (pContent[i] == '\n')
+        {
+            line++;
+            character = 0;
+        }
+        else
+        {
+            character++;
+        }
+    }
+
+    char c = noodleJsonPeek(pContent, length, position);
+
+    if (c == '\0')
+        snprintf(pErrorBuffer, bufferSize, "(Ln %zu, Col %zu) Unexpected end of content, expected \"%s\"!", line, character, pErrorExpected);
+    else
+        snprintf(pErrorBuffer, bufferSize, "(Ln %zu, Col %zu) Unexpected character found, \"%c\", expected \"%s\"!", line, character, c, pErrorExpected);
+    return NOODLE_FALSE;
+}
+
+cleanupWrite:
+    snprintf(pErrorBuffer, bufferSize, "Could not write output!");
+    return NOODLE_FALSE;
+}
+
+void noodleIncludeCacheClear(void)
+{
+    noodleMutexLock(&gNoodleIncludeLock);
+
+    NoodleInclude_t* pInclude = gpNoodleIncludes;
+    gpNoodleIncludes = NULL;
+
+    noodleMutexUnlock(&gNoodleIncludeLock);
+
+    // Files still included by a document stay alive until it's cleaned up
+    while (pInclude)
+    {
+        NoodleInclude_t* pNext = pInclude->pNext;
+        noodleIncludeRelease(pInclude);
+        pInclude = pNext;
+    }
+}
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+// HELPER FUNCTION DEFINITIONS
+////////////////////////////////////////////////////////////////////////////////
+
+
+
+void* noodleDefaultAlloc(void* pUser, size_t size)
+{
+    (void)pUser;
+    return NOODLE_MALLOC(size);
+}
+
+void* noodleDefaultRealloc(void* pUser, void* pMemory, size_t size)
+{
+    (void)pUser;
+    return NOODLE_REALLOC(pMemory, size);
+}
+
+void noodleDefaultFree(void* pUser, void* pMemory)
+{
+    (void)pUser;
+    NOODLE_FREE(pMemory);
+}
+
+void* noodleAlloc(const NoodleAllocator_t* pAllocator, size_t size)
+{
+    assert(pAllocator);
+    return pAllocator->pfnAlloc(pAllocator->pUser, size);
+}
+
+void* noodleRealloc(const NoodleAllocator_t* pAllocator, void* pMemory, size_t size)
+{
+    assert(pAllocator);
+    return pAllocator->pfnRealloc(pAllocator->pUser, pMemory, size);
+}
+
+void noodleDealloc(const NoodleAllocator_t* pAllocator, void* pMemory)
+{
+    assert(pAllocator);
+    if (pMemory) pAllocator->pfnFree(pAllocator->pUser, pMemory);
+}
+
+char* noodleStringDuplicate(const NoodleAllocator_t* pAllocator, const char* pStr)
+{
+    size_t length = strlen(pStr) + 1;
+    char* pNewStr = noodleAlloc(pAllocator, length);
+
+    if (pNewStr == NULL)
+        return NULL;
+
+    return memcpy(pNewStr, pStr, length);
+}
+
+double noodleTimeNow(void)
+{
+#ifdef _WIN32
+    LARGE_INTEGER frequency, counter;
+    QueryPerformanceFrequency(&frequency);
+    QueryPerformanceCounter(&counter);
+
+    return (double)counter.QuadPart / (double)frequency.QuadPart;
+#else
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return (double)now.tv_sec + (double)now.tv_nsec * 1e-9;
+#endif
+}
+
+const char* noodleStringFromTokenKind(NoodleTokenKind_t kind)
+{
+    switch (kind)
+    {
+        case NOODLE_TOKEN_KIND_IDENTIFIER: return "Identifier"; 
+        case NOODLE_TOKEN_KIND_INTEGER: return "Integer"; 
+        case NOODLE_TOKEN_KIND_FLOAT: return "Float"; 
+        case NOODLE_TOKEN_KIND_BOOLEAN: return "Boolean"; 
+        case NOODLE_TOKEN_KIND_STRING: return "String"; 
+        case NOODLE_TOKEN_KIND_LEFTCURLY: return "Left Curly"; 
+        case NOODLE_TOKEN_KIND_RIGHTCURLY: return "Right Curly"; 
+        case NOODLE_TOKEN_KIND_LEFTBRACKET: return "Left Bracket"; 
+        case NOODLE_TOKEN_KIND_RIGHTBRACKET: return "Right Bracket"; 
+        case NOODLE_TOKEN_KIND_EQUAL: return "Equal"; 
+        case NOODLE_TOKEN_KIND_COMMA: return "Comma"; 
+        case NOODLE_TOKEN_KIND_END: return "End"; 
+        case NOODLE_TOKEN_KIND_COMMENT: return "Comment"; 
+        case NOODLE_TOKEN_KIND_NEWLINE: return "Newline"; 
+        
+        default:
+        case NOODLE_TOKEN_KIND_UNEXPECTED: return "Unexpected"; 
+    }
+}
+
+NoodleToken_t noodleToken(NoodleTokenKind_t kind, size_t start, size_t end)
+{
+    return (NoodleToken_t){kind, start, end, NOODLE_FALSE};
+}
+
+int noodleTokenPrintLength(const NoodleToken_t* pToken)
+{
+    // The end of bounded content has no text, what follows belongs to something else
+    if (pToken->kind == NOODLE_TOKEN_KIND_END) return 0;
+
+    // Tokens can be longer than printf's precision allows
+    size_t length = pToken->end - pToken->start;
+    return length > INT_MAX ? INT_MAX : (int)length;
+}
+
+int noodleParseInt(const NoodleLexer_t* pLexer, const NoodleToken_t* pToken)
+{
+    assert(pLexer);
+    assert(pToken);
+    assert(pToken->kind == NOODLE_TOKEN_KIND_INTEGER);
+
+    // Content is bounded by its length rather than terminated, so strtol gets a copy of just the token
+    char pNumber[NOODLE_NUMBER_MAX_LENGTH];
+    noodleTokenCopy(pLexer, pToken, pNumber);
+
+    return (int)strtol(pNumber, NULL, 10);
+}
+
+float noodleParseFloat(const NoodleLexer_t* pLexer, const NoodleToken_t* pToken)
+{
+    assert(pLexer);
+    assert(pToken);
+    assert(pToken->kind == NOODLE_TOKEN_KIND_FLOAT);
+
+    char pNumber[NOODLE_NUMBER_MAX_LENGTH];
+    noodleTokenCopy(pLexer, pToken, pNumber);
+
+    return strtof(pNumber, NULL);
+}
+
+void noodleTokenCopy(const NoodleLexer_t* pLexer, const NoodleToken_t* pToken, char* pNumber)
+{
+    // The lexer doesn't make number tokens longer than the buffer
+    size_t length = pToken->end - pToken->start;
+    assert(length < NOODLE_NUMBER_MAX_LENGTH);
+
+    memcpy(pNumber, pLexer->pContent + pToken->start, length);
+    pNumber[length] = '\0';
+}
+
+NOODLE_BOOL noodleParseBool(const NoodleLexer_t* pLexer, const NoodleToken_t* pToken)
+{
+    assert(pLexer);
+    assert(pToken);
+    assert(pToken->kind == NOODLE_TOKEN_KIND_BOOLEAN);
+    
+    return (*(pLexer->pContent + pToken->start) == 't') ? NOODLE_TRUE : NOODLE_FALSE;   
+}
+
+char* noodleParseString(const NoodleAllocator_t* pAllocator, const NoodleLexer_t* pLexer, const NoodleToken_t* pToken)
+{
+    // Need to allocate a new string, escapes only ever make it shorter
+    size_t stringLength = pToken->end - pToken->start; // Convert indexes into counts
+    char* pString = noodleAlloc(pAllocator, stringLength + 1);
+    if (!pString) return NULL;
+
+    // The lexer already checked the escapes, strings without any are copied as they are
+    if (pToken->escaped)
+        stringLength = noodleStringDecode(pLexer->pContent + pToken->start, stringLength, pString);
+    else
+        memcpy(pString, pLexer->pContent + pToken->start, stringLength);
+
+    pString[stringLength] = '\0';
+
+    return pString;
+}
+
+Noodle_t* noodleParseValue(const NoodleAllocator_t* pAllocator, NoodleLexer_t* pLexer, NoodleToken_t* pToken, NoodleParseStats_t* pStats, char* pIdentifier, NoodleGroup_t* pParent, const char** ppErrorExpected)
+{
+    // Groups are left to the caller, how they are built depends on the parser
+    Noodle_t* pNewNoodle = NULL;
+    *ppErrorExpected = NULL;
+
+    switch (pToken->kind)
+    {
+        case NOODLE_TOKEN_KIND_INTEGER:
+            pNewNoodle = (Noodle_t*)noodleInt(pAllocator, pIdentifier, noodleParseInt(pLexer, pToken), pParent);
+            break;
+        case NOODLE_TOKEN_KIND_FLOAT:
+            pNewNoodle = (Noodle_t*)noodleFloat(pAllocator, pIdentifier, noodleParseFloat(pLexer, pToken), pParent);
+            break;
+        case NOODLE_TOKEN_KIND_BOOLEAN:
+            pNewNoodle = (Noodle_t*)noodleBool(pAllocator, pIdentifier, noodleParseBool(pLexer, pToken), pParent);
+            break;
+        case NOODLE_TOKEN_KIND_STRING:
+        {
+            char* pString = noodleParseString(pAllocator, pLexer, pToken);
+            if (!pString) return NULL;
+
+            pNewNoodle = (Noodle_t*)noodleString(pAllocator, pIdentifier, pString, pParent);
+            if (!pNewNoodle) noodleDealloc(pAllocator, pString);
+            break;
+        }
+        case NOODLE_TOKEN_KIND_LEFTBRACKET:
+        {
+            size_t arrayStart = pToken->start;
+
+            // Get the next token to get it's type and ensure it can be in an array 
+            noodleParseNextToken(pLexer, pToken, pStats);
+
+            if (pToken->kind != NOODLE_TOKEN_KIND_INTEGER && 
+                pToken->kind != NOODLE_TOKEN_KIND_FLOAT &&
+                pToken->kind != NOODLE_TOKEN_KIND_BOOLEAN &&
+                pToken->kind != NOODLE_TOKEN_KIND_STRING)
+            {
+                *ppErrorExpected = "Integer, Float, Boolean, or String";
+                return NULL;
+            }
+
+            // Get the next few tokens until the end of the array
+            NoodleTokenKind_t expected = pToken->kind;
+            
+            NoodleArray_t* pArray = noodleArray(pAllocator, pIdentifier, NOODLE_TYPE_ARRAY, pParent);
+            if (!pArray) return NULL;
+
+            // Loop through all the tokens of the array to get the count and verification of type
+            while (pToken->kind != NOODLE_TOKEN_KIND_RIGHTBRACKET)
+            {
+                // Make sure that the token is the one we expect in the array
+                if (pToken->kind != expected)
+                {
+                    *ppErrorExpected = noodleStringFromTokenKind(expected);
+                    return NULL;
+                }
+
+                pArray->count++;
+
+                // Expect a ',' or a ']'
+                noodleParseNextToken(pLexer, pToken, pStats);
+
+                if (pToken->kind == NOODLE_TOKEN_KIND_COMMA)
+                {
+                    noodleParseNextToken(pLexer, pToken, pStats);
+                    continue;
+                }
+            }
+
+            // Kinda hacky but reset the lexer back to the array start position
+            pLexer->current = arrayStart;
+
+            // Allocate the array of values
+            switch (expected)
+            {
+                case NOODLE_TOKEN_KIND_INTEGER:
+                    pArray->type = NOODLE_TYPE_INTEGER;
+                    pArray->pIntegers = noodleAlloc(pAllocator, sizeof(int) * pArray->count);
+                    break;
+
+                case NOODLE_TOKEN_KIND_FLOAT:
+                    pArray->type = NOODLE_TYPE_FLOAT;
+                    pArray->pFloats = noodleAlloc(pAllocator, sizeof(float) * pArray->count);
+                    break;
+
+                case NOODLE_TOKEN_KIND_BOOLEAN:
+                    pArray->type = NOODLE_TYPE_BOOLEAN;
+                    pArray->pBooleans = noodleAlloc(pAllocator, sizeof(NOODLE_BOOL) * pArray->count);
+                    break;
+
+                case NOODLE_TOKEN_KIND_STRING:
+                    pArray->type = NOODLE_TYPE_STRING;
+                    pArray->ppStrings = noodleAlloc(pAllocator, sizeof(char*) * pArray->count);
+                    if (pArray->ppStrings) memset(pArray->ppStrings, 0, sizeof(char*) * pArray->count);
+                    break;
+            }
+
+            // Check if the array was allocated correctly using ints value of the union 
+            if (!pArray->pIntegers) return NULL;
+
+            // Iterate through the values once again, to set the array
+            noodleParseNextToken(pLexer, pToken, pStats);
+
+            size_t i = 0;
+            while (pToken->kind != NOODLE_TOKEN_KIND_RIGHTBRACKET)
+            {
+                switch (expected)
+                {
+                    case NOODLE_TOKEN_KIND_INTEGER:
+                        pArray->pIntegers[i] = noodleParseInt(pLexer, pToken);
+                        break;
+                    case NOODLE_TOKEN_KIND_FLOAT:
+                        pArray->pFloats[i] = noodleParseFloat(pLexer, pToken);
+                        break;
+                    case NOODLE_TOKEN_KIND_BOOLEAN:
+                        pArray->pBooleans[i] = noodleParseBool(pLexer, pToken); 
+                        break;
+                    case NOODLE_TOKEN_KIND_STRING:
+                    {
+                        char* pString = noodleParseString(pAllocator, pLexer, pToken);
+                        if (!pString) return NULL;
+
+                        pArray->ppStrings[i] = pString;
+                        break;
+                    }
+                }
+
+                i++;
+
+                noodleParseNextToken(pLexer, pToken, pStats);
+                
+                if (pToken->kind == NOODLE_TOKEN_KIND_COMMA)
+                {
+                    noodleParseNextToken(pLexer, pToken, pStats);
+                    continue;
+                }
+            }
+
+            pNewNoodle = (Noodle_t*)pArray;
+            break;
+        }
+        default:
+            *ppErrorExpected = "Value";
+            return NULL;
+    }
+
+    // NULL without an expected token means an allocation failed
+    return pNewNoodle;
+}
+
+NoodleRoot_t* noodleRoot(const NoodleAllocator_t* pAllocator, NoodleStringTable_t* pStrings)
+{
+    NoodleAllocator_t allocator = {noodleDefaultAlloc, noodleDefaultRealloc, noodleDefaultFree, NULL};
+    if (pAllocator) allocator = *pAllocator;
+
+    assert(allocator.pfnAlloc && allocator.pfnRealloc && allocator.pfnFree);
+
+    NoodleRoot_t* pRoot = noodleAlloc(&allocator, sizeof(NoodleRoot_t));
+    if (!pRoot) return NULL;
+
+    memset(pRoot, 0, sizeof(NoodleRoot_t));
+
+    pRoot->group.base.type = NOODLE_TYPE_GROUP;
+    pRoot->allocator = allocator;
+
+    if (pStrings)
+    {
+        NOODLE_INCREMENT(&pStrings->references);
+        pRoot->pStrings = pStrings;
+        pRoot->sharedStrings = NOODLE_TRUE;
+        return pRoot;
+    }
+
+    pRoot->pStrings = noodleStringTableCreate(&allocator);
+    if (!pRoot->pStrings)
+    {
+        noodleDealloc(&allocator, pRoot);
+        return NULL;
+    }
+
+    return pRoot;
+}
+
+NoodleGroup_t* noodleGroup(const NoodleAllocator_t* pAllocator, char* pName, NoodleGroup_t* pParent)
+{
+    // Allocate the group and cast to the noodle base composition
+    NoodleGroup_t* pGroup = noodleAlloc(pAllocator, sizeof(NoodleGroup_t));
+    Noodle_t* pNoodle = (Noodle_t*)pGroup;
+    if (!pGroup)
+    {
+        return NULL;
+    }
+
+    memset(pGroup, 0, sizeof(NoodleGroup_t));
+
+    // Set the values
+    pNoodle->pName = pName;
+    pNoodle->pParent = pParent;
+    pNoodle->type = NOODLE_TYPE_GROUP;
+
+    // Link the group into its parent's entries
+    NoodleValue_t* pEntry = noodleGroupInsert(pAllocator, pParent, pName, NOODLE_TYPE_GROUP);
+    if (!pEntry)
+    {
+        noodleDealloc(pAllocator, pGroup);
+        return NULL;
+    }
+
+    pEntry->pChild = pNoodle;
+
+    return pGroup;
+}
+
+NoodleArray_t* noodleArray(const NoodleAllocator_t* pAllocator, char* pName, NoodleType_t type, NoodleGroup_t* pParent)
+{
+    assert(pName);
+
+    NoodleArray_t* pArray = noodleAlloc(pAllocator, sizeof(NoodleArray_t));
+    Noodle_t* pNoodle = (Noodle_t*)pArray;
+    if (!pArray)
+    {
+        return NULL;
+    }
+
+    pNoodle->pName = pName;
+    pNoodle->pParent = pParent;
+    pNoodle->type = NOODLE_TYPE_ARRAY;
+    pArray->type = type;
+    pArray->count = 0;
+    pArray->pIntegers = NULL;
+
+    NoodleValue_t* pEntry = noodleGroupInsert(pAllocator, pParent, pName, NOODLE_TYPE_ARRAY);
+    if (!pEntry)
+    {
+        noodleDealloc(pAllocator, pArray);
+        return NULL;
+    }
+
+    pEntry->pChild = pNoodle;
+
+    return pArray;
+}
+
+NoodleValue_t* noodleValue(const NoodleAllocator_t* pAllocator, char* pName, NoodleType_t type, NoodleGroup_t* pParent)
+{
+    assert(pName);
+
+    // Values live inline inside of their parent's entries
+    return noodleGroupInsert(pAllocator, pParent, pName, type);
+}
+
+NoodleValue_t* noodleInt(const NoodleAllocator_t* pAllocator, char* pName, int value, NoodleGroup_t* pParent)
+{
+    assert(pName);
+
+    NoodleValue_t* pValue = noodleValue(pAllocator, pName, NOODLE_TYPE_INTEGER, pParent);
+    if (!pValue) return NULL;
+
+    pValue->i = value;
+
+    return pValue;
+}
+
+NoodleValue_t* noodleFloat(const NoodleAllocator_t* pAllocator, char* pName, float value, NoodleGroup_t* pParent)
+{
+    assert(pName);
+
+    NoodleValue_t* pValue = noodleValue(pAllocator, pName, NOODLE_TYPE_FLOAT, pParent);
+    if (!pValue) return NULL;
+
+    pValue->f = value;
+
+    return pValue;
+}
+
+NoodleValue_t* noodleBool(const NoodleAllocator_t* pAllocator, char* pName, NOODLE_BOOL value, NoodleGroup_t* pParent)
+{
+    assert(pName);
+
+    NoodleValue_t* pValue = noodleValue(pAllocator, pName, NOODLE_TYPE_BOOLEAN, pParent);
+    if (!pValue) return NULL;
+
+    pValue->b = value;
+
+    return pValue;
+}
+
+NoodleValue_t* noodleString(const NoodleAllocator_t* pAllocator, char* pName, char* pStrValue, NoodleGroup_t* pParent)
+{
+    assert(pName);
+
+    NoodleValue_t* pValue = noodleValue(pAllocator, pName, NOODLE_TYPE_STRING, pParent);
+    if (!pValue) return NULL;
+
+    pValue->s = pStrValue;
+
+    return pValue;
+}
+
+size_t noodleGroupHashFunction(const char* pName)
+{
+    // Implementation of sdbm
+    size_t hash = 0;
+    int c;
+
+    while (c = *pName++)
+        hash = c + (hash << 6) + (hash << 16) - hash;
+
+    return hash;
+}
+
+size_t noodleHashBytes(const char* pBytes, size_t length)
+{
+    // Same sdbm as noodleGroupHashFunction but over a length instead of a null-terminator
+    size_t hash = 0;
+
+    for (size_t i = 0; i < length; i++)
+        hash = pBytes[i] + (hash << 6) + (hash << 16) - hash;
+
+    return hash;
+}
+
+NoodleString_t* noodleStringHeader(const char* pName)
+{
+    return (NoodleString_t*)(pName - offsetof(NoodleString_t, pData));
+}
+
+char* noodleStringTableFind(const NoodleStringTable_t* pStrings, const char* pStr, size_t length, size_t hash)
+{
+    assert(pStrings);
+
+    if (!pStrings->capacity) return NULL;
+
+    size_t mask = pStrings->capacity - 1;
+
+    for (size_t i = hash & mask; pStrings->ppSlots[i]; i = (i + 1) & mask)
+    {
+        NoodleString_t* pString = pStrings->ppSlots[i];
+
+        if (pString->hash == hash && pString->length == length && memcmp(pString->pData, pStr, length) == 0)
+            return pString->pData;
+    }
+
+    return NULL;
+}
+
+char* noodleStringTableIntern(NoodleStringTable_t* pStrings, const char* pStr, size_t length)
+{
+    assert(pStrings);
+    assert(pStr);
+
+    size_t hash = noodleHashBytes(pStr, length);
+
+    char* pFound = noodleStringTableFind(pStrings, pStr, length, hash);
+    if (pFound) return pFound;
+
+    // Keep the load factor under three quarters
+    if ((pStrings->count + 1) * 4 > pStrings->capacity * 3 && !noodleStringTableGrow(pStrings))
+        return NULL;
+
+    size_t size = sizeof(NoodleString_t) + length + 1;
+    NoodleString_t* pString = noodleAlloc(&pStrings->allocator, size);
+    if (!pString) return NULL;
+
+    pString->hash = hash;
+    pString->length = length;
+    memcpy(pString->pData, pStr, length);
+    pString->pData[length] = '\0';
+
+    size_t mask = pStrings->capacity - 1;
+    size_t i = hash & mask;
+
+    while (pStrings->ppSlots[i]) 
+        i = (i + 1) & mask;
+
+    pStrings->ppSlots[i] = pString;
+    pStrings->count++;
+    pStrings->bytes += size;
+
+    return pString->pData;
+}
+
+NOODLE_BOOL noodleStringTableGrow(NoodleStringTable_t* pStrings)
+{
+    size_t capacity = pStrings->capacity ? pStrings->capacity * 2 : 64;
+
+    NoodleString_t** ppSlots = noodleAlloc(&pStrings->allocator, sizeof(NoodleString_t*) * capacity);
+    if (!ppSlots) return NOODLE_FALSE;
+
+    memset(ppSlots, 0, sizeof(NoodleString_t*) * capacity);
+
+    // Rehash every string into the new slots
+    for (size_t i = 0; i < pStrings->capacity; i++)
+    {
+        NoodleString_t* pString = pStrings->ppSlots[i];
+        if (!pString) continue;
+
+        size_t j = pString->hash & (capacity - 1);
+
+        while (ppSlots[j]) 
+            j = (j + 1) & (capacity - 1);
+
+        ppSlots[j] = pString;
+    }
+
+    noodleDealloc(&pStrings->allocator, pStrings->ppSlots);
+    pStrings->ppSlots = ppSlots;
+    pStrings->capacity = capacity;
+
+    return NOODLE_TRUE;
+}
+
+void noodleStringTableRelease(NoodleStringTable_t* pStrings)
+{
+    if (!pStrings || NOODLE_DECREMENT(&pStrings->references) > 0) return;
+
+    for (size_t i = 0; i < pStrings->capacity; i++)
+        noodleDealloc(&pStrings->allocator, pStrings->ppSlots[i]);
+
+    // Copy the allocator out first, it's freed along with the table
+    NoodleAllocator_t allocator = pStrings->allocator;
+    noodleDealloc(&allocator, pStrings->ppSlots);
+    noodleDealloc(&allocator, pStrings);
+}
+
+NoodleValue_t* noodleGroupInsert(const NoodleAllocator_t* pAllocator, NoodleGroup_t* pGroup, char* pName, NoodleType_t type)
+{
+    assert(pGroup && pName);
+    assert(!pGroup->pFrozen && "Frozen groups cannot be changed!");
+
+    if (pGroup->count == UINT32_MAX) return NULL;
+
+    // Grow the entries, pointers to earlier entries are not stable until the
+    // group is complete
+    if (pGroup->count == pGroup->capacity)
+    {
+        uint32_t capacity = pGroup->capacity ? pGroup->capacity * 2 : NOODLE_GROUP_INITIAL_CAPACITY;
+        if (capacity < pGroup->capacity) capacity = UINT32_MAX;
+
+        NoodleValue_t* pEntries = noodleRealloc(pAllocator, pGroup->pEntries, sizeof(NoodleValue_t) * capacity);
+        if (!pEntries) return NULL;
+
+        pGroup->pEntries = pEntries;
+        pGroup->capacity = capacity;
+    }
+
+    // Keep the index under three quarters full
+    if ((size_t)(pGroup->count + 1) * 4 > (size_t)pGroup->indexCapacity * 3 && !noodleGroupIndexGrow(pAllocator, pGroup))
+        return NULL;
+
+    NoodleValue_t* pEntry = &pGroup->pEntries[pGroup->count];
+    memset(pEntry, 0, sizeof(NoodleValue_t));
+    pEntry->base.type = type;
+    pEntry->base.pParent = pGroup;
+    pEntry->base.pName = pName;
+
+    // Names are interned so their hash is already known
+    uint32_t mask = pGroup->indexCapacity - 1;
+    uint32_t i = (uint32_t)noodleHashMix(noodleStringHeader(pName)->hash) & mask;
+
+    while (pGroup->pIndex[i])
+        i = (i + 1) & mask;
+
+    pGroup->pIndex[i] = ++pGroup->count;
+
+    return pEntry;
+}
+
+NOODLE_BOOL noodleGroupIndexGrow(const NoodleAllocator_t* pAllocator, NoodleGroup_t* pGroup)
+{
+    uint32_t capacity = pGroup->indexCapacity ? pGroup->indexCapacity * 2 : NOODLE_GROUP_INITIAL_CAPACITY * 2;
+    if (capacity < pGroup->indexCapacity) return NOODLE_FALSE;
+
+    uint32_t* pIndex = noodleAlloc(pAllocator, sizeof(uint32_t) * capacity);
+    if (!pIndex) return NOODLE_FALSE;
+
+    memset(pIndex, 0, sizeof(uint32_t) * capacity);
+
+    // Entries are reinserted in order so earlier duplicates are still found first
+    for (uint32_t e = 0; e < pGroup->count; e++)
+    {
+        uint32_t i = (uint32_t)noodleHashMix(noodleStringHeader(pGroup->pEntries[e].base.pName)->hash) & (capacity - 1);
+
+        while (pIndex[i])
+            i = (i + 1) & (capacity - 1);
+
+        pIndex[i] = e + 1;
+    }
+
+    noodleDealloc(pAllocator, pGroup->pIndex);
+    pGroup->pIndex = pIndex;
+    pGroup->indexCapacity = capacity;
+
+    return NOODLE_TRUE;
+}
+
+void noodleGroupShrink(const NoodleAllocator_t* pAllocator, NoodleGroup_t* pGroup)
+{
+    if (pGroup->count == pGroup->capacity || pGroup->count == 0) return;
+
+    // Failing to shrink is harmless, the larger entries are kept
+    NoodleValue_t* pEntries = noodleRealloc(pAllocator, pGroup->pEntries, sizeof(NoodleValue_t) * pGroup->count);
+    if (!pEntries) return;
+
+    pGroup->pEntries = pEntries;
+    pGroup->capacity = pGroup->count;
+}
+
+NOODLE_BOOL noodleGroupReserve(const NoodleAllocator_t* pAllocator, NoodleGroup_t* pGroup, uint32_t capacity)
+{
+    assert(!pGroup->count && "Only empty groups can be reserved!");
+
+    // Sized so inserting up to capacity entries never grows the index
+    uint32_t indexCapacity = NOODLE_GROUP_INITIAL_CAPACITY * 2;
+
+    while ((size_t)capacity * 4 > (size_t)indexCapacity * 3)
+    {
+        if (indexCapacity * 2 < indexCapacity) return NOODLE_FALSE;
+        indexCapacity *= 2;
+    }
+
+    NoodleValue_t* pEntries = noodleRealloc(pAllocator, pGroup->pEntries, sizeof(NoodleValue_t) * capacity);
+    if (!pEntries) return NOODLE_FALSE;
+
+    pGroup->pEntries = pEntries;
+    pGroup->capacity = capacity;
+
+    uint32_t* pIndex = noodleRealloc(pAllocator, pGroup->pIndex, sizeof(uint32_t) * indexCapacity);
+    if (!pIndex) return NOODLE_FALSE;
+
+    memset(pIndex, 0, sizeof(uint32_t) * indexCapacity);
+    pGroup->pIndex = pIndex;
+    pGroup->indexCapacity = indexCapacity;
+
+    return NOODLE_TRUE;
+}
+
+NoodleValue_t* noodleGroupFind(const NoodleGroup_t* pGroup, size_t hash, const char* pName, NOODLE_BOOL interned)
+{
+    if (!noodleGroupReady(pGroup)) return NULL;
+
+    if (pGroup->pFrozen)
+    {
+        // Every key maps to exactly one slot so a single compare verifies it
+        NoodleValue_t* pEntry = &pGroup->pEntries[pGroup->pFrozen->pSlots[noodleFrozenSlot(pGroup->pFrozen, hash)]];
+        const char* pEntryName = pEntry->base.pName;
+
+        if (pEntryName == pName || (!interned && noodleStringHeader(pEntryName)->hash == hash && strcmp(pEntryName, pName) == 0))
+        {
+            NOODLE_PROBE3(lookup__hit, pGroup, pName, 1);
+            return pEntry;
+        }
+
+        NOODLE_PROBE3(lookup__miss, pGroup, pName, 1);
+        return NULL;
+    }
+
+    if (!pGroup->indexCapacity)
+    {
+        NOODLE_PROBE3(lookup__miss, pGroup, pName, 0);
+        return NULL;
+    }
+
+    uint32_t mask = pGroup->indexCapacity - 1;
+    uint32_t probes = 1; // Slots looked at, the chain length of this key
+
+    for (uint32_t i = (uint32_t)noodleHashMix(hash) & mask; pGroup->pIndex[i]; i = (i + 1) & mask, probes++)
+    {
+        NoodleValue_t* pEntry = &pGroup->pEntries[pGroup->pIndex[i] - 1];
+        const char* pEntryName = pEntry->base.pName;
+
+        // Interned keys match by pointer, otherwise the stored hash rules out
+        // most names before comparing them
+        if (pEntryName == pName || (!interned && noodleStringHeader(pEntryName)->hash == hash && strcmp(pEntryName, pName) == 0))
+        {
+            NOODLE_PROBE3(lookup__hit, pGroup, pName, probes);
+            return pEntry;
+        }
+    }
+
+    NOODLE_PROBE3(lookup__miss, pGroup, pName, probes);
+    return NULL;
+}
+
+Noodle_t* noodleEntryNoodle(NoodleValue_t* pEntry)
+{
+    switch (pEntry->base.type)
+    {
+        case NOODLE_TYPE_GROUP:
+        case NOODLE_TYPE_ARRAY:
+            return pEntry->pChild;
+        default:
+            return &pEntry->base;
+    }
+}
+
+uint64_t noodleHashMix(uint64_t hash)
+{
+    // Finalizer of splitmix64, sdbm alone spreads short keys poorly
+    hash ^= hash >> 30;
+    hash *= 0xbf58476d1ce4e5b9ull;
+    hash ^= hash >> 27;
+    hash *= 0x94d049bb133111ebull;
+    hash ^= hash >> 31;
+
+    return hash;
+}
+
+size_t noodleFrozenSlot(const NoodleFrozen_t* pFrozen, size_t hash)
+{
+    uint64_t mixed = noodleHashMix((uint64_t)hash);
+    uint32_t seed = pFrozen->pSeeds[mixed % pFrozen->bucketCount];
+
+    return (size_t)(noodleHashMix(mixed ^ ((uint64_t)seed * 0x9e3779b97f4a7c15ull)) % pFrozen->count);
+}
+
+
+
+NOODLE_BOOL noodleGroupFreeze(const NoodleAllocator_t* pAllocator, NoodleGroup_t* pGroup)
+{
+    assert(pAllocator);
+    assert(pGroup);
+
+    // Lazy groups have to be parsed before they can be frozen
+    if (!noodleGroupReady(pGroup)) return NOODLE_FALSE;
+
+    NOODLE_BOOL succeeded = NOODLE_TRUE;
+
+    // A key written twice can't get a slot of its own, lookups only ever see
+    // its first entry so the group keeps its index
+    for (size_t i = 0; i < pGroup->count && !pGroup->pFrozen && succeeded; i++)
+    {
+        const char* pName = pGroup->pEntries[i].base.pName;
+
+        if (noodleGroupFind(pGroup, noodleStringHeader(pName)->hash, pName, NOODLE_FALSE) != &pGroup->pEntries[i])
+            succeeded = NOODLE_FALSE;
+    }
+
+    if (!pGroup->pFrozen && pGroup->count > 0 && succeeded)
+    {
+        // Fewer keys per bucket makes seeds easier to find, so retry with more buckets
+        NoodleFrozen_t* pFrozen = NULL;
+        size_t bucketCount = (pGroup->count + NOODLE_FROZEN_KEYS_PER_BUCKET - 1) / NOODLE_FROZEN_KEYS_PER_BUCKET;
+
+        for (int attempt = 0; attempt < NOODLE_FROZEN_ATTEMPTS && !pFrozen; attempt++)
+            pFrozen = noodleFrozenBuild(pAllocator, pGroup->pEntries, pGroup->count, bucketCount << attempt);
+
+        // The group stays usable through its index when no table could be built
+        if (pFrozen)
+        {
+            noodleDealloc(pAllocator, pGroup->pIndex);
+            pGroup->pIndex = NULL;
+            pGroup->indexCapacity = 0;
+            pGroup->pFrozen = pFrozen;
+        }
+        else
+        {
+            succeeded = NOODLE_FALSE;
+        }
+    }
+
+    for (size_t i = 0; i < pGroup->count; i++)
+    {
+        NoodleValue_t* pEntry = &pGroup->pEntries[i];
+
+        // Groups borrowed from an included file were frozen when it was loaded
+        if (pEntry->base.type == NOODLE_TYPE_GROUP && noodleOwns(pGroup, pEntry) && !noodleGroupFreeze(pAllocator, (NoodleGroup_t*)pEntry->pChild))
+            succeeded = NOODLE_FALSE;
+    }
+
+    return succeeded;
+}
+
+NoodleFrozen_t* noodleFrozenBuild(const NoodleAllocator_t* pAllocator, const NoodleValue_t* pEntries, size_t count, size_t bucketCount)
+{
+    if (bucketCount == 0) bucketCount = 1;
+
+    // The header, seeds and slots share one allocation
+    size_t seedsOffset = sizeof(NoodleFrozen_t);
+    size_t slotsOffset = seedsOffset + sizeof(uint32_t) * bucketCount;
+
+    NoodleFrozen_t* pFrozen = noodleAlloc(pAllocator, slotsOffset + sizeof(uint32_t) * count);
+    if (!pFrozen) return NULL;
+
+    pFrozen->count = count;
+    pFrozen->bucketCount = bucketCount;
+    pFrozen->pSeeds = (uint32_t*)((char*)pFrozen + seedsOffset);
+    pFrozen->pSlots = (uint32_t*)((char*)pFrozen + slotsOffset);
+
+    // Every slot starts out empty
+    memset(pFrozen->pSeeds, 0, sizeof(uint32_t) * bucketCount);
+    memset(pFrozen->pSlots, 0xff, sizeof(uint32_t) * count);
+
+    // Scratch space: the keys sorted by bucket, where each bucket starts,
+    // the bucket order from largest to smallest and the slots being tried
+    size_t scratchSize = sizeof(size_t) * (count + (bucketCount + 1) + bucketCount + NOODLE_FROZEN_KEYS_PER_BUCKET * 64 + count);
+    size_t* pScratch = noodleAlloc(pAllocator, scratchSize);
+    if (!pScratch)
+    {
+        noodleDealloc(pAllocator, pFrozen);
+        return NULL;
+    }
+
+    size_t* pSorted = pScratch;
+    size_t* pStarts = pSorted + count;
+    size_t* pOrder = pStarts + bucketCount + 1;
+    size_t* pBucketOf = pOrder + bucketCount + NOODLE_FROZEN_KEYS_PER_BUCKET * 64;
+
+    memset(pStarts, 0, sizeof(size_t) * (bucketCount + 1));
+
+    for (size_t i = 0; i < count; i++)
+    {
+        pBucketOf[i] = noodleHashMix(noodleStringHeader(pEntries[i].base.pName)->hash) % bucketCount;
+        pStarts[pBucketOf[i] + 1]++;
+    }
+
+    size_t largest = 0;
+    for (size_t b = 0; b < bucketCount; b++)
+    {
+        if (pStarts[b + 1] > largest) largest = pStarts[b + 1];
+        pStarts[b + 1] += pStarts[b];
+    }
+
+    // Counting sort of the keys by bucket, pOrder is used as the cursor
+    memcpy(pOrder, pStarts, sizeof(size_t) * bucketCount);
+    for (size_t i = 0; i < count; i++)
+        pSorted[pOrder[pBucketOf[i]]++] = i;
+
+    // The largest buckets are placed first while the table is still empty
+    size_t ordered = 0;
+    for (size_t size = largest; size > 0; size--)
+        for (size_t b = 0; b < bucketCount; b++)
+            if (pStarts[b + 1] - pStarts[b] == size) pOrder[ordered++] = b;
+
+    // Keys with equal hashes land in the same slot whatever the seed
+    NOODLE_BOOL placedAll = NOODLE_TRUE;
+
+    for (size_t b = 0; b < bucketCount && placedAll; b++)
+        for (size_t k = pStarts[b]; k < pStarts[b + 1] && placedAll; k++)
+            for (size_t j = pStarts[b]; j < k && placedAll; j++)
+                if (noodleStringHeader(pEntries[pSorted[j]].base.pName)->hash == noodleStringHeader(pEntries[pSorted[k]].base.pName)->hash)
+                    placedAll = NOODLE_FALSE;
+
+    size_t* pSlots = pOrder + bucketCount;
+    uint32_t seedLimit = count > (UINT32_MAX >> 6) ? UINT32_MAX : (uint32_t)(count << 6) + 1024;
+
+    for (size_t o = 0; o < ordered && placedAll; o++)
+    {
+        size_t bucket = pOrder[o];
+        size_t first = pStarts[bucket];
+        size_t size = pStarts[bucket + 1] - first;
+
+        // Too many keys landed in one bucket to try seeds for
+        if (size > NOODLE_FROZEN_KEYS_PER_BUCKET * 64)
+        {
+            placedAll = NOODLE_FALSE;
+            break;
+        }
+
+        NOODLE_BOOL placed = NOODLE_FALSE;
+
+        for (uint32_t seed = 0; seed < seedLimit && !placed; seed++)
+        {
+            placed = NOODLE_TRUE;
+
+            for (size_t k = 0; k < size && placed; k++)
+            {
+                size_t hash = noodleStringHeader(pEntries[pSorted[first + k]].base.pName)->hash;
+                uint64_t mixed = noodleHashMix((uint64_t)hash);
+                pSlots[k] = (size_t)(noodleHashMix(mixed ^ ((uint64_t)seed * 0x9e3779b97f4a7c15ull)) % count);
+
+                if (pFrozen->pSlots[pSlots[k]] != UINT32_MAX) placed = NOODLE_FALSE;
+
+                for (size_t j = 0; j < k && placed; j++)
+                    if (pSlots[j] == pSlots[k]) placed = NOODLE_FALSE;
+            }
+
+            if (!placed) continue;
+
+            for (size_t k = 0; k < size; k++)
+                pFrozen->pSlots[pSlots[k]] = (uint32_t)pSorted[first + k];
+
+            pFrozen->pSeeds[bucket] = seed;
+        }
+
+        if (!placed) placedAll = NOODLE_FALSE;
+    }
+
+    noodleDealloc(pAllocator, pScratch);
+
+    if (!placedAll)
+    {
+        noodleDealloc(pAllocator, pFrozen);
+        return NULL;
+    }
+
+    return pFrozen;
+}
+
+NoodleLexer_t noodleLexer(const char* pContent, size_t length)
+{
+    return (NoodleLexer_t){pContent, 0, 0, 0, length, NULL};
+}
+
+NOODLE_BOOL noodleLexerIsIdentifier(char c)
+{
+    switch (c)
+    {
+        case 'a':
+        case 'b':
+        case 'c':
+        case 'd':
+        case 'e':
+        case 'f':
+        case 'g':
+        case 'h':
+        case 'i':
+        case 'j':
+        case 'k':
+        case 'l':
+        case 'm':
+        case 'n':
+        case 'o':
+        case 'p':
+        case 'q':
+        case 'r':
+        case 's':
+        case 't':
+        case 'u':
+        case 'v':
+        case 'w':
+        case 'x':
+        case 'y':
+        case 'z':
+        case 'A':
+        case 'B':
+        case 'C':
+        case 'D':
+        case 'E':
+        case 'F':
+        case 'G':
+        case 'H':
+        case 'I':
+        case 'J':
+        case 'K':
+        case 'L':
+        case 'M':
+        case 'N':
+        case 'O':
+        case 'P':
+        case 'Q':
+        case 'R':
+        case 'S':
+        case 'T':
+        case 'U':
+        case 'V':
+        case 'W':
+        case 'X':
+        case 'Y':
+        case 'Z':
+        case '_':
+            return NOODLE_TRUE;
+        default:
+            return NOODLE_FALSE;
+    }
+}
+
+NOODLE_BOOL noodleLexerIsNumber(char c)
+{
+    switch (c)
+    {
+        case '0':
+        case '1':
+        case '2':
+        case '3':
+        case '4':
+        case '5':
+        case '6':
+        case '7':
+        case '8':
+        case '9':
+        case '.':
+            return NOODLE_TRUE;
+        default:
+            return NOODLE_FALSE;
+    }
+}
+
+NOODLE_BOOL noodleLexerIsSpace(char c)
+{
+    switch (c)
+    {
+        case ' ':
+        case '\n':
+        case '\t':
+        case '\v':
+        case '\f':
+        case '\r':
+            return NOODLE_TRUE;
+        default:
+            return NOODLE_FALSE;
+    }
+}
+
+NOODLE_BOOL noodleLexerNextToken(NoodleLexer_t* pLexer, NoodleToken_t* pTokenOut)
+{
+    // Comments and spaces loop around rather than recurse, a large file can
+    // have millions of them in a row
+    for (;;)
+    {
+        switch(noodleLexerPeek(pLexer))
+        {
+            case 'a':
+            case 'b':
+            case 'c':
+            case 'd':
+            case 'e':
+            case 'f':
+            case 'g':
+            case 'h':
+            case 'i':
+            case 'j':
+            case 'k':
+            case 'l':
+            case 'm':
+            case 'n': 
+            case 'o':
+            case 'p':
+            case 'q':
+            case 'r':
+            case 's':
+            case 't':
+            case 'u':
+            case 'v':
+            case 'w':
+            case 'x':
+            case 'y':
+            case 'z':
+            case 'A':
+            case 'B':
+            case 'C':
+            case 'D':
+            case 'E':
+            case 'F':
+            case 'G':
+            case 'H':
+            case 'I':
+            case 'J':
+            case 'K':
+            case 'L':
+            case 'M':
+            case 'N':
+            case 'O':
+            case 'P':
+            case 'Q':
+            case 'R':
+            case 'S':
+            case 'T':
+            case 'U':
+            case 'V':
+            case 'W':
+            case 'X':
+            case 'Y':
+            case 'Z':
+            case '_':
+                noodleLexerIdentifierOrBool(pLexer, pTokenOut);
+                break;
+            case '0':
+            case '1':
+            case '2':
+            case '3':
+            case '4':
+            case '5':
+            case '6':
+            case '7':
+            case '8':
+            case '9':
+                noodleLexerNumber(pLexer, pTokenOut);
+                break;
+            case '=':
+                noodleLexerAtom(pLexer, NOODLE_TOKEN_KIND_EQUAL, pTokenOut);
+                break;
+            case '{':
+                noodleLexerAtom(pLexer, NOODLE_TOKEN_KIND_LEFTCURLY, pTokenOut);
+                break;
+            case '}':
+                noodleLexerAtom(pLexer, NOODLE_TOKEN_KIND_RIGHTCURLY, pTokenOut);
+                break;
+            case '[':
+                noodleLexerAtom(pLexer, NOODLE_TOKEN_KIND_LEFTBRACKET, pTokenOut);
+                break;
+            case ']':
+                noodleLexerAtom(pLexer, NOODLE_TOKEN_KIND_RIGHTBRACKET, pTokenOut);
+                break;
+            case '\"':
+                noodleLexerString(pLexer, pTokenOut);
+                break;
+            case ',':
+                noodleLexerAtom(pLexer, NOODLE_TOKEN_KIND_COMMA, pTokenOut);
+                break;
+            case '#':
+                noodleLexerSkipComment(pLexer);
+                continue;
+            case ' ':
+            case '\n':
+            case '\t':
+            case '\v':
+            case '\f':
+            case '\r':
+                noodleLexerSkipSpaces(pLexer);
+                continue;
+            case '\0':
+                noodleLexerAtom(pLexer, NOODLE_TOKEN_KIND_END, pTokenOut);
+                break;
+            default:
+                noodleLexerAtom(pLexer, NOODLE_TOKEN_KIND_UNEXPECTED, pTokenOut);
+                return NOODLE_FALSE;
+        }
+
+        return true;
+    }
+}
+
+NOODLE_BOOL noodleParseNextToken(NoodleLexer_t* pLexer, NoodleToken_t* pTokenOut, NoodleParseStats_t* pStats)
+{
+    if (!pStats) return noodleLexerNextToken(pLexer, pTokenOut);
+
+    // Only pay for the clock when the caller asked for statistics
+    double start = noodleTimeNow();
+    NOODLE_BOOL result = noodleLexerNextToken(pLexer, pTokenOut);
+    pStats->lexSeconds += noodleTimeNow() - start;
+    pStats->tokenCount++;
+
+    return result;
+}
+
+char noodleLexerGet(NoodleLexer_t* pLexer)
+{
+    char c = noodleLexerPeek(pLexer);
+    pLexer->current++;
+
+    // Correctly increase line counts and character numbers
+    if (c == '\n')
+    {
+        pLexer->line++;
+        pLexer->character = 0;
+    }
+    else
+    {
+        pLexer->character++;
+    }
+ 
+    return c;
+}
+
+char noodleLexerPeek(NoodleLexer_t* pLexer)
+{
+    if (pLexer->current < pLexer->length) return pLexer->pContent[pLexer->current];
+
+    return pLexer->pStream ? noodleLexerRefill(pLexer) : '\0';
+}
+
+char noodleLexerRefill(NoodleLexer_t* pLexer)
+{
+    // Blocks are only ever appended here, so offsets into the window stay
+    // valid even when it has to grow
+    NoodleStream_t* pStream = pLexer->pStream;
+
+    while (pLexer->current >= pLexer->length)
+    {
+        noodleMutexLock(&pStream->lock);
+
+        while (pStream->taken == pStream->filled && !pStream->finished)
+            noodleConditionWait(&pStream->produced, &pStream->lock);
+
+        NOODLE_BOOL empty = pStream->taken == pStream->filled;
+        noodleMutexUnlock(&pStream->lock);
+
+        if (empty) return '\0';
+
+        // The decompressor doesn't touch a filled block until it's taken
+        NoodleStreamBlock_t* pBlock = &pStream->pBlocks[pStream->taken % NOODLE_STREAM_BLOCKS];
+
+        if (pLexer->length + pBlock->size + 1 > pStream->windowCapacity)
+        {
+            size_t capacity = pStream->windowCapacity * 2;
+            if (capacity < pLexer->length + pBlock->size + 1) capacity = pLexer->length + pBlock->size + 1;
+
+            char* pWindow = noodleRealloc(pStream->pAllocator, pStream->pWindow, capacity);
+
+            if (!pWindow)
+            {
+                noodleMutexLock(&pStream->lock);
+                pStream->failed = NOODLE_TRUE;
+                noodleMutexUnlock(&pStream->lock);
+                return '\0';
+            }
+
+            pStream->pWindow = pWindow;
+            pStream->windowCapacity = capacity;
+        }
+
+        memcpy(pStream->pWindow + pLexer->length, pBlock->pData, pBlock->size);
+        pLexer->length += pBlock->size;
+        pLexer->pContent = pStream->pWindow;
+        pStream->pWindow[pLexer->length] = '\0';
+
+        noodleMutexLock(&pStream->lock);
+        pStream->taken++;
+        noodleConditionSignal(&pStream->consumed);
+        noodleMutexUnlock(&pStream->lock);
+    }
+
+    return pLexer->pContent[pLexer->current];
+}
+
+void noodleLexerSkipComment(NoodleLexer_t* pLexer)
+{
+    // Stop before the null-terminator, reading past it would leave the content
+    char c = 0;
+    while ((c = noodleLexerPeek(pLexer)) && c != '\n')
+    {
+        noodleLexerGet(pLexer);
+    }
+}
+
+void noodleLexerSkipSpaces(NoodleLexer_t* pLexer)
+{
+    char c = noodleLexerGet(pLexer);
+    while ((c = noodleLexerPeek(pLexer)) && noodleLexerIsSpace(c))
+    {
+        c = noodleLexerGet(pLexer);
+    }
+}
+
+void noodleLexerAtom(NoodleLexer_t* pLexer, NoodleTokenKind_t kind, NoodleToken_t* pTokenOut)
+{
+    assert(pLexer);
+    assert(pTokenOut);
+
+    noodleLexerGet(pLexer);
+
+    *pTokenOut = noodleToken(kind, pLexer->current, pLexer->current + 1);
+}
+
+void noodleLexerIdentifierOrBool(NoodleLexer_t* pLexer, NoodleToken_t* pTokenOut)
+{
+    assert(pLexer);
+    assert(pTokenOut);
+
+    size_t start = pLexer->current;
+
+    while(noodleLexerIsIdentifier(noodleLexerPeek(pLexer))) 
+    {
+        noodleLexerGet(pLexer);
+    }
+
+    // It's easier to catch booleans here so we do
+    if (((sizeof("true") - 1 == pLexer->current - start) || (sizeof("false") - 1 == pLexer->current - start)) 
+        && ((strncmp(pLexer->pContent + start, "true", pLexer->current - start) == 0) || (strncmp(pLexer->pContent + start, "false", pLexer->current - start) == 0)))
+    {
+        *pTokenOut = noodleToken(NOODLE_TOKEN_KIND_BOOLEAN, start, pLexer->current);
+        return;
+    }
+
+    *pTokenOut = noodleToken(NOODLE_TOKEN_KIND_IDENTIFIER, start, pLexer->current);
+}
+
+void noodleLexerNumber(NoodleLexer_t* pLexer, NoodleToken_t* pOutToken)
+{
+    assert(pLexer);
+    assert(pOutToken);
+
+    size_t start = pLexer->current;
+
+    while (noodleLexerIsNumber(noodleLexerPeek(pLexer)))
+    {
+        noodleLexerGet(pLexer);
+    }
+
+    // Only digits and dots were taken, which strtol reads whole when there
+    // are no dots and strtof when there is one. Counting them is enough to
+    // classify the number, without the cost of converting it twice.
+    size_t dots = 0;
+
+    for (size_t i = start; i < pLexer->current; i++)
+        if (pLexer->pContent[i] == '.') dots++;
+
+    NoodleTokenKind_t kind = NOODLE_TOKEN_KIND_UNEXPECTED;
+
+    // Numbers are converted from a copy, too long ones can't be, see noodleTokenCopy
+    if (pLexer->current - start < NOODLE_NUMBER_MAX_LENGTH)
+    {
+        if (dots == 0)
+            kind = NOODLE_TOKEN_KIND_INTEGER;
+        else if (dots == 1)
+            kind = NOODLE_TOKEN_KIND_FLOAT;
+    }
+
+    *pOutToken = noodleToken(kind, start, pLexer->current);
+}
+
+void noodleLexerString(NoodleLexer_t* pLexer, NoodleToken_t* pTokenOut)
+{
+    assert(pLexer);
+    assert(pTokenOut);
+
+    noodleLexerGet(pLexer); // Get the starting quote
+
+    size_t start = pLexer->current; 
+    NOODLE_BOOL escaped = NOODLE_FALSE;
+
+    for (;;)
+    {
+        // Plain characters are skipped in bulk, only the ones that stop the
+        // run are looked at one by one
+        if (pLexer->current < pLexer->length)
+        {
+            size_t run = noodleStringRun(pLexer->pContent + pLexer->current, pLexer->length - pLexer->current);
+            pLexer->current += run;
+            pLexer->character += run;
+        }
+
+        char c = noodleLexerPeek(pLexer);
+        if (c == '\"') break;
+
+        // A string left open runs into the end of the content
+        if (c == '\0')
+        {
+            *pTokenOut = noodleToken(NOODLE_TOKEN_KIND_UNEXPECTED, start, pLexer->current);
+            return;
+        }
+
+        size_t position = pLexer->current;
+        NOODLE_BOOL valid = NOODLE_TRUE;
+
+        if (c == '\\')
+        {
+            escaped = NOODLE_TRUE;
+            valid = noodleLexerEscape(pLexer);
+        }
+        else if ((unsigned char)c >= 0x80)
+        {
+            valid = noodleLexerUtf8(pLexer);
+        }
+        else
+        {
+            noodleLexerGet(pLexer); // Control characters, new lines have to be counted
+        }
+
+        // Only the offending escape or character is reported
+        if (!valid)
+        {
+            *pTokenOut = noodleToken(NOODLE_TOKEN_KIND_UNEXPECTED, position, pLexer->current);
+            return;
+        }
+    }
+
+    noodleLexerGet(pLexer); // Push past the second quote 
+
+    *pTokenOut = noodleToken(NOODLE_TOKEN_KIND_STRING, start, pLexer->current - 1);
+    pTokenOut->escaped = escaped;
+}
+
+NOODLE_BOOL noodleLexerEscape(NoodleLexer_t* pLexer)
+{
+    noodleLexerGet(pLexer); // The backslash
+
+    // The end of the content is never stepped over
+    char c = noodleLexerPeek(pLexer);
+    if (c == '\0') return NOODLE_FALSE;
+
+    noodleLexerGet(pLexer);
+
+    switch (c)
+    {
+        case '\"':
+        case '\\':
+        case '/':
+        case 'b':
+        case 'f':
+        case 'n':
+        case 'r':
+        case 't':
+            return NOODLE_TRUE;
+        case 'u':
+        {
+            uint32_t unit = 0;
+            if (!noodleLexerHex(pLexer, &unit)) return NOODLE_FALSE;
+
+            // Surrogates only stand for a character as a high and low pair
+            if (unit >= 0xdc00 && unit <= 0xdfff) return NOODLE_FALSE;
+            if (unit < 0xd800 || unit > 0xdbff) return NOODLE_TRUE;
+
+            if (noodleLexerPeek(pLexer) != '\\') return NOODLE_FALSE;
+            noodleLexerGet(pLexer);
+
+            if (noodleLexerPeek(pLexer) != 'u') return NOODLE_FALSE;
+            noodleLexerGet(pLexer);
+
+            return noodleLexerHex(pLexer, &unit) && unit >= 0xdc00 && unit <= 0xdfff;
+        }
+        default:
+            return NOODLE_FALSE;
+    }
+}
+
+NOODLE_BOOL noodleLexerHex(NoodleLexer_t* pLexer, uint32_t* pUnit)
+{
+    uint32_t unit = 0;
+
+    for (size_t i = 0; i < 4; i++)
+    {
+        char hex = noodleLexerPeek(pLexer);
+        unit <<= 4;
+
+        if (hex >= '0' && hex <= '9') unit |= (uint32_t)(hex - '0');
+        else if (hex >= 'a' && hex <= 'f') unit |= (uint32_t)(hex - 'a' + 10);
+        else if (hex >= 'A' && hex <= 'F') unit |= (uint32_t)(hex - 'A' + 10);
+        else return NOODLE_FALSE;
+
+        noodleLexerGet(pLexer);
+    }
+
+    *pUnit = unit;
+    return NOODLE_TRUE;
+}
+
+NOODLE_BOOL noodleLexerUtf8(NoodleLexer_t* pLexer)
+{
+    unsigned char lead = (unsigned char)noodleLexerGet(pLexer);
+
+    // The lead byte gives the number of continuation bytes, the ranges of the 
+    // first one rule out overlong forms, surrogates and anything past U+10FFFF
+    size_t count = 0;
+    unsigned char low = 0x80;
+    unsigned char high = 0xbf;
+
+    if (lead >= 0xc2 && lead <= 0xdf)
+    {
+        count = 1;
+    }
+    else if (lead >= 0xe0 && lead <= 0xef)
+    {
+        count = 2;
+        if (lead == 0xe0) low = 0xa0;
+        if (lead == 0xed) high = 0x9f;
+    }
+    else if (lead >= 0xf0 && lead <= 0xf4)
+    {
+        count = 3;
+        if (lead == 0xf0) low = 0x90;
+        if (lead == 0xf4) high = 0x8f;
+    }
+    else
+    {
+        return NOODLE_FALSE;
+    }
+
+    for (size_t i = 0; i < count; i++)
+    {
+        unsigned char c = (unsigned char)noodleLexerPeek(pLexer);
+        if (c < low || c > high) return NOODLE_FALSE;
+
+        noodleLexerGet(pLexer);
+        low = 0x80;
+        high = 0xbf;
+    }
+
+    return NOODLE_TRUE;
+}
+
+size_t noodleStringRun(const char* pString, size_t length)
+{
+    // Quotes, backslashes, control characters and the bytes of multibyte 
+    // characters stop a run. As signed bytes the last two are all below 
+    // 0x20, so a single comparison finds both.
+    size_t i = 0;
+
+#if defined(NOODLE_SSE2)
+    const __m128i quote = _mm_set1_epi8('\"');
+    const __m128i backslash = _mm_set1_epi8('\\');
+    const __m128i control = _mm_set1_epi8(0x20);
+
+    for (; i + 16 <= length; i += 16)
+    {
+        __m128i chunk = _mm_loadu_si128((const __m128i*)(pString + i));
+        __m128i stops = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(chunk, quote), _mm_cmpeq_epi8(chunk, backslash)), _mm_cmplt_epi8(chunk, control));
+
+        unsigned mask = (unsigned)_mm_movemask_epi8(stops);
+        if (mask) return i + noodleLowestBit(mask);
+    }
+#elif defined(NOODLE_NEON)
+    const uint8x16_t quote = vdupq_n_u8('\"');
+    const uint8x16_t backslash = vdupq_n_u8('\\');
+    const int8x16_t control = vdupq_n_s8(0x20);
+
+    for (; i + 16 <= length; i += 16)
+    {
+        uint8x16_t chunk = vld1q_u8((const uint8_t*)pString + i);
+        uint8x16_t stops = vorrq_u8(vorrq_u8(vceqq_u8(chunk, quote), vceqq_u8(chunk, backslash)), vcltq_s8(vreinterpretq_s8_u8(chunk), control));
+
+        // Narrowing leaves four bits for each byte
+        uint64_t mask = vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(stops), 4)), 0);
+        if (mask) return i + noodleLowestBit(mask) / 4;
+    }
+#endif
+
+    for (; i < length; i++)
+    {
+        signed char c = (signed char)pString[i];
+        if (c < 0x20 || c == '\"' || c == '\\') break;
+    }
+
+    return i;
+}
+
+size_t noodleContentLength(const char* pContent, size_t length)
+{
+    // memchr stops at the first match, so length may run past the content
+    const char* pEnd = memchr(pContent, '\0', length);
+    return pEnd ? (size_t)(pEnd - pContent) : length;
+}
+
+size_t noodleStringDecode(const char* pSource, size_t length, char* pDecoded)
+{
+    // The escapes were checked by the lexer, so they're taken as valid here
+    size_t size = 0;
+    size_t i = 0;
+
+    while (i < length)
+    {
+        const char* pEscape = memchr(pSource + i, '\\', length - i);
+        size_t run = pEscape ? (size_t)(pEscape - pSource) - i : length - i;
+
+        memcpy(pDecoded + size, pSource + i, run);
+        size += run;
+        i += run;
+
+        if (i == length) break;
+
+        char c = pSource[i + 1];
+        i += 2;
+
+        switch (c)
+        {
+            case 'b': pDecoded[size++] = '\b'; break;
+            case 'f': pDecoded[size++] = '\f'; break;
+            case 'n': pDecoded[size++] = '\n'; break;
+            case 'r': pDecoded[size++] = '\r'; break;
+            case 't': pDecoded[size++] = '\t'; break;
+            case 'u':
+            {
+                uint32_t codepoint = 0;
+                noodleJsonHex(pSource, length, i, &codepoint);
+                i += 4;
+
+                if (codepoint >= 0xd800 && codepoint <= 0xdbff)
+                {
+                    uint32_t low = 0;
+                    noodleJsonHex(pSource, length, i + 2, &low);
+                    i += 6;
+
+                    codepoint = 0x10000 + ((codepoint - 0xd800) << 10) + (low - 0xdc00);
+                }
+
+                size += noodleUtf8Encode(codepoint, pDecoded + size);
+                break;
+            }
+            default: pDecoded[size++] = c; break; // Quotes, backslashes and slashes
+        }
+    }
+
+    return size;
+}
+
+size_t noodleUtf8Encode(uint32_t codepoint, char* pBytes)
+{
+    size_t size = 0;
+
+    if (codepoint < 0x80)
+    {
+        pBytes[size++] = (char)codepoint;
+    }
+    else if (codepoint < 0x800)
+    {
+        pBytes[size++] = (char)(0xc0 | (codepoint >> 6));
+        pBytes[size++] = (char)(0x80 | (codepoint & 0x3f));
+    }
+    else if (codepoint < 0x10000)
+    {
+        pBytes[size++] = (char)(0xe0 | (codepoint >> 12));
+        pBytes[size++] = (char)(0x80 | ((codepoint >> 6) & 0x3f));
+        pBytes[size++] = (char)(0x80 | (codepoint & 0x3f));
+    }
+    else
+    {
+        pBytes[size++] = (char)(0xf0 | (codepoint >> 18));
+        pBytes[size++] = (char)(0x80 | ((codepoint >> 12) & 0x3f));
+        pBytes[size++] = (char)(0x80 | ((codepoint >> 6) & 0x3f));
+        pBytes[size++] = (char)(0x80 | (codepoint & 0x3f));
+    }
+
+    return size;
+}
+
+unsigned noodleLowestBit(uint64_t mask)
+{
+    assert(mask);
+
+#ifdef _MSC_VER
+    unsigned long index = 0;
+    if (_BitScanForward(&index, (unsigned long)mask)) return (unsigned)index;
+
+    _BitScanForward(&index, (unsigned long)(mask >> 32));
+    return (unsigned)index + 32;
+#else
+    return (unsigned)__builtin_ctzll(mask);
+#endif
+}
+
+uint64_t noodleTapeWord(NoodleTapeTag_t tag, uint64_t payload)
+{
+    assert(payload <= NOODLE_TAPE_PAYLOAD_MASK);
+    return ((uint64_t)tag << 56) | payload;
+}
+
+NoodleTapeTag_t noodleTapeTag(uint64_t word)
+{
+    return (NoodleTapeTag_t)(word >> 56);
+}
+
+uint64_t noodleTapePayload(uint64_t word)
+{
+    return word & NOODLE_TAPE_PAYLOAD_MASK;
+}
+
+NOODLE_BOOL noodleTapePush(NoodleTape_t** ppTape, uint64_t word)
+{
+    NoodleTape_t* pTape = *ppTape;
+
+    // The words are part of the tape's allocation so growing may move it
+    if (pTape->count == pTape->capacity)
+    {
+        size_t capacity = pTape->capacity * 2;
+
+        NoodleTape_t* pNewTape = noodleRealloc(&pTape->allocator, pTape, sizeof(NoodleTape_t) + sizeof(uint64_t) * capacity);
+        if (!pNewTape) return NOODLE_FALSE;
+
+        pTape = pNewTape;
+        pTape->capacity = capacity;
+        *ppTape = pTape;
+    }
+
+    pTape->pWords[pTape->count++] = word;
+    return NOODLE_TRUE;
+}
+
+NOODLE_BOOL noodleTapePushString(NoodleTape_t* pTape, const char* pStr, size_t length, NOODLE_BOOL escaped, uint64_t* pOffset)
+{
+    // Room is made for the string as written, decoding only shortens it
+    if (pTape->stringsSize + length + 1 > NOODLE_TAPE_OFFSET_MASK) return NOODLE_FALSE;
+
+    if (pTape->stringsSize + length + 1 > pTape->stringsCapacity)
+    {
+        size_t capacity = pTape->stringsCapacity ? pTape->stringsCapacity * 2 : 256;
+
+        while (capacity < pTape->stringsSize + length + 1) 
+            capacity *= 2;
+
+        char* pStrings = noodleRealloc(&pTape->allocator, pTape->pStrings, capacity);
+        if (!pStrings) return NOODLE_FALSE;
+
+        pTape->pStrings = pStrings;
+        pTape->stringsCapacity = capacity;
+    }
+
+    *pOffset = pTape->stringsSize;
+
+    if (escaped)
+        length = noodleStringDecode(pStr, length, pTape->pStrings + pTape->stringsSize);
+    else
+        memcpy(pTape->pStrings + pTape->stringsSize, pStr, length);
+
+    pTape->pStrings[pTape->stringsSize + length] = '\0';
+    pTape->stringsSize += length + 1;
+
+    return NOODLE_TRUE;
+}
+
+NOODLE_BOOL noodleTapePushValue(NoodleTape_t** ppTape, const NoodleLexer_t* pLexer, const NoodleToken_t* pToken)
+{
+    switch (pToken->kind)
+    {
+        case NOODLE_TOKEN_KIND_INTEGER:
+            return noodleTapePush(ppTape, noodleTapeWord(NOODLE_TAPE_TAG_INTEGER, (uint32_t)noodleParseInt(pLexer, pToken)));
+
+        case NOODLE_TOKEN_KIND_FLOAT:
+        {
+            float value = noodleParseFloat(pLexer, pToken);
+            uint32_t bits;
+            memcpy(&bits, &value, sizeof(float));
+
+            return noodleTapePush(ppTape, noodleTapeWord(NOODLE_TAPE_TAG_FLOAT, bits));
+        }
+
+        case NOODLE_TOKEN_KIND_BOOLEAN:
+            return noodleTapePush(ppTape, noodleTapeWord(NOODLE_TAPE_TAG_BOOLEAN, noodleParseBool(pLexer, pToken) ? 1 : 0));
+
+        case NOODLE_TOKEN_KIND_STRING:
+        {
+            uint64_t offset = 0;
+            if (!noodleTapePushString(*ppTape, pLexer->pContent + pToken->start, pToken->end - pToken->start, pToken->escaped, &offset)) return NOODLE_FALSE;
+
+            return noodleTapePush(ppTape, noodleTapeWord(NOODLE_TAPE_TAG_STRING, offset));
+        }
+
+        default:
+            assert(false && "Token is not a value!");
+            return NOODLE_FALSE;
+    }
+}
+
+void noodleMutexInit(NoodleMutex_t* pMutex)
+{
+#ifdef _WIN32
+    InitializeSRWLock(pMutex);
+#else
+    pthread_mutex_init(pMutex, NULL);
+#endif
+}
+
+void noodleMutexDestroy(NoodleMutex_t* pMutex)
+{
+#ifdef _WIN32
+    (void)pMutex; // Slim locks have nothing to destroy
+#else
+    pthread_mutex_destroy(pMutex);
+#endif
+}
+
+void noodleMutexLock(NoodleMutex_t* pMutex)
+{
+#ifdef _WIN32
+    AcquireSRWLockExclusive(pMutex);
+#else
+    pthread_mutex_lock(pMutex);
+#endif
+}
+
+void noodleMutexUnlock(NoodleMutex_t* pMutex)
+{
+#ifdef _WIN32
+    ReleaseSRWLockExclusive(pMutex);
+#else
+    pthread_mutex_unlock(pMutex);
+#endif
+}
+
+void noodleConditionInit(NoodleCondition_t* pCondition)
+{
+#ifdef _WIN32
+    InitializeConditionVariable(pCondition);
+#else
+    pthread_cond_init(pCondition, NULL);
+#endif
+}
+
+void noodleConditionDestroy(NoodleCondition_t* pCondition)
+{
+#ifdef _WIN32
+    (void)pCondition; // Like slim locks there is nothing to destroy
+#else
+    pthread_cond_destroy(pCondition);
+#endif
+}
+
+void noodleConditionWait(NoodleCondition_t* pCondition, NoodleMutex_t* pMutex)
+{
+#ifdef _WIN32
+    SleepConditionVariableSRW(pCondition, pMutex, INFINITE, 0);
+#else
+    pthread_cond_wait(pCondition, pMutex);
+#endif
+}
+
+void noodleConditionSignal(NoodleCondition_t* pCondition)
+{
+#ifdef _WIN32
+    WakeConditionVariable(pCondition);
+#else
+    pthread_cond_signal(pCondition);
+#endif
+}
+
+void noodleConditionBroadcast(NoodleCondition_t* pCondition)
+{
+#ifdef _WIN32
+    WakeAllConditionVariable(pCondition);
+#else
+    pthread_cond_broadcast(pCondition);
+#endif
+}
+
+NOODLE_BOOL noodleThreadStart(NoodleThreadFunction_t function, void* pUser, NoodleThread_t* pThread)
+{
+    // Without pThread the thread is never joined, so it's detached right away
+#ifdef _WIN32
+    HANDLE thread = CreateThread(NULL, 0, function, pUser, 0, NULL);
+    if (!thread) return NOODLE_FALSE;
+
+    if (pThread) *pThread = thread;
+    else CloseHandle(thread);
+
+    return NOODLE_TRUE;
+#else
+    pthread_t thread;
+    if (pthread_create(&thread, NULL, function, pUser) != 0) return NOODLE_FALSE;
+
+    if (pThread) *pThread = thread;
+    else pthread_detach(thread);
+
+    return NOODLE_TRUE;
+#endif
+}
+
+void noodleThreadJoin(NoodleThread_t thread)
+{
+#ifdef _WIN32
+    WaitForSingleObject(thread, INFINITE);
+    CloseHandle(thread);
+#else
+    pthread_join(thread, NULL);
+#endif
+}
+
+NOODLE_BOOL noodleLazyScan(NoodleRoot_t* pRoot, size_t* pStray)
+{
+    const char* pSource = pRoot->pSource;
+    const NoodleAllocator_t* pAllocator = &pRoot->allocator;
+
+    NoodleLazyGroup_t* pGroups = NULL;
+    size_t count = 0;
+    size_t capacity = 0;
+
+    // While a group is open its descendants hold the group enclosing it
+    size_t open = SIZE_MAX;
+    size_t i = 0;
+
+    // Lines are counted like the lexer does, so errors after a skipped group keep their position
+    size_t line = 0;
+    size_t lineStart = 0;
+
+    while (pSource[i] != '\0')
+    {
+        switch (pSource[i])
+        {
+            // Curlies inside of strings and comments don't count
+            case '\"':
+                i++;
+                while (pSource[i] != '\0' && pSource[i] != '\"') 
+                {
+                    // An escaped quote doesn't end the string
+                    if (pSource[i] == '\\' && pSource[i + 1] != '\0') i++;
+
+                    if (pSource[i] == '\n')
+                    {
+                        line++;
+                        lineStart = i + 1;
+                    }
+
+                    i++;
+                }
+                if (pSource[i] == '\0') continue;
+                break;
+
+            case '\n':
+                line++;
+                lineStart = i + 1;
+                break;
+
+            case '#':
+                while (pSource[i] != '\0' && pSource[i] != '\n') i++;
+                continue;
+
+            case '{':
+            {
+                // Nothing points into the groups until the scan is done, so they can move
+                if (count == capacity)
+                {
+                    size_t newCapacity = capacity ? capacity * 2 : NOODLE_GROUP_INITIAL_CAPACITY;
+
+                    NoodleLazyGroup_t* pNewGroups = noodleRealloc(pAllocator, pGroups, sizeof(NoodleLazyGroup_t) * newCapacity);
+                    if (!pNewGroups) 
+                    {
+                        noodleDealloc(pAllocator, pGroups);
+                        *pStray = SIZE_MAX;
+                        return NOODLE_FALSE;
+                    }
+
+                    pGroups = pNewGroups;
+                    capacity = newCapacity;
+                }
+
+                NoodleLazyGroup_t* pGroup = &pGroups[count];
+                memset(pGroup, 0, sizeof(NoodleLazyGroup_t));
+
+                pGroup->group.base.type = NOODLE_TYPE_GROUP;
+                pGroup->group.lazy = NOODLE_TRUE;
+                pGroup->state = NOODLE_LAZY_PENDING;
+                pGroup->start = i + 1;
+                pGroup->descendants = open;
+
+                open = count++;
+                break;
+            }
+
+            case '}':
+            {
+                if (open == SIZE_MAX)
+                {
+                    noodleDealloc(pAllocator, pGroups);
+                    *pStray = i;
+                    return NOODLE_FALSE;
+                }
+
+                NoodleLazyGroup_t* pGroup = &pGroups[open];
+
+                open = pGroup->descendants;
+                pGroup->descendants = count - (size_t)(pGroup - pGroups) - 1;
+                pGroup->next = i + 1;
+                pGroup->nextLine = line;
+                pGroup->nextLineStart = lineStart;
+                break;
+            }
+
+            default:
+                break;
+        }
+
+        i++;
+    }
+
+    // Like noodleParse, groups left open at the end are closed implicitly
+    while (open != SIZE_MAX)
+    {
+        NoodleLazyGroup_t* pGroup = &pGroups[open];
+
+        open = pGroup->descendants;
+        pGroup->descendants = count - (size_t)(pGroup - pGroups) - 1;
+        pGroup->next = i;
+        pGroup->nextLine = line;
+        pGroup->nextLineStart = lineStart;
+    }
+
+    pRoot->pLazyGroups = pGroups;
+    pRoot->lazyCount = count;
+    pRoot->sourceLength = i;
+
+    return NOODLE_TRUE;
+}
+
+NOODLE_BOOL noodleLazyParse(NoodleRoot_t* pRoot, NoodleGroup_t* pGroup, size_t start, size_t firstChild, char* pErrorBuffer, size_t bufferSize)
+{
+    const NoodleAllocator_t* pAllocator = &pRoot->allocator;
+    const char* pErrorExpected = "";
+    size_t child = firstChild;
+
+    NoodleLexer_t lexer = noodleLexer(pRoot->pSource, pRoot->sourceLength);
+    NoodleToken_t token = {0};
+
+    lexer.current = start;
+    noodleLexerNextToken(&lexer, &token);
+
+    // The scan already matched every curly, so the first closing one ends the group
+    while (token.kind != NOODLE_TOKEN_KIND_END && token.kind != NOODLE_TOKEN_KIND_RIGHTCURLY)
+    {
+        if (token.kind != NOODLE_TOKEN_KIND_IDENTIFIER)
+        {
+            pErrorExpected = "Identifier";
+            goto cleanupParse;
+        }
+
+        // Lazy documents have no path, so included paths are relative to the working directory
+        if (noodleParseIncludeDirective(&lexer, &token))
+        {
+            if (!noodleInclude(pRoot, pGroup, &lexer, &token, NULL, pErrorBuffer, bufferSize)) goto cleanupInclude;
+
+            noodleLexerNextToken(&lexer, &token);
+
+            if (token.kind == NOODLE_TOKEN_KIND_COMMA)
+                noodleLexerNextToken(&lexer, &token);
+
+            continue;
+        }
+
+        char* pIdentifier = noodleStringTableIntern(pRoot->pStrings, pRoot->pSource + token.start, token.end - token.start);
+        if (!pIdentifier) goto cleanupMemory;
+
+        noodleLexerNextToken(&lexer, &token);
+
+        if (token.kind != NOODLE_TOKEN_KIND_EQUAL)
+        {
+            pErrorExpected = "Equals Symbol";
+            goto cleanupParse;
+        }
+
+        noodleLexerNextToken(&lexer, &token);
+
+        if (token.kind == NOODLE_TOKEN_KIND_LEFTCURLY)
+        {
+            // Link the group the scan laid out and jump past its body
+            NoodleLazyGroup_t* pChild = &pRoot->pLazyGroups[child];
+
+            NoodleValue_t* pEntry = noodleGroupInsert(pAllocator, pGroup, pIdentifier, NOODLE_TYPE_GROUP);
+            if (!pEntry) goto cleanupMemory;
+
+            pChild->group.base.pName = pIdentifier;
+            pChild->group.base.pParent = pGroup;
+            pEntry->pChild = (Noodle_t*)pChild;
+
+            child += 1 + pChild->descendants;
+            lexer.current = pChild->next;
+            lexer.line = pChild->nextLine;
+            lexer.character = pChild->next - pChild->nextLineStart;
+
+            noodleLexerNextToken(&lexer, &token);
+            continue;
+        }
+
+        if (!noodleParseValue(pAllocator, &lexer, &token, NULL, pIdentifier, pGroup, &pErrorExpected))
+        {
+            if (pErrorExpected) goto cleanupParse;
+            goto cleanupMemory;
+        }
+
+        noodleLexerNextToken(&lexer, &token);
+
+        if (token.kind == NOODLE_TOKEN_KIND_COMMA)
+            noodleLexerNextToken(&lexer, &token);
+    }
+
+    noodleGroupShrink(pAllocator, pGroup);
+    NOODLE_PROBE3(group__parsed, pGroup->base.pName, pGroup->count, 1);
+
+    return NOODLE_TRUE;
+
+cleanupMemory:
+    snprintf(pErrorBuffer, bufferSize, "Could not allocate memory!");
+    noodleGroupClear(pAllocator, pGroup);
+    return NOODLE_FALSE;
+
+cleanupParse:
+    snprintf(pErrorBuffer, bufferSize, "(Ln %zu, Col %zu) Unexpected token found, \"%.*s\", expected token, \"%s\"!", lexer.line, lexer.character, noodleTokenPrintLength(&token), pRoot->pSource + token.start, pErrorExpected);
+    noodleGroupClear(pAllocator, pGroup);
+    return NOODLE_FALSE;
+
+cleanupInclude:
+    noodleGroupClear(pAllocator, pGroup);
+    return NOODLE_FALSE;
+}
+
+NOODLE_BOOL noodleGroupReady(const NoodleGroup_t* pGroup)
+{
+    if (!pGroup->lazy) return NOODLE_TRUE;
+
+    NoodleLazyGroup_t* pLazy = (NoodleLazyGroup_t*)pGroup;
+
+    long state = NOODLE_LOAD_ACQUIRE(&pLazy->state);
+    if (state != NOODLE_LAZY_PENDING) return state == NOODLE_LAZY_READY;
+
+    const Noodle_t* pNoodle = &pGroup->base;
+    while (pNoodle->pParent)
+        pNoodle = (const Noodle_t*)pNoodle->pParent;
+
+    NoodleRoot_t* pRoot = (NoodleRoot_t*)pNoodle;
+
+    // Another thread may have parsed the group while this one waited
+    noodleMutexLock(&pRoot->lock);
+
+    state = pLazy->state;
+
+    if (state == NOODLE_LAZY_PENDING)
+    {
+        size_t index = (size_t)(pLazy - pRoot->pLazyGroups);
+
+        // Errors can't be reported from here, the group just stays empty
+        state = noodleLazyParse(pRoot, &pLazy->group, pLazy->start, index + 1, NULL, 0) ? NOODLE_LAZY_READY : NOODLE_LAZY_FAILED;
+        NOODLE_STORE_RELEASE(&pLazy->state, state);
+    }
+
+    noodleMutexUnlock(&pRoot->lock);
+
+    return state == NOODLE_LAZY_READY;
+}
+
+void noodleGroupClear(const NoodleAllocator_t* pAllocator, NoodleGroup_t* pGroup)
+{
+    noodleFreePending(pAllocator, noodleGroupRelease(pAllocator, pGroup, NULL));
+}
+
+Noodle_t* noodleGroupRelease(const NoodleAllocator_t* pAllocator, NoodleGroup_t* pGroup, Noodle_t* pPending)
+{
+    // Names belong to the document's string table and are not freed here
+    for (size_t i = 0; i < pGroup->count; i++)
+    {
+        NoodleValue_t* pEntry = &pGroup->pEntries[i];
+
+        switch (pEntry->base.type)
+        {
+            case NOODLE_TYPE_GROUP:
+            case NOODLE_TYPE_ARRAY:
+                if (!noodleOwns(pGroup, pEntry)) break;
+
+                // Ownership was just checked, so the parent can be reused as the link
+                pEntry->pChild->pParent = (NoodleGroup_t*)pPending;
+                pPending = pEntry->pChild;
+                break;
+            case NOODLE_TYPE_STRING:
+                noodleDealloc(pAllocator, pEntry->s);
+                break;
+            default:
+                break;
+        }
+    }
+
+    noodleDealloc(pAllocator, pGroup->pEntries);
+    noodleDealloc(pAllocator, pGroup->pIndex);
+    noodleDealloc(pAllocator, pGroup->pFrozen);
+
+    pGroup->count = 0;
+    pGroup->capacity = 0;
+    pGroup->indexCapacity = 0;
+    pGroup->pEntries = NULL;
+    pGroup->pIndex = NULL;
+    pGroup->pFrozen = NULL;
+
+    return pPending;
+}
+
+NoodleRoot_t* noodleRootOf(const Noodle_t* pNoodle)
+{
+    while (pNoodle->pParent)
+        pNoodle = (const Noodle_t*)pNoodle->pParent;
+
+    return (NoodleRoot_t*)pNoodle;
+}
+
+Noodle_t* noodleOverlayFrom(const NoodleOverlay_t* pOverlay, const char* pName)
+{
+    size_t hash = noodleGroupHashFunction(pName);
+
+    // The layers never change, so a group merged once stays the answer
+    NoodleOverlay_t* pMerged = noodleOverlayFind(NOODLE_LOAD_ACQUIRE_POINTER(&pOverlay->pTable), hash, pName);
+    if (pMerged) return (Noodle_t*)pMerged;
+
+    Noodle_t* pFound = NULL;
+    size_t groups = 0;
+
+    // A value that isn't a group hides everything with its name below it
+    for (size_t i = pOverlay->count; i-- > 0;)
+    {
+        Noodle_t* pNoodle = noodleFromHashed(pOverlay->ppLayers[i], pName, hash);
+        if (!pNoodle) continue;
+
+        if (pNoodle->type != NOODLE_TYPE_GROUP)
+        {
+            if (!pFound) return pNoodle;
+            break;
+        }
+
+        if (!pFound) pFound = pNoodle;
+        groups++;
+    }
+
+    // A group found in a single layer is shared as is
+    if (groups <= 1) return pFound;
+
+    NoodleRoot_t* pRoot = noodleRootOf(&pOverlay->root.group.base);
+    NoodleOverlay_t* pMutable = (NoodleOverlay_t*)pOverlay;
+
+    noodleMutexLock(&pRoot->lock);
+
+    // Another thread may have merged it while this one searched the layers
+    NoodleOverlay_t* pChild = noodleOverlayFind(pMutable->pTable, hash, pName);
+
+    if (!pChild)
+    {
+        pChild = noodleAlloc(&pRoot->allocator, sizeof(NoodleOverlay_t) + sizeof(NoodleGroup_t*) * groups);
+
+        if (pChild)
+        {
+            memset(pChild, 0, sizeof(NoodleOverlay_t));
+
+            pChild->root.group.base.type = NOODLE_TYPE_GROUP;
+            pChild->root.group.base.pParent = (NoodleGroup_t*)&pOverlay->root.group;
+            pChild->root.group.base.pName = pFound->pName;
+            pChild->root.group.overlay = NOODLE_TRUE;
+            pChild->root.allocator = pRoot->allocator;
+            pChild->ppLayers = (const NoodleGroup_t**)(pChild + 1);
+
+            // The groups are gathered again from the bottom so they keep the layer order
+            size_t first = 0;
+
+            for (size_t i = pOverlay->count; i-- > 0;)
+            {
+                Noodle_t* pNoodle = noodleFromHashed(pOverlay->ppLayers[i], pName, hash);
+                if (!pNoodle) continue;
+                if (pNoodle->type != NOODLE_TYPE_GROUP) break;
+
+                first = i;
+            }
+
+            for (size_t i = first; i < pOverlay->count; i++)
+            {
+                Noodle_t* pNoodle = noodleFromHashed(pOverlay->ppLayers[i], pName, hash);
+                if (pNoodle) pChild->ppLayers[pChild->count++] = (const NoodleGroup_t*)pNoodle;
+            }
+
+            pChild->pNext = pMutable->pChildren;
+            pMutable->pChildren = pChild;
+
+            // Without room in the table the child is still owned through the list,
+            // it's just merged again on the next lookup
+            noodleOverlayInsert(&pRoot->allocator, pMutable, pChild, hash);
+        }
+    }
+
+    noodleMutexUnlock(&pRoot->lock);
+
+    return (Noodle_t*)pChild;
+}
+
+NoodleOverlay_t* noodleOverlayFind(const NoodleOverlayTable_t* pTable, size_t hash, const char* pName)
+{
+    if (!pTable) return NULL;
+
+    size_t mask = pTable->capacity - 1;
+
+    for (size_t i = (size_t)noodleHashMix(hash) & mask;; i = (i + 1) & mask)
+    {
+        NoodleOverlay_t* pChild = NOODLE_LOAD_ACQUIRE_POINTER(&pTable->pSlots[i]);
+        if (!pChild) return NULL;
+
+        const char* pChildName = pChild->root.group.base.pName;
+
+        // Names of merged groups come from a layer's string table, which stores their hash
+        if (noodleStringHeader(pChildName)->hash == hash && strcmp(pChildName, pName) == 0) return pChild;
+    }
+}
+
+NOODLE_BOOL noodleOverlayInsert(const NoodleAllocator_t* pAllocator, NoodleOverlay_t* pOverlay, NoodleOverlay_t* pChild, size_t hash)
+{
+    // Only called with the lock held, readers may be probing the table meanwhile
+    NoodleOverlayTable_t* pTable = pOverlay->pTable;
+
+    // Kept at most half full so probes stay short and always end at an empty slot
+    if (!pTable || (pTable->count + 1) * 2 > pTable->capacity)
+    {
+        size_t capacity = pTable ? pTable->capacity * 2 : NOODLE_GROUP_INITIAL_CAPACITY * 2;
+
+        NoodleOverlayTable_t* pLarger = noodleAlloc(pAllocator, sizeof(NoodleOverlayTable_t) + sizeof(NoodleOverlay_t*) * capacity);
+        if (!pLarger) return NOODLE_FALSE;
+
+        memset(pLarger, 0, sizeof(NoodleOverlayTable_t) + sizeof(NoodleOverlay_t*) * capacity);
+        pLarger->capacity = capacity;
+        pLarger->pPrevious = pTable;
+
+        for (size_t i = 0; pTable && i < pTable->capacity; i++)
+        {
+            NoodleOverlay_t* pMoved = pTable->pSlots[i];
+            if (!pMoved) continue;
+
+            size_t slot = (size_t)noodleHashMix(noodleStringHeader(pMoved->root.group.base.pName)->hash) & (capacity - 1);
+            while (pLarger->pSlots[slot]) slot = (slot + 1) & (capacity - 1);
+
+            pLarger->pSlots[slot] = pMoved;
+            pLarger->count++;
+        }
+
+        NOODLE_STORE_RELEASE_POINTER(&pOverlay->pTable, pLarger);
+        pTable = pLarger;
+    }
+
+    size_t mask = pTable->capacity - 1;
+    size_t slot = (size_t)noodleHashMix(hash) & mask;
+    while (pTable->pSlots[slot]) slot = (slot + 1) & mask;
+
+    // The child is finished before readers can see it
+    pTable->count++;
+    NOODLE_STORE_RELEASE_POINTER(&pTable->pSlots[slot], pChild);
+
+    return NOODLE_TRUE;
+}
+
+void noodleOverlayFree(NoodleOverlay_t* pOverlay)
+{
+    // Only the top overlay holds the lock
+    noodleMutexDestroy(&pOverlay->root.lock);
+
+    // Nested overlays are moved onto the list being freed, so it's never 
+    // recursive however deep they go
+    NoodleOverlay_t* pPending = pOverlay;
+    pOverlay->pNext = NULL;
+
+    while (pPending)
+    {
+        NoodleOverlay_t* pCurrent = pPending;
+        NoodleAllocator_t allocator = pCurrent->root.allocator;
+        pPending = pCurrent->pNext;
+
+        for (NoodleOverlayTable_t* pTable = pCurrent->pTable; pTable;)
+        {
+            NoodleOverlayTable_t* pPrevious = pTable->pPrevious;
+            noodleDealloc(&allocator, pTable);
+            pTable = pPrevious;
+        }
+
+        for (NoodleOverlay_t* pChild = pCurrent->pChildren; pChild;)
+        {
+            NoodleOverlay_t* pNext = pChild->pNext;
+            pChild->pNext = pPending;
+            pPending = pChild;
+            pChild = pNext;
+        }
+
+        noodleDealloc(&allocator, pCurrent);
+    }
+}
+
+NOODLE_BOOL noodleVisit(const NoodleGroup_t* pGroup, NoodleVisitFunction_t visit, void* pUser)
+{
+    if (!pGroup->overlay)
+    {
+        if (!noodleGroupReady(pGroup)) return NOODLE_TRUE;
+
+        for (size_t i = 0; i < pGroup->count; i++)
+        {
+            if (!visit(pUser, noodleEntryNoodle(&pGroup->pEntries[i]))) return NOODLE_FALSE;
+        }
+
+        return NOODLE_TRUE;
+    }
+
+    // Keys are visited in the order of the lowest layer they appear in
+    const NoodleOverlay_t* pOverlay = (const NoodleOverlay_t*)pGroup;
+
+    for (size_t i = 0; i < pOverlay->count; i++)
+    {
+        NoodleVisitLayer_t layer = {pOverlay, i, visit, pUser};
+
+        // Layers can be overlays as well so they're visited the same way
+        if (!noodleVisit(pOverlay->ppLayers[i], noodleVisitLayer, &layer)) return NOODLE_FALSE;
+    }
+
+    return NOODLE_TRUE;
+}
+
+NOODLE_BOOL noodleVisitLayer(void* pUser, Noodle_t* pNoodle)
+{
+    NoodleVisitLayer_t* pLayer = pUser;
+    const NoodleOverlay_t* pOverlay = pLayer->pOverlay;
+    const char* pName = pNoodle->pName;
+
+    // Keys also found in a lower layer were visited already
+    for (size_t j = 0; j < pLayer->index; j++)
+    {
+        if (noodleFrom(pOverlay->ppLayers[j], pName)) return NOODLE_TRUE;
+    }
+
+    Noodle_t* pResolved = noodleOverlayFrom(pOverlay, pName);
+    if (!pResolved) return NOODLE_FALSE;
+
+    return pLayer->visit(pLayer->pUser, pResolved);
+}
+
+NOODLE_BOOL noodleVisitForeach(void* pUser, Noodle_t* pNoodle)
+{
+    NoodleForeachGroupCallback_t callback = *(NoodleForeachGroupCallback_t*)pUser;
+    return callback(pNoodle);
+}
+
+NOODLE_BOOL noodleVisitCount(void* pUser, Noodle_t* pNoodle)
+{
+    (void)pNoodle;
+    (*(size_t*)pUser)++;
+
+    return NOODLE_TRUE;
+}
+
+NOODLE_BOOL noodleVisitCopy(void* pUser, Noodle_t* pNoodle)
+{
+    NoodleCopy_t* pCopy = pUser;
+    const NoodleAllocator_t* pAllocator = &pCopy->pRoot->allocator;
+
+    // The copy has its own string table, the names are interned again
+    char* pName = noodleStringTableIntern(pCopy->pRoot->pStrings, pNoodle->pName, strlen(pNoodle->pName));
+    if (!pName) return NOODLE_FALSE;
+
+    const NoodleValue_t* pValue = (const NoodleValue_t*)pNoodle;
+
+    switch (pNoodle->type)
+    {
+        case NOODLE_TYPE_GROUP:
+        {
+            NoodleGroup_t* pGroup = noodleGroup(pAllocator, pName, pCopy->pTarget);
+            if (!pGroup) return NOODLE_FALSE;
+
+            NoodleCopy_t inner = {pCopy->pRoot, pGroup};
+            if (!noodleVisit((const NoodleGroup_t*)pNoodle, noodleVisitCopy, &inner)) return NOODLE_FALSE;
+
+            noodleGroupShrink(pAllocator, pGroup);
+            return NOODLE_TRUE;
+        }
+        case NOODLE_TYPE_ARRAY:
+            return noodleArrayCopy(pAllocator, (const NoodleArray_t*)pNoodle, pName, pCopy->pTarget);
+        case NOODLE_TYPE_INTEGER:
+            return noodleInt(pAllocator, pName, pValue->i, pCopy->pTarget) != NULL;
+        case NOODLE_TYPE_FLOAT:
+            return noodleFloat(pAllocator, pName, pValue->f, pCopy->pTarget) != NULL;
+        case NOODLE_TYPE_BOOLEAN:
+            return noodleBool(pAllocator, pName, pValue->b, pCopy->pTarget) != NULL;
+        case NOODLE_TYPE_STRING:
+        {
+            char* pString = noodleStringDuplicate(pAllocator, pValue->s);
+            if (!pString) return NOODLE_FALSE;
+
+            if (!noodleString(pAllocator, pName, pString, pCopy->pTarget))
+            {
+                noodleDealloc(pAllocator, pString);
+                return NOODLE_FALSE;
+            }
+
+            return NOODLE_TRUE;
+        }
+        default:
+            return NOODLE_FALSE;
+    }
+}
+
+NOODLE_BOOL noodleVisitFingerprint(void* pUser, Noodle_t* pNoodle)
+{
+    NoodleFingerprint_t* pFingerprint = pUser;
+
+    // The name is mixed in with the value so swapping two values changes the sum
+    uint64_t name = (uint64_t)noodleStringHeader(pNoodle->pName)->hash;
+
+    pFingerprint->sum += noodleHashMix(noodleHashMix(name) ^ noodleFingerprint(pNoodle));
+    pFingerprint->count++;
+
+    return NOODLE_TRUE;
+}
+
+uint64_t noodleGroupFingerprint(const NoodleGroup_t* pGroup)
+{
+    uint64_t fingerprint = NOODLE_LOAD_ACQUIRE64(&pGroup->fingerprint);
+    if (fingerprint) return fingerprint;
+
+    // Nested groups are cached as well, so this only recurses the first time
+    NoodleFingerprint_t entries = {0, 0};
+    noodleVisit(pGroup, noodleVisitFingerprint, &entries);
+
+    fingerprint = noodleHashMix(entries.sum ^ noodleHashMix(entries.count + NOODLE_TYPE_GROUP));
+    if (!fingerprint) fingerprint = 1; // Zero is kept for not computed yet
+
+    // Racing threads compute the same value, so either store is fine
+    NOODLE_STORE_RELEASE64(&((NoodleGroup_t*)pGroup)->fingerprint, fingerprint);
+
+    return fingerprint;
+}
+
+uint64_t noodleArrayFingerprint(const NoodleArray_t* pArray)
+{
+    // Unlike keys the order of elements matters
+    uint64_t fingerprint = noodleHashMix(((uint64_t)pArray->type << 32) ^ pArray->count ^ NOODLE_TYPE_ARRAY);
+
+    for (size_t i = 0; i < pArray->count; i++)
+    {
+        const void* pValue = NULL;
+
+        switch (pArray->type)
+        {
+            case NOODLE_TYPE_INTEGER: pValue = &pArray->pIntegers[i]; break;
+            case NOODLE_TYPE_FLOAT: pValue = &pArray->pFloats[i]; break;
+            case NOODLE_TYPE_BOOLEAN: pValue = &pArray->pBooleans[i]; break;
+            case NOODLE_TYPE_STRING: pValue = &pArray->ppStrings[i]; break;
+            default: break;
+        }
+
+        fingerprint = noodleHashMix(fingerprint + noodleElementFingerprint(pArray->type, pValue));
+    }
+
+    return fingerprint;
+}
+
+uint64_t noodleElementFingerprint(NoodleType_t type, const void* pValue)
+{
+    uint64_t bits = 0;
+
+    switch (type)
+    {
+        case NOODLE_TYPE_INTEGER:
+            bits = (uint32_t)*(const int*)pValue;
+            break;
+        case NOODLE_TYPE_FLOAT:
+        {
+            // Compared by their bits, like memcmp would
+            uint32_t floatBits = 0;
+            memcpy(&floatBits, pValue, sizeof(float));
+            bits = floatBits;
+            break;
+        }
+        case NOODLE_TYPE_BOOLEAN:
+            bits = *(const NOODLE_BOOL*)pValue ? 1 : 0;
+            break;
+        case NOODLE_TYPE_STRING:
+        {
+            const char* pStr = *(char* const*)pValue;
+            bits = (uint64_t)noodleHashBytes(pStr, strlen(pStr)) ^ ((uint64_t)strlen(pStr) << 40);
+            break;
+        }
+        default:
+            break;
+    }
+
+    return noodleHashMix(bits ^ ((uint64_t)type << 56));
+}
+
+NOODLE_BOOL noodleDiffGroups(NoodleDiff_t* pDiff, const NoodleGroup_t* pOld, const NoodleGroup_t* pNew)
+{
+    // Unchanged subtrees are skipped whole, so only the changed paths are walked
+    if (noodleGroupFingerprint(pOld) == noodleGroupFingerprint(pNew)) return NOODLE_TRUE;
+
+    NoodleDiffLevel_t level = {pDiff, pOld, pNew, NOODLE_FALSE};
+    if (!noodleVisit(pOld, noodleVisitDiff, &level)) return NOODLE_FALSE;
+
+    level.added = NOODLE_TRUE;
+    return noodleVisit(pNew, noodleVisitDiff, &level);
+}
+
+NOODLE_BOOL noodleDiffPush(NoodleDiff_t* pDiff, const char* pName)
+{
+    size_t nameLength = strlen(pName);
+    size_t needed = pDiff->length + 1 + nameLength + 1; // Separator and null-terminator
+
+    if (needed > pDiff->capacity)
+    {
+        size_t capacity = pDiff->capacity ? pDiff->capacity * 2 : 64;
+        if (capacity < needed) capacity = needed;
+
+        char* pPath = noodleRealloc(pDiff->pAllocator, pDiff->pPath, capacity);
+        if (!pPath) return NOODLE_FALSE;
+
+        pDiff->pPath = pPath;
+        pDiff->capacity = capacity;
+    }
+
+    if (pDiff->length) pDiff->pPath[pDiff->length++] = '.';
+
+    memcpy(pDiff->pPath + pDiff->length, pName, nameLength + 1);
+    pDiff->length += nameLength;
+
+    return NOODLE_TRUE;
+}
+
+NOODLE_BOOL noodleVisitDiff(void* pUser, Noodle_t* pNoodle)
+{
+    NoodleDiffLevel_t* pLevel = pUser;
+    NoodleDiff_t* pDiff = pLevel->pDiff;
+    const NoodleGroup_t* pSelf = pLevel->added ? pLevel->pNew : pLevel->pOld;
+    const NoodleGroup_t* pOther = pLevel->added ? pLevel->pOld : pLevel->pNew;
+
+    // Only the first of duplicate keys can be looked up, so only it is compared
+    if (noodleFrom(pSelf, pNoodle->pName) != pNoodle) return NOODLE_TRUE;
+
+    const Noodle_t* pMatch = noodleFrom(pOther, pNoodle->pName);
+
+    // Keys found in both groups were compared while visiting the old one
+    if (pLevel->added && pMatch) return NOODLE_TRUE;
+
+    size_t length = pDiff->length;
+    if (!noodleDiffPush(pDiff, pNoodle->pName)) return NOODLE_FALSE;
+
+    NOODLE_BOOL resume = NOODLE_TRUE;
+
+    if (pLevel->added)
+        resume = pDiff->callback(pDiff->pUser, NOODLE_CHANGE_ADDED, pDiff->pPath, NULL, pNoodle);
+    else if (!pMatch)
+        resume = pDiff->callback(pDiff->pUser, NOODLE_CHANGE_REMOVED, pDiff->pPath, pNoodle, NULL);
+    else if (pNoodle->type == NOODLE_TYPE_GROUP && pMatch->type == NOODLE_TYPE_GROUP)
+        resume = noodleDiffGroups(pDiff, (const NoodleGroup_t*)pNoodle, (const NoodleGroup_t*)pMatch);
+    else if (!noodleEqual(pNoodle, pMatch))
+        resume = pDiff->callback(pDiff->pUser, NOODLE_CHANGE_CHANGED, pDiff->pPath, pNoodle, pMatch);
+
+    pDiff->length = length;
+    pDiff->pPath[length] = '\0';
+
+    return resume;
+}
+
+NOODLE_BOOL noodleEqual(const Noodle_t* pA, const Noodle_t* pB)
+{
+    if (pA->type != pB->type) return NOODLE_FALSE;
+
+    const NoodleValue_t* pValueA = (const NoodleValue_t*)pA;
+    const NoodleValue_t* pValueB = (const NoodleValue_t*)pB;
+
+    switch (pA->type)
+    {
+        case NOODLE_TYPE_GROUP:
+            return noodleGroupFingerprint((const NoodleGroup_t*)pA) == noodleGroupFingerprint((const NoodleGroup_t*)pB);
+        case NOODLE_TYPE_ARRAY:
+        {
+            const NoodleArray_t* pArrayA = (const NoodleArray_t*)pA;
+            const NoodleArray_t* pArrayB = (const NoodleArray_t*)pB;
+
+            if (pArrayA->type != pArrayB->type || pArrayA->count != pArrayB->count) return NOODLE_FALSE;
+            if (pArrayA->count == 0) return NOODLE_TRUE;
+
+            switch (pArrayA->type)
+            {
+                case NOODLE_TYPE_INTEGER: return memcmp(pArrayA->pIntegers, pArrayB->pIntegers, sizeof(int) * pArrayA->count) == 0;
+                case NOODLE_TYPE_FLOAT: return memcmp(pArrayA->pFloats, pArrayB->pFloats, sizeof(float) * pArrayA->count) == 0;
+                case NOODLE_TYPE_BOOLEAN: return memcmp(pArrayA->pBooleans, pArrayB->pBooleans, sizeof(NOODLE_BOOL) * pArrayA->count) == 0;
+                case NOODLE_TYPE_STRING:
+                    for (size_t i = 0; i < pArrayA->count; i++)
+                        if (strcmp(pArrayA->ppStrings[i], pArrayB->ppStrings[i]) != 0) return NOODLE_FALSE;
+                    return NOODLE_TRUE;
+                default:
+                    return NOODLE_FALSE;
+            }
+        }
+        case NOODLE_TYPE_INTEGER:
+            return pValueA->i == pValueB->i;
+        case NOODLE_TYPE_FLOAT:
+            return memcmp(&pValueA->f, &pValueB->f, sizeof(float)) == 0;
+        case NOODLE_TYPE_BOOLEAN:
+            return !pValueA->b == !pValueB->b;
+        case NOODLE_TYPE_STRING:
+            return strcmp(pValueA->s, pValueB->s) == 0;
+        default:
+            return NOODLE_FALSE;
+    }
+}
+
+void noodleQueryMatch(NoodleQueryRun_t* pRun, const NoodleGroup_t* pGroup, size_t step)
+{
+    const NoodleQueryStep_t* pStep = &pRun->pQuery->pSteps[step];
+
+    // Matching the same group against the same step again finds the same matches
+    if (pRun->pQuery->descents > 1 && !noodleQueryVisit(pRun, pGroup, step)) return;
+
+    switch (pStep->kind)
+    {
+        case NOODLE_QUERY_STEP_KEY:
+        {
+            // Only the one key is looked at, nothing else in the group is visited
+            Noodle_t* pNoodle = NULL;
+
+            if (pGroup->overlay)
+            {
+                pNoodle = noodleFrom(pGroup, pStep->pName);
+            }
+            else
+            {
+                NoodleValue_t* pEntry = noodleGroupFind(pGroup, pStep->hash, pStep->pName, NOODLE_FALSE);
+                if (pEntry) pNoodle = noodleEntryNoodle(pEntry);
+            }
+
+            if (pNoodle) noodleQueryMatched(pRun, pNoodle, step);
+            break;
+        }
+        case NOODLE_QUERY_STEP_ANY:
+        {
+            NoodleQueryLevel_t level = {pRun, step};
+            noodleVisit(pGroup, noodleVisitQueryAny, &level);
+            break;
+        }
+        case NOODLE_QUERY_STEP_DESCENDANTS:
+        {
+            // Either no group is skipped, or a nested one is matched against the same step
+            noodleQueryMatch(pRun, pGroup, step + 1);
+
+            NoodleQueryLevel_t level = {pRun, step};
+            noodleVisit(pGroup, noodleVisitQueryDescendants, &level);
+            break;
+        }
+    }
+}
+
+NOODLE_BOOL noodleQueryVisit(NoodleQueryRun_t* pRun, const NoodleGroup_t* pGroup, size_t step)
+{
+    if (pRun->failed) return NOODLE_FALSE;
+
+    // Kept at most half full so probes stay short
+    if ((pRun->visitCount + 1) * 2 > pRun->visitCapacity)
+    {
+        size_t capacity = pRun->visitCapacity ? pRun->visitCapacity * 2 : NOODLE_GROUP_INITIAL_CAPACITY * 16;
+
+        NoodleQueryVisit_t* pVisits = noodleAlloc(&pRun->pQuery->allocator, sizeof(NoodleQueryVisit_t) * capacity);
+        if (!pVisits)
+        {
+            pRun->failed = NOODLE_TRUE;
+            return NOODLE_FALSE;
+        }
+
+        memset(pVisits, 0, sizeof(NoodleQueryVisit_t) * capacity);
+
+        for (size_t i = 0; i < pRun->visitCapacity; i++)
+        {
+            NoodleQueryVisit_t* pVisit = &pRun->pVisits[i];
+            if (!pVisit->pGroup) continue;
+
+            size_t slot = (size_t)noodleHashMix((uint64_t)(uintptr_t)pVisit->pGroup ^ pVisit->step) & (capacity - 1);
+            while (pVisits[slot].pGroup) slot = (slot + 1) & (capacity - 1);
+
+            pVisits[slot] = *pVisit;
+        }
+
+        noodleDealloc(&pRun->pQuery->allocator, pRun->pVisits);
+        pRun->pVisits = pVisits;
+        pRun->visitCapacity = capacity;
+    }
+
+    size_t mask = pRun->visitCapacity - 1;
+    size_t slot = (size_t)noodleHashMix((uint64_t)(uintptr_t)pGroup ^ step) & mask;
+
+    for (; pRun->pVisits[slot].pGroup; slot = (slot + 1) & mask)
+    {
+        if (pRun->pVisits[slot].pGroup == pGroup && pRun->pVisits[slot].step == step) return NOODLE_FALSE;
+    }
+
+    pRun->pVisits[slot].pGroup = pGroup;
+    pRun->pVisits[slot].step = step;
+    pRun->visitCount++;
+
+    return NOODLE_TRUE;
+}
+
+void noodleQueryMatched(NoodleQueryRun_t* pRun, Noodle_t* pNoodle, size_t step)
+{
+    if (step + 1 == pRun->pQuery->count)
+    {
+        if (pRun->count < pRun->capacity) pRun->ppResults[pRun->count] = pNoodle;
+        pRun->count++;
+        return;
+    }
+
+    // Steps are left but only groups have keys, so the subtree can't match
+    if (pNoodle->type == NOODLE_TYPE_GROUP)
+        noodleQueryMatch(pRun, (const NoodleGroup_t*)pNoodle, step + 1);
+}
+
+NOODLE_BOOL noodleVisitQueryAny(void* pUser, Noodle_t* pNoodle)
+{
+    NoodleQueryLevel_t* pLevel = pUser;
+
+    noodleQueryMatched(pLevel->pRun, pNoodle, pLevel->step);
+    return NOODLE_TRUE;
+}
+
+NOODLE_BOOL noodleVisitQueryDescendants(void* pUser, Noodle_t* pNoodle)
+{
+    NoodleQueryLevel_t* pLevel = pUser;
+
+    if (pNoodle->type == NOODLE_TYPE_GROUP)
+        noodleQueryMatch(pLevel->pRun, (const NoodleGroup_t*)pNoodle, pLevel->step);
+
+    return NOODLE_TRUE;
+}
+
+void noodleWriterPut(NoodleWriter_t* pWriter, const char* pData, size_t size)
+{
+    if (size > NOODLE_WRITER_CAPACITY - pWriter->size)
+    {
+        noodleWriterFlush(pWriter);
+
+        // Too large to be worth copying through the buffer
+        if (size >= NOODLE_WRITER_CAPACITY)
+        {
+            if (!pWriter->failed && pWriter->write(pWriter->pUser, pData, size) != size) pWriter->failed = NOODLE_TRUE;
+            return;
+        }
+    }
+
+    memcpy(pWriter->pBuffer + pWriter->size, pData, size);
+    pWriter->size += size;
+}
+
+void noodleWriterFlush(NoodleWriter_t* pWriter)
+{
+    // After a failure the output is dropped, the converter reports it at the end
+    if (pWriter->size && !pWriter->failed && pWriter->write(pWriter->pUser, pWriter->pBuffer, pWriter->size) != pWriter->size)
+        pWriter->failed = NOODLE_TRUE;
+
+    pWriter->size = 0;
+}
+
+void noodleWriterIndent(NoodleWriter_t* pWriter, size_t depth)
+{
+    static const char pSpaces[] = "                                ";
+
+    for (size_t spaces = depth * 4; spaces > 0;)
+    {
+        size_t size = spaces < sizeof(pSpaces) - 1 ? spaces : sizeof(pSpaces) - 1;
+
+        noodleWriterPut(pWriter, pSpaces, size);
+        spaces -= size;
+    }
+}
+
+void noodleJsonPutNumber(NoodleWriter_t* pWriter, const char* pNumber, size_t length)
+{
+    // JSON allows neither leading zeros nor a dot without digits after it
+    while (length > 1 && pNumber[0] == '0' && pNumber[1] != '.')
+    {
+        pNumber++;
+        length--;
+    }
+
+    noodleWriterPut(pWriter, pNumber, length);
+
+    if (pNumber[length - 1] == '.') noodleWriterPut(pWriter, "0", 1);
+}
+
+void noodleJsonPutString(NoodleWriter_t* pWriter, const char* pString, size_t length)
+{
+    noodleWriterPut(pWriter, "\"", 1);
+
+    // Runs that need no escaping are written in one piece. The string is as
+    // it was written in noodle, whose escapes are the same as JSON's.
+    size_t run = 0;
+
+    for (size_t i = 0; i < length; i++)
+    {
+        unsigned char c = (unsigned char)pString[i];
+        if (c >= 0x20 && c != '\\') continue;
+
+        // Escapes are passed through with the character after the backslash
+        if (c == '\\')
+        {
+            i++;
+            continue;
+        }
+
+        noodleWriterPut(pWriter, pString + run, i - run);
+        run = i + 1;
+
+        char pEscape[8];
+
+        switch (c)
+        {
+            case '\n': noodleWriterPut(pWriter, "\\n", 2); break;
+            case '\r': noodleWriterPut(pWriter, "\\r", 2); break;
+            case '\t': noodleWriterPut(pWriter, "\\t", 2); break;
+            default:
+                snprintf(pEscape, sizeof(pEscape), "\\u%04x", c);
+                noodleWriterPut(pWriter, pEscape, 6);
+                break;
+        }
+    }
+
+    noodleWriterPut(pWriter, pString + run, length - run);
+    noodleWriterPut(pWriter, "\"", 1);
+}
+
+char noodleJsonPeek(const char* pContent, size_t length, size_t position)
+{
+    return position < length ? pContent[position] : '\0';
+}
+
+size_t noodleJsonSkipSpaces(const char* pContent, size_t length, size_t position)
+{
+    for (;; position++)
+    {
+        switch (noodleJsonPeek(pContent, length, position))
+        {
+            case ' ':
+            case '\n':
+            case '\r':
+            case '\t':
+                continue;
+            default:
+                return position;
+        }
+    }
+}
+
+NOODLE_BOOL noodleJsonValue(NoodleWriter_t* pWriter, const char* pContent, size_t length, size_t* pPosition, NOODLE_BOOL asFloat, NoodleType_t* pType, const char** ppErrorExpected)
+{
+    size_t position = *pPosition;
+    char c = noodleJsonPeek(pContent, length, position);
+
+    if (c == '\"')
+    {
+        *pType = NOODLE_TYPE_STRING;
+        return noodleJsonString(pWriter, pContent, length, pPosition, ppErrorExpected);
+    }
+
+    if (c >= '0' && c <= '9')
+    {
+        *pType = asFloat ? NOODLE_TYPE_FLOAT : NOODLE_TYPE_INTEGER;
+        return noodleJsonNumber(pWriter, pContent, length, pPosition, asFloat, ppErrorExpected);
+    }
+
+    if (length - position >= 4 && strncmp(pContent + position, "true", 4) == 0)
+    {
+        *pType = NOODLE_TYPE_BOOLEAN;
+        *pPosition = position + 4;
+        noodleWriterPut(pWriter, "true", 4);
+        return NOODLE_TRUE;
+    }
+
+    if (length - position >= 5 && strncmp(pContent + position, "false", 5) == 0)
+    {
+        *pType = NOODLE_TYPE_BOOLEAN;
+        *pPosition = position + 5;
+        noodleWriterPut(pWriter, "false", 5);
+        return NOODLE_TRUE;
+    }
+
+    // Anything else JSON has can't be written in noodle
+    switch (c)
+    {
+        case '-': *ppErrorExpected = "Value, noodle has no negative numbers"; break;
+        case 'n': *ppErrorExpected = "Value, noodle has no null"; break;
+        case '{':
+        case '[': *ppErrorExpected = "Integer, Float, Boolean, or String"; break;
+        default: *ppErrorExpected = "Value"; break;
+    }
+
+    return NOODLE_FALSE;
+}
+
+NOODLE_BOOL noodleJsonNumber(NoodleWriter_t* pWriter, const char* pContent, size_t length, size_t* pPosition, NOODLE_BOOL asFloat, const char** ppErrorExpected)
+{
+    size_t position = *pPosition;
+    size_t integerStart = position;
+
+    // JSON doesn't allow leading zeros, so a zero is a whole integer part
+    if (noodleJsonPeek(pContent, length, position) == '0')
+        position++;
+    else
+        while (noodleJsonPeek(pContent, length, position) >= '0' && noodleJsonPeek(pContent, length, position) <= '9') position++;
+
+    size_t integerEnd = position;
+    size_t fractionStart = position;
+    size_t fractionEnd = position;
+
+    if (noodleJsonPeek(pContent, length, position) == '.')
+    {
+        fractionStart = ++position;
+
+        while (noodleJsonPeek(pContent, length, position) >= '0' && noodleJsonPeek(pContent, length, position) <= '9')
+            position++;
+
+        fractionEnd = position;
+
+        if (fractionEnd == fractionStart)
+        {
+            *pPosition = position;
+            *ppErrorExpected = "Digit";
+            return NOODLE_FALSE;
+        }
+    }
+
+    char e = noodleJsonPeek(pContent, length, position);
+
+    if (e != 'e' && e != 'E')
+    {
+        // The usual case, already written the way noodle writes it
+        noodleWriterPut(pWriter, pContent + integerStart, integerEnd - integerStart);
+
+        if (fractionEnd > fractionStart)
+        {
+            noodleWriterPut(pWriter, ".", 1);
+            noodleWriterPut(pWriter, pContent + fractionStart, fractionEnd - fractionStart);
+        }
+        else if (asFloat)
+        {
+            noodleWriterPut(pWriter, ".0", 2);
+        }
+
+        *pPosition = position;
+        return NOODLE_TRUE;
+    }
+
+    // Noodle has no exponents, the dot is moved through the digits instead
+    position++;
+
+    NOODLE_BOOL negative = noodleJsonPeek(pContent, length, position) == '-';
+    if (negative || noodleJsonPeek(pContent, length, position) == '+') position++;
+
+    size_t exponentStart = position;
+    long exponent = 0;
+
+    while (noodleJsonPeek(pContent, length, position) >= '0' && noodleJsonPeek(pContent, length, position) <= '9')
+    {
+        exponent = exponent * 10 + (noodleJsonPeek(pContent, length, position) - '0');
+        position++;
+
+        if (exponent > NOODLE_JSON_MAX_EXPONENT)
+        {
+            *pPosition = exponentStart;
+            *ppErrorExpected = "Exponent that fits a float";
+            return NOODLE_FALSE;
+        }
+    }
+
+    if (position == exponentStart)
+    {
+        *pPosition = position;
+        *ppErrorExpected = "Digit";
+        return NOODLE_FALSE;
+    }
+
+    if (negative) exponent = -exponent;
+
+    size_t integerLength = integerEnd - integerStart;
+    size_t digits = integerLength + (fractionEnd - fractionStart);
+    long point = (long)integerLength + exponent; // Digits before the dot
+
+    NOODLE_BOOL leading = NOODLE_TRUE;
+
+    for (long i = 0; i < point; i++)
+    {
+        size_t index = (size_t)i;
+        char digit = '0';
+
+        if (index < integerLength) digit = pContent[integerStart + index];
+        else if (index < digits) digit = pContent[fractionStart + index - integerLength];
+
+        // Leading zeros are left out, but not the last digit before the dot
+        if (leading && digit == '0' && i + 1 < point) continue;
+
+        leading = NOODLE_FALSE;
+        noodleWriterPut(pWriter, &digit, 1);
+    }
+
+    if (point <= 0) noodleWriterPut(pWriter, "0", 1);
+    noodleWriterPut(pWriter, ".", 1);
+
+    for (long i = point; i < 0; i++)
+        noodleWriterPut(pWriter, "0", 1);
+
+    size_t first = point > 0 ? (size_t)point : 0;
+    if (first >= digits) noodleWriterPut(pWriter, "0", 1);
+
+    for (size_t index = first; index < digits; index++)
+    {
+        char digit = index < integerLength ? pContent[integerStart + index] : pContent[fractionStart + index - integerLength];
+        noodleWriterPut(pWriter, &digit, 1);
+    }
+
+    *pPosition = position;
+    return NOODLE_TRUE;
+}
+
+NOODLE_BOOL noodleJsonString(NoodleWriter_t* pWriter, const char* pContent, size_t length, size_t* pPosition, const char** ppErrorExpected)
+{
+    size_t position = *pPosition + 1; // Past the opening quote
+    size_t run = position;
+
+    noodleWriterPut(pWriter, "\"", 1);
+
+    for (;;)
+    {
+        unsigned char c = (unsigned char)noodleJsonPeek(pContent, length, position);
+
+        if (c >= 0x20 && c != '\\' && c != '\"')
+        {
+            position++;
+            continue;
+        }
+
+        noodleWriterPut(pWriter, pContent + run, position - run);
+
+        if (c == '\"') break;
+
+        if (c != '\\')
+        {
+            *pPosition = position;
+            *ppErrorExpected = "\"";
+            return NOODLE_FALSE;
+        }
+
+        // Escapes are written out as the characters they stand for, other 
+        // than the quotes and backslashes noodle needs escaped as well and
+        // control characters, which are kept as escapes
+        char escaped = noodleJsonPeek(pContent, length, position + 1);
+        char replacement = '\0';
+
+        switch (escaped)
+        {
+            case '\"':
+            case '\\':
+            case 'b':
+            case 'f':
+                noodleWriterPut(pWriter, pContent + position, 2);
+                position += 2;
+                run = position;
+                continue;
+            case '/': replacement = '/'; break;
+            case 'n': replacement = '\n'; break;
+            case 'r': replacement = '\r'; break;
+            case 't': replacement = '\t'; break;
+            case 'u':
+            {
+                uint32_t codepoint;
+
+                if (!noodleJsonHex(pContent, length, position + 2, &codepoint))
+                {
+                    *pPosition = position + 2;
+                    *ppErrorExpected = "Four hexadecimal digits";
+                    return NOODLE_FALSE;
+                }
+
+                position += 6;
+
+                // A high surrogate is followed by the low half of the pair
+                uint32_t low;
+
+                if (codepoint >= 0xd800 && codepoint <= 0xdbff && 
+                    noodleJsonPeek(pContent, length, position) == '\\' && noodleJsonPeek(pContent, length, position + 1) == 'u' &&
+                    noodleJsonHex(pContent, length, position + 2, &low) && low >= 0xdc00 && low <= 0xdfff)
+                {
+                    codepoint = 0x10000 + ((codepoint - 0xd800) << 10) + (low - 0xdc00);
+                    position += 6;
+                }
+                else if (codepoint >= 0xd800 && codepoint <= 0xdfff)
+                {
+                    // Noodle strings are UTF-8, which has no lone surrogates
+                    *pPosition = position - 6;
+                    *ppErrorExpected = "Surrogate pair";
+                    return NOODLE_FALSE;
+                }
+                else if (codepoint == 0)
+                {
+                    // Noodle strings end at a null byte, so there's no way to hold one
+                    *pPosition = position - 6;
+                    *ppErrorExpected = "Character other than U+0000";
+                    return NOODLE_FALSE;
+                }
+
+                if (codepoint < 0x20)
+                {
+                    char pEscape[8];
+                    snprintf(pEscape, sizeof(pEscape), "\\u%04x", (unsigned)codepoint);
+                    noodleWriterPut(pWriter, pEscape, 6);
+                }
+                else
+                {
+                    noodleJsonPutCodepoint(pWriter, codepoint);
+                }
+
+                run = position;
+                continue;
+            }
+            default:
+                *pPosition = position + 1;
+                *ppErrorExpected = "Escape";
+                return NOODLE_FALSE;
+        }
+
+        noodleWriterPut(pWriter, &replacement, 1);
+        position += 2;
+        run = position;
+    }
+
+    noodleWriterPut(pWriter, "\"", 1);
+    *pPosition = position + 1;
+
+    return NOODLE_TRUE;
+}
+
+NOODLE_BOOL noodleJsonHex(const char* pContent, size_t length, size_t position, uint32_t* pUnit)
+{
+    uint32_t unit = 0;
+
+    for (size_t i = 0; i < 4; i++)
+    {
+        char hex = noodleJsonPeek(pContent, length, position + i);
+        unit <<= 4;
+
+        if (hex >= '0' && hex <= '9') unit |= (uint32_t)(hex - '0');
+        else if (hex >= 'a' && hex <= 'f') unit |= (uint32_t)(hex - 'a' + 10);
+        else if (hex >= 'A' && hex <= 'F') unit |= (uint32_t)(hex - 'A' + 10);
+        else return NOODLE_FALSE;
+    }
+
+    *pUnit = unit;
+    return NOODLE_TRUE;
+}
+
+void noodleJsonPutCodepoint(NoodleWriter_t* pWriter, uint32_t codepoint)
+{
+    char pBytes[4];
+    noodleWriterPut(pWriter, pBytes, noodleUtf8Encode(codepoint, pBytes));
+}
+
+size_t noodleGetManyTyped(const NoodleGroup_t* pGroup, const char* const* ppNames, size_t count, NoodleType_t type, void* pValues, size_t valueSize, NOODLE_BOOL* pSucceeded)
+{
+    assert(pGroup);
+    assert((ppNames && pValues) || count == 0);
+
+    Noodle_t* ppNoodles[NOODLE_GET_MANY_BATCH];
+    size_t found = 0;
+
+    for (size_t first = 0; first < count; first += NOODLE_GET_MANY_BATCH)
+    {
+        size_t batch = count - first < NOODLE_GET_MANY_BATCH ? count - first : NOODLE_GET_MANY_BATCH;
+
+        noodleGetMany(pGroup, ppNames + first, batch, ppNoodles);
+
+        for (size_t i = 0; i < batch; i++)
+        {
+            char* pValue = (char*)pValues + valueSize * (first + i);
+            const Noodle_t* pNoodle = ppNoodles[i];
+
+            assert((!pNoodle || pNoodle->type == type) && "Requested noodle was not of the requested type!");
+
+            // Like the single key getters, missing values are zeroed
+            NOODLE_BOOL succeeded = pNoodle && pNoodle->type == type;
+
+            if (succeeded)
+                memcpy(pValue, &((const NoodleValue_t*)pNoodle)->i, valueSize);
+            else
+                memset(pValue, 0, valueSize);
+
+            if (pSucceeded) pSucceeded[first + i] = succeeded;
+            if (succeeded) found++;
+        }
+    }
+
+    return found;
+}
+
+NOODLE_BOOL noodleArrayCopy(const NoodleAllocator_t* pAllocator, const NoodleArray_t* pArray, char* pName, NoodleGroup_t* pParent)
+{
+    // Once linked into the parent a partial copy is freed along with it
+    NoodleArray_t* pCopy = noodleArray(pAllocator, pName, pArray->type, pParent);
+    if (!pCopy) return NOODLE_FALSE;
+
+    size_t elementSize = 0;
+
+    switch (pArray->type)
+    {
+        case NOODLE_TYPE_INTEGER: elementSize = sizeof(int); break;
+        case NOODLE_TYPE_FLOAT: elementSize = sizeof(float); break;
+        case NOODLE_TYPE_BOOLEAN: elementSize = sizeof(NOODLE_BOOL); break;
+        case NOODLE_TYPE_STRING: elementSize = sizeof(char*); break;
+        default: return NOODLE_FALSE;
+    }
+
+    pCopy->pIntegers = noodleAlloc(pAllocator, elementSize * pArray->count);
+    if (!pCopy->pIntegers) return NOODLE_FALSE;
+
+    if (pArray->type != NOODLE_TYPE_STRING)
+    {
+        memcpy(pCopy->pIntegers, pArray->pIntegers, elementSize * pArray->count);
+        pCopy->count = pArray->count;
+        return NOODLE_TRUE;
+    }
+
+    memset(pCopy->ppStrings, 0, elementSize * pArray->count);
+    pCopy->count = pArray->count;
+
+    for (size_t i = 0; i < pArray->count; i++)
+    {
+        pCopy->ppStrings[i] = noodleStringDuplicate(pAllocator, pArray->ppStrings[i]);
+        if (!pCopy->ppStrings[i]) return NOODLE_FALSE;
+    }
+
+    return NOODLE_TRUE;
+}
+
+void noodleFree(const NoodleAllocator_t* pAllocator, Noodle_t* pNoodle)
+{
+    pNoodle->pParent = NULL;
+    noodleFreePending(pAllocator, pNoodle);
+}
+
+void noodleFreePending(const NoodleAllocator_t* pAllocator, Noodle_t* pPending)
+{
+    // Noodles waiting to be freed are linked through their parent pointers,
+    // so freeing needs no stack however deeply the groups are nested
+    while (pPending)
+    {
+        Noodle_t* pNoodle = pPending;
+        pPending = (Noodle_t*)pNoodle->pParent;
+
+        switch (pNoodle->type)
+        {
+            case NOODLE_TYPE_GROUP:
+            {
+                NoodleGroup_t* pGroup = (NoodleGroup_t*)pNoodle;
+
+                pPending = noodleGroupRelease(pAllocator, pGroup, pPending);
+
+                if (!pGroup->lazy) noodleDealloc(pAllocator, pGroup);
+                break;
+            }
+            
+            case NOODLE_TYPE_ARRAY:
+            {
+                NoodleArray_t* pArray = (NoodleArray_t*)pNoodle;
+
+                if (pArray->type == NOODLE_TYPE_STRING && pArray->ppStrings)
+                    for (size_t i = 0; i < pArray->count; i++)
+                        noodleDealloc(pAllocator, pArray->ppStrings[i]);
+                
+                noodleDealloc(pAllocator, pArray->pIntegers);
+                noodleDealloc(pAllocator, pArray);
+                break;
+            }
+
+            default:
+                assert(false && "Values are freed along with their group!");
+                break;
+        }
+    }
+}
+
+size_t noodlePoolClass(size_t size)
+{
+    size_t sizeClass = 0;
+
+    while (sizeClass < NOODLE_POOL_CLASSES && ((size_t)NOODLE_POOL_MIN_SIZE << sizeClass) < size)
+        sizeClass++;
+
+    return sizeClass;
+}
+
+void* noodlePoolAlloc(void* pUser, size_t size)
+{
+    NoodleContext_t* pContext = pUser;
+    size_t sizeClass = noodlePoolClass(size);
+    NoodlePoolBlock_t* pBlock = NULL;
+
+    if (sizeClass < NOODLE_POOL_CLASSES && pContext->ppFree[sizeClass])
+    {
+        pBlock = pContext->ppFree[sizeClass];
+        pContext->ppFree[sizeClass] = pBlock->pNext;
+    }
+    else
+    {
+        size_t capacity = sizeClass < NOODLE_POOL_CLASSES ? (size_t)NOODLE_POOL_MIN_SIZE << sizeClass : size;
+        if (capacity > SIZE_MAX - sizeof(NoodlePoolBlock_t)) return NULL;
+
+        pBlock = noodleAlloc(&pContext->allocator, sizeof(NoodlePoolBlock_t) + capacity);
+        if (!pBlock) return NULL;
+    }
+
+    pBlock->pNext = NULL;
+    pBlock->sizeClass = sizeClass;
+    pContext->liveBlocks++;
+
+    // Pooled blocks get their capacity from the class
+    if (sizeClass == NOODLE_POOL_CLASSES) pBlock->capacity = size;
+
+    return pBlock + 1;
+}
+
+void* noodlePoolRealloc(void* pUser, void* pMemory, size_t size)
+{
+    if (!pMemory) return noodlePoolAlloc(pUser, size);
+
+    // Shrinking, or growing within the class, keeps the block as it is
+    NoodlePoolBlock_t* pBlock = (NoodlePoolBlock_t*)pMemory - 1;
+    size_t sizeClass = noodlePoolClass(size);
+
+    if (pBlock->sizeClass < NOODLE_POOL_CLASSES && sizeClass <= pBlock->sizeClass)
+        return pMemory;
+
+    void* pNewMemory = noodlePoolAlloc(pUser, size);
+    if (!pNewMemory) return NULL;
+
+    size_t oldSize = pBlock->sizeClass < NOODLE_POOL_CLASSES ? (size_t)NOODLE_POOL_MIN_SIZE << pBlock->sizeClass : pBlock->capacity;
+    memcpy(pNewMemory, pMemory, oldSize < size ? oldSize : size);
+    noodlePoolFree(pUser, pMemory);
+
+    return pNewMemory;
+}
+
+void noodlePoolFree(void* pUser, void* pMemory)
+{
+    NoodleContext_t* pContext = pUser;
+    NoodlePoolBlock_t* pBlock = (NoodlePoolBlock_t*)pMemory - 1;
+
+    pContext->liveBlocks--;
+
+    if (pBlock->sizeClass == NOODLE_POOL_CLASSES)
+    {
+        noodleDealloc(&pContext->allocator, pBlock);
+        return;
+    }
+
+    pBlock->pNext = pContext->ppFree[pBlock->sizeClass];
+    pContext->ppFree[pBlock->sizeClass] = pBlock;
+}
+
+void noodleContextReserve(NoodleContext_t* pContext, NoodleGroup_t* pGroup, size_t order)
+{
+    // Once the documents differ the hints no longer line up, so they're only 
+    // used while the names match
+    if (order >= pContext->hintCount) return;
+
+    const NoodleGroupHint_t* pHint = &pContext->pHints[order];
+    if (pHint->pName != pGroup->base.pName || pHint->count <= NOODLE_GROUP_INITIAL_CAPACITY) return;
+
+    // Failing to reserve is harmless, the group grows as usual
+    noodleGroupReserve(&pContext->pool, pGroup, pHint->count);
+}
+
+NOODLE_BOOL noodleContextRecord(NoodleContext_t* pContext, const NoodleGroup_t* pGroup)
+{
+    if (pContext->hintCount == pContext->hintCapacity)
+    {
+        size_t capacity = pContext->hintCapacity ? pContext->hintCapacity * 2 : NOODLE_GROUP_INITIAL_CAPACITY;
+
+        NoodleGroupHint_t* pHints = noodleRealloc(&pContext->allocator, pContext->pHints, sizeof(NoodleGroupHint_t) * capacity);
+        if (!pHints) return NOODLE_FALSE;
+
+        pContext->pHints = pHints;
+        pContext->hintCapacity = capacity;
+    }
+
+    pContext->pHints[pContext->hintCount++] = (NoodleGroupHint_t){pGroup->base.pName, pGroup->count};
+
+    // Groups open in the order of a depth first walk, included groups are 
+    // borrowed and never opened by the parser
+    for (uint32_t i = 0; i < pGroup->count; i++)
+    {
+        const NoodleValue_t* pEntry = &pGroup->pEntries[i];
+
+        if (pEntry->base.type == NOODLE_TYPE_GROUP && pEntry->pChild->pParent == pGroup && !noodleContextRecord(pContext, (const NoodleGroup_t*)pEntry->pChild))
+            return NOODLE_FALSE;
+    }
+
+    return NOODLE_TRUE;
+}
+
+size_t noodleSkipRecordSpaces(const char* pContent, size_t length, size_t position, NoodleRecordCursor_t* pCursor)
+{
+    for (; position < length && pContent[position]; position++)
+    {
+        char c = pContent[position];
+
+        if (c == '\n')
+        {
+            pCursor->line++;
+            pCursor->lineStart = position + 1;
+        }
+        else if (c == '#')
+        {
+            while (position + 1 < length && pContent[position + 1] && pContent[position + 1] != '\n')
+                position++;
+        }
+        else if (!noodleLexerIsSpace(c))
+        {
+            break;
+        }
+    }
+
+    return position;
+}
+
+NOODLE_BOOL noodleRecordNext(const char* pContent, size_t length, NoodleRecordCursor_t* pCursor, NoodleLexer_t* pRecord)
+{
+    // Commas may separate the records like any other entries
+    size_t position = pCursor->position;
+
+    for (;;)
+    {
+        position = noodleSkipRecordSpaces(pContent, length, position, pCursor);
+        if (position >= length || pContent[position] != ',') break;
+        position++;
+    }
+
+    if (position >= length || !pContent[position])
+    {
+        pCursor->position = position;
+        return NOODLE_FALSE;
+    }
+
+    *pRecord = noodleLexer(pContent, 0);
+    pRecord->current = position;
+    pRecord->line = pCursor->line;
+    pRecord->character = position - pCursor->lineStart;
+
+    // Only the extent of the record is found here, the parser reports what's
+    // wrong with it. A key is followed by an equals or, for includes, by the
+    // path. Anything else taken as a key is a single character.
+    if (noodleLexerIsIdentifier(pContent[position]))
+    {
+        while (position < length && noodleLexerIsIdentifier(pContent[position]))
+            position++;
+    }
+    else
+    {
+        position++;
+    }
+
+    position = noodleSkipRecordSpaces(pContent, length, position, pCursor);
+
+    if (position < length && pContent[position] == '=')
+        position = noodleSkipRecordSpaces(pContent, length, position + 1, pCursor);
+
+    // Groups and arrays run until their brackets are matched, which may be
+    // the end of the content, strings until their closing quote and other
+    // values until the first character that can't be part of them
+    char first = position < length ? pContent[position] : '\0';
+    size_t depth = 0;
+
+    if (first == '\"')
+    {
+        position = noodleSkipRecordString(pContent, length, position + 1, pCursor);
+    }
+    else if (first == '{' || first == '[')
+    {
+        depth = 1;
+        position++;
+    }
+    else
+    {
+        size_t value = position;
+
+        while (position < length && pContent[position] && !noodleLexerIsSpace(pContent[position]) && !strchr("{}[],#=\"", pContent[position]))
+            position++;
+
+        // When the value is missing this took the next record's key, which
+        // is left to start that record so only this one fails
+        if (position > value && noodleLexerIsIdentifier(pContent[value]))
+        {
+            NoodleRecordCursor_t ahead = *pCursor;
+            size_t next = noodleSkipRecordSpaces(pContent, length, position, &ahead);
+
+            if (next < length && pContent[next] == '=') position = value;
+        }
+    }
+
+    // Only quotes, brackets, comments and new lines matter inside
+    while (depth > 0 && position < length && pContent[position])
+    {
+        switch (pContent[position++])
+        {
+            case '{':
+            case '[':
+                depth++;
+                break;
+            case '}':
+            case ']':
+                depth--;
+                break;
+            case '\"':
+                position = noodleSkipRecordString(pContent, length, position, pCursor);
+                break;
+            case '#':
+                while (position < length && pContent[position] && pContent[position] != '\n')
+                    position++;
+                break;
+            case '\n':
+                pCursor->line++;
+                pCursor->lineStart = position;
+                break;
+        }
+    }
+
+    pRecord->length = position;
+    pCursor->position = position;
+    pCursor->index++;
+
+    return NOODLE_TRUE;
+}
+
+size_t noodleSkipRecordString(const char* pContent, size_t length, size_t position, NoodleRecordCursor_t* pCursor)
+{
+    for (; position < length && pContent[position]; position++)
+    {
+        if (pContent[position] == '\"') return position + 1;
+
+        // An escaped quote doesn't end the string
+        if (pContent[position] == '\\' && position + 1 < length && pContent[position + 1] && pContent[position + 1] != '\n')
+        {
+            position++;
+            continue;
+        }
+
+        if (pContent[position] == '\n')
+        {
+            pCursor->line++;
+            pCursor->lineStart = position + 1;
+        }
+    }
+
+    // Left open until the end
+    return position;
+}
+
+NoodleThreadResult_t NOODLE_THREAD_CALL noodleRecordWorker(void* pUser)
+{
+    NoodleRecordJob_t* pJob = pUser;
+
+    // Records parsed by this thread share a table, without one each record
+    // makes its own
+    NoodleStringTable_t* pStrings = noodleStringTableCreate(NULL);
+    char pError[NOODLE_RECORD_ERROR_SIZE];
+
+    while (!NOODLE_LOAD_ACQUIRE(&pJob->stopped))
+    {
+        // Only finding where the batch ends is done under the lock, the 
+        // records are found again while they're parsed
+        noodleMutexLock(&pJob->lock);
+
+        NoodleRecordCursor_t cursor = pJob->cursor;
+        NoodleLexer_t record;
+
+        while (pJob->cursor.position - cursor.position < NOODLE_RECORD_BATCH_SIZE && noodleRecordNext(pJob->pContent, pJob->length, &pJob->cursor, &record))
+            continue;
+
+        size_t end = pJob->cursor.index;
+        noodleMutexUnlock(&pJob->lock);
+
+        if (cursor.index == end) break;
+
+        while (cursor.index < end && noodleRecordNext(pJob->pContent, pJob->length, &cursor, &record))
+        {
+            NoodleGroup_t* pRecord = noodleParseDocument(pJob->pContent, NULL, &record, NULL, NULL, pStrings, NULL, NULL, pError, sizeof(pError));
+
+            if (!pJob->callback(pJob->pUser, cursor.index - 1, pRecord, pRecord ? NULL : pError))
+            {
+                NOODLE_STORE_RELEASE(&pJob->stopped, 1);
+                break;
+            }
+        }
+    }
+
+    noodleStringTableRelease(pStrings);
+    return 0;
+}
+
+size_t noodleProcessorCount(void)
+{
+#ifdef _WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return info.dwNumberOfProcessors ? info.dwNumberOfProcessors : 1;
+#else
+    long count = sysconf(_SC_NPROCESSORS_ONLN);
+    return count > 0 ? (size_t)count : 1;
+#endif
+}
+
+void noodleMeasure(const Noodle_t* pNoodle, size_t depth, NoodleParseStats_t* pStats)
+{
+    assert(pNoodle);
+    assert(pStats);
+
+    // Only the view itself is measured, the layers belong to other documents
+    if (pNoodle->type == NOODLE_TYPE_GROUP && ((const NoodleGroup_t*)pNoodle)->overlay)
+    {
+        const NoodleOverlay_t* pOverlay = (const NoodleOverlay_t*)pNoodle;
+
+        pStats->allocationCount++;
+        pStats->allocationBytes += sizeof(NoodleOverlay_t) + sizeof(NoodleGroup_t*) * pOverlay->count;
+
+        for (const NoodleOverlayTable_t* pTable = pOverlay->pTable; pTable; pTable = pTable->pPrevious)
+        {
+            pStats->allocationCount++;
+            pStats->allocationBytes += sizeof(NoodleOverlayTable_t) + sizeof(NoodleOverlay_t*) * pTable->capacity;
+        }
+
+        for (const NoodleOverlay_t* pChild = pOverlay->pChildren; pChild; pChild = pChild->pNext)
+            noodleMeasure((const Noodle_t*)pChild, depth + 1, pStats);
+
+        return;
+    }
+
+    pStats->nodeCounts[pNoodle->type]++;
+
+    // The root accounts for its string table unless it's shared with other documents
+    const NoodleRoot_t* pRoot = (const NoodleRoot_t*)pNoodle;
+    if (pNoodle->type == NOODLE_TYPE_GROUP && !pNoodle->pParent && !pRoot->sharedStrings)
+    {
+        pStats->allocationCount += 1 + (pRoot->pStrings->capacity ? 1 : 0) + pRoot->pStrings->count;
+        pStats->allocationBytes += sizeof(NoodleStringTable_t) + sizeof(NoodleString_t*) * pRoot->pStrings->capacity + pRoot->pStrings->bytes;
+    }
+
+    if (pNoodle->type == NOODLE_TYPE_GROUP && !pNoodle->pParent && pRoot->pLazyGroups)
+    {
+        pStats->allocationCount++;
+        pStats->allocationBytes += sizeof(NoodleLazyGroup_t) * pRoot->lazyCount;
+    }
+
+    if (pNoodle->type == NOODLE_TYPE_GROUP && !pNoodle->pParent && pRoot->ppIncludes)
+    {
+        pStats->allocationCount++;
+        pStats->allocationBytes += sizeof(NoodleInclude_t*) * pRoot->includeCount;
+    }
+
+    switch (pNoodle->type)
+    {
+        case NOODLE_TYPE_GROUP:
+        {
+            const NoodleGroup_t* pGroup = (const NoodleGroup_t*)pNoodle;
+
+            // Lazy groups were counted with the root
+            if (!pGroup->lazy)
+            {
+                pStats->allocationCount++;
+                pStats->allocationBytes += pNoodle->pParent ? sizeof(NoodleGroup_t) : sizeof(NoodleRoot_t);
+            }
+
+            if (depth > pStats->maxDepth) pStats->maxDepth = depth;
+
+            if (pGroup->pEntries)
+            {
+                pStats->allocationCount++;
+                pStats->allocationBytes += sizeof(NoodleValue_t) * pGroup->capacity;
+            }
+
+            if (pGroup->pIndex)
+            {
+                pStats->allocationCount++;
+                pStats->allocationBytes += sizeof(uint32_t) * pGroup->indexCapacity;
+            }
+
+            if (pGroup->pFrozen)
+            {
+                const NoodleFrozen_t* pFrozen = pGroup->pFrozen;
+
+                pStats->allocationCount++;
+                pStats->allocationBytes += (size_t)((char*)(pFrozen->pSlots + pFrozen->count) - (char*)pFrozen);
+
+                if (pFrozen->count && pStats->longestChain < 1) pStats->longestChain = 1;
+            }
+
+            for (size_t i = 0; i < pGroup->count; i++)
+            {
+                const NoodleValue_t* pEntry = &pGroup->pEntries[i];
+
+                // The longest chain is the longest probe sequence through the index
+                if (pGroup->pIndex)
+                {
+                    uint32_t mask = pGroup->indexCapacity - 1;
+                    uint32_t slot = (uint32_t)noodleHashMix(noodleStringHeader(pEntry->base.pName)->hash) & mask;
+                    size_t chain = 1;
+
+                    while (pGroup->pIndex[slot] != i + 1)
+                    {
+                        slot = (slot + 1) & mask;
+                        chain++;
+                    }
+
+                    if (chain > pStats->longestChain) pStats->longestChain = chain;
+                }
+
+                switch (pEntry->base.type)
+                {
+                    case NOODLE_TYPE_GROUP:
+                    case NOODLE_TYPE_ARRAY:
+                        // Borrowed noodles are measured with the included file they belong to
+                        if (noodleOwns(pGroup, pEntry)) noodleMeasure(pEntry->pChild, depth + 1, pStats);
+                        break;
+                    case NOODLE_TYPE_STRING:
+                        pStats->nodeCounts[NOODLE_TYPE_STRING]++;
+                        pStats->allocationCount++;
+                        pStats->allocationBytes += strlen(pEntry->s) + 1;
+                        break;
+                    default:
+                        pStats->nodeCounts[pEntry->base.type]++;
+                        break;
+                }
+            }
+            break;
+        }
+
+        case NOODLE_TYPE_ARRAY:
+        {
+            const NoodleArray_t* pArray = (const NoodleArray_t*)pNoodle;
+
+            pStats->allocationCount++;
+            pStats->allocationBytes += sizeof(NoodleArray_t);
+
+            if (!pArray->pIntegers) break;
+
+            size_t elementSize = 0;
+            switch (pArray->type)
+            {
+                case NOODLE_TYPE_INTEGER: elementSize = sizeof(int); break;
+                case NOODLE_TYPE_FLOAT: elementSize = sizeof(float); break;
+                case NOODLE_TYPE_BOOLEAN: elementSize = sizeof(NOODLE_BOOL); break;
+                case NOODLE_TYPE_STRING: elementSize = sizeof(char*); break;
+                default: break;
+            }
+
+            pStats->allocationCount++;
+            pStats->allocationBytes += elementSize * pArray->count;
+
+            if (pArray->type == NOODLE_TYPE_STRING)
+            {
+                for (size_t i = 0; i < pArray->count; i++)
+                {
+                    pStats->allocationCount++;
+                    pStats->allocationBytes += strlen(pArray->ppStrings[i]) + 1;
+                }
+            }
+            break;
+        }
+
+        default:
+            assert(false && "Values are measured along with their group!");
+            break;
+    }
+}
+
+NoodleGroup_t* noodleParseDocument(const char* pContent, NoodleStream_t* pStream, const NoodleLexer_t* pSpan, NoodleContext_t* pContext, const NoodleAllocator_t* pAllocator, NoodleStringTable_t* pStrings, NoodleParseStats_t* pStats, const NoodleIncludeFrame_t* pFrame, char* pErrorBuffer, size_t bufferSize)
+{
+    if (!pContent) goto cleanupArgument;
+
+    double parseStart = 0.0;
+
+    if (pStats)
+    {
+        memset(pStats, 0, sizeof(NoodleParseStats_t));
+        parseStart = noodleTimeNow();
+    }
+
+    if (pErrorBuffer && bufferSize > 1 )
+    {
+        memset(pErrorBuffer, '\0', bufferSize);
+        bufferSize--; // Allow for at least one null-terminator
+    }
+    else
+    {
+        // If the user doesn't want to receive errors, do nothing
+        pErrorBuffer = NULL;
+        bufferSize = 0;
+    }
+
+    // Create the root group to contain the other noodles, from here on the
+    // allocator copied into the root is used
+    NoodleRoot_t* pRootState = noodleRoot(pAllocator, pStrings);
+    if (!pRootState) goto cleanupRoot;
+
+    NoodleGroup_t* pRoot = &pRootState->group;
+    pAllocator = &pRootState->allocator;
+    pStrings = pRootState->pStrings;
+
+    // Groups are numbered as they open to find their size in the last 
+    // document parsed with the context
+    size_t groupsOpened = 0;
+    if (pContext) noodleContextReserve(pContext, pRoot, groupsOpened++);
+
+    // Create the lexer and begin parsing, a stream starts out empty and a 
+    // span only covers part of the content. The length is found up front so
+    // strings can be scanned in blocks without reading past the end.
+    NoodleLexer_t lexer = pSpan ? *pSpan : noodleLexer(pContent, pStream ? 0 : strlen(pContent));
+    NoodleToken_t token = {0};
+    lexer.pStream = pStream;
+
+    NOODLE_PROBE2(parse__start, pRoot, pStream != NULL);
+
+    noodleParseNextToken(&lexer, &token, pStats);
+
+    const char* pErrorExpected = ""; // On failure use this value is set to hint what the error is
+    NoodleGroup_t* pCurrent = pRoot; // Used to parent noodles
+
+    while (token.kind != NOODLE_TOKEN_KIND_END)
+    {
+        // Entries before this one are no longer needed, arrays are read 
+        // twice so the window can't be cut any later than this
+        if (pStream && token.start >= NOODLE_STREAM_BLOCK_SIZE)
+            noodleStreamCompact(&lexer, &token);
+
+        if (token.kind != NOODLE_TOKEN_KIND_IDENTIFIER)
+        {
+            pErrorExpected = "Identifier";
+            goto cleanupParse;
+        }
+
+        // Grafts the entries of another file into the current group
+        if (noodleParseIncludeDirective(&lexer, &token))
+        {
+            if (!noodleInclude(pRootState, pCurrent, &lexer, &token, pFrame, pErrorBuffer, bufferSize)) goto cleanupInclude;
+        }
+        else
+        {
+            // Key names are interned, repeated names share the same string
+            char* pIdentifier = noodleStringTableIntern(pStrings, lexer.pContent + token.start, token.end - token.start);
+            if (!pIdentifier) goto cleanupMemory;
+
+            // Get the equals token
+            noodleParseNextToken(&lexer, &token, pStats);
+
+            if (token.kind != NOODLE_TOKEN_KIND_EQUAL)
+            {
+                pErrorExpected = "Equals Symbol";
+                goto cleanupParse;
+            }
+
+            // This next token will determine the type of noodle to create
+            noodleParseNextToken(&lexer, &token, pStats);
+
+            if (token.kind == NOODLE_TOKEN_KIND_LEFTCURLY)
+            {
+                // The constructors insert into the current group themselves
+                NoodleGroup_t* pGroup = noodleGroup(pAllocator, pIdentifier, pCurrent);
+                if (!pGroup) goto cleanupMemory;
+
+                if (pContext) noodleContextReserve(pContext, pGroup, groupsOpened++);
+                pCurrent = pGroup;
+            }
+            else if (!noodleParseValue(pAllocator, &lexer, &token, pStats, pIdentifier, pCurrent, &pErrorExpected))
+            {
+                if (pErrorExpected) goto cleanupParse;
+                goto cleanupMemory;
+            }
+        }
+
+        noodleParseNextToken(&lexer, &token, pStats);
+        
+        if (token.kind == NOODLE_TOKEN_KIND_COMMA)
+        {
+            noodleParseNextToken(&lexer, &token, pStats);
+
+            // Spare commas are not recommended, but are allowed after a value 
+            // even if it's the last one
+            if (token.kind == NOODLE_TOKEN_KIND_RIGHTCURLY)
+                goto parseEndGroups;
+
+            continue;
+        }
+
+        
+    parseEndGroups:
+
+        while (token.kind == NOODLE_TOKEN_KIND_RIGHTCURLY)
+        {
+            Noodle_t* pTemp = (Noodle_t*)pCurrent;
+
+            if (!pTemp->pParent)
+            {
+                pErrorExpected = "Identifier";
+                goto cleanupParse;
+            }
+
+            // The group is complete, give back the spare entries. Its nested 
+            // groups are complete too, so their fingerprints are reused.
+            noodleGroupShrink(pAllocator, pCurrent);
+            noodleGroupFingerprint(pCurrent);
+            NOODLE_PROBE3(group__parsed, pCurrent->base.pName, pCurrent->count, 0);
+            pCurrent = pTemp->pParent;
+
+            noodleParseNextToken(&lexer, &token, pStats);
+        }
+
+    }
+
+    noodleGroupShrink(pAllocator, pRoot);
+    noodleGroupFingerprint(pRoot);
+
+    if (pStats)
+    {
+        pStats->buildSeconds = (noodleTimeNow() - parseStart) - pStats->lexSeconds;
+        noodleMeasure((Noodle_t*)pRoot, 0, pStats);
+    }
+
+    // Whatever hints were recorded before running out of memory still apply
+    if (pContext)
+    {
+        pContext->hintCount = 0;
+        noodleContextRecord(pContext, pRoot);
+    }
+
+    NOODLE_PROBE3(parse__done, pRoot, lexer.current + (pStream ? pStream->discarded : 0), 1);
+    return pRoot;
+
+cleanupArgument:
+    snprintf(pErrorBuffer, bufferSize, "Invalid argument!");
+    return NULL;
+
+cleanupRoot:
+    snprintf(pErrorBuffer, bufferSize, "Could not allocate memory!");
+    return NULL;
+
+cleanupMemory:
+    snprintf(pErrorBuffer, bufferSize, "Could not allocate memory!");
+    NOODLE_PROBE3(parse__done, pRoot, lexer.current + (pStream ? pStream->discarded : 0), 0);
+    noodleCleanup(pRoot);
+    return NULL;
+
+cleanupParse:
+    snprintf(pErrorBuffer, bufferSize, "(Ln %zu, Col %zu) Unexpected token found, \"%.*s\", expected token, \"%s\"!", lexer.line, lexer.character, noodleTokenPrintLength(&token), lexer.pContent + token.start, pErrorExpected);
+    NOODLE_PROBE3(parse__done, pRoot, lexer.current + (pStream ? pStream->discarded : 0), 0);
+    noodleCleanup(pRoot);
+    return NULL;
+
+cleanupInclude:
+    NOODLE_PROBE3(parse__done, pRoot, lexer.current + (pStream ? pStream->discarded : 0), 0);
+    noodleCleanup(pRoot);
+    return NULL;
+}
+
+NoodleGroup_t* noodleParseFile(const char* pPath, const NoodleAllocator_t* pAllocator, NoodleStringTable_t* pStrings, NoodleParseStats_t* pStats, const NoodleIncludeFrame_t* pIncluder, char* pErrorBuffer, size_t bufferSize)
+{
+    assert(pPath);
+
+    if (!pErrorBuffer || bufferSize < 1)
+    {
+        pErrorBuffer = NULL;
+        bufferSize = 0;
+    }
+
+    NoodleAllocator_t defaultAllocator = {noodleDefaultAlloc, noodleDefaultRealloc, noodleDefaultFree, NULL};
+    if (!pAllocator) pAllocator = &defaultAllocator;
+
+    FILE* pFile = fopen(pPath, "rb");
+    if (!pFile) goto cleanupFile;
+
+    // Get file size
+    if (NOODLE_FSEEK(pFile, 0, SEEK_END) != 0) goto cleanupSize;
+
+    int64_t end = (int64_t)NOODLE_FTELL(pFile);
+    if (end < 0 || (uint64_t)end >= SIZE_MAX || NOODLE_FSEEK(pFile, 0, SEEK_SET) != 0) goto cleanupSize;
+
+    size_t size = (size_t)end;
+
+    // Compressed files are recognized by their first bytes
+    char pMagic[4] = {0};
+    size_t magicSize = fread(pMagic, 1, sizeof(pMagic), pFile);
+    NoodleCompression_t compression = noodleCompressionOf(pMagic, magicSize);
+
+    if (NOODLE_FSEEK(pFile, 0, SEEK_SET) != 0) goto cleanupSize;
+
+    if (compression != NOODLE_COMPRESSION_NONE)
+    {
+        NoodleGroup_t* pRoot = noodleParseCompressed(pPath, compression, pFile, NULL, 0, pAllocator, pStrings, pStats, pIncluder, pErrorBuffer, bufferSize);
+        fclose(pFile);
+
+        return pRoot;
+    }
+
+    // Allocate the file in memory, with room for the null-terminator
+    char* pContent = noodleAlloc(pAllocator, size + 1);
+    if (!pContent) goto cleanupMemory;
+
+    // Copy the file to memory
+    if (fread(pContent, 1, size, pFile) != size) goto cleanupRead;
+
+    pContent[size] = '\0';
+    fclose(pFile);
+
+    NoodleGroup_t* pRoot = noodleParseFileContent(pPath, pContent, NULL, pAllocator, pStrings, pStats, pIncluder, pErrorBuffer, bufferSize);
+    noodleDealloc(pAllocator, pContent);
+
+    return pRoot;
+
+cleanupFile:
+    snprintf(pErrorBuffer, bufferSize, "Could not open file!");
+    return NULL;
+
+cleanupSize:
+    snprintf(pErrorBuffer, bufferSize, "Could not get the size of the file!");
+    fclose(pFile);
+    return NULL;
+
+cleanupRead:
+    snprintf(pErrorBuffer, bufferSize, "Could not read file!");
+    noodleDealloc(pAllocator, pContent);
+    fclose(pFile);
+    return NULL;
+
+cleanupMemory:
+    snprintf(pErrorBuffer, bufferSize, "Could not allocate memory!");
+    fclose(pFile);
+    return NULL;
+
+}
+
+NoodleGroup_t* noodleParseFileContent(const char* pPath, const char* pContent, NoodleStream_t* pStream, const NoodleAllocator_t* pAllocator, NoodleStringTable_t* pStrings, NoodleParseStats_t* pStats, const NoodleIncludeFrame_t* pIncluder, char* pErrorBuffer, size_t bufferSize)
+{
+    // Files included by this one are found relative to it
+    char pCanonical[NOODLE_PATH_MAX];
+    NoodleIncludeFrame_t frame = {pPath, pIncluder};
+    if (noodlePathCanonical(pPath, pCanonical)) frame.pPath = pCanonical;
+
+    return noodleParseDocument(pContent, pStream, NULL, NULL, pAllocator, pStrings, pStats, &frame, pErrorBuffer, bufferSize);
+}
+
+NoodleCompression_t noodleCompressionOf(const char* pMagic, size_t size)
+{
+    const unsigned char* pBytes = (const unsigned char*)pMagic;
+
+    if (size >= 2 && pBytes[0] == 0x1f && pBytes[1] == 0x8b) 
+        return NOODLE_COMPRESSION_GZIP;
+
+    if (size >= 4 && pBytes[0] == 0x28 && pBytes[1] == 0xb5 && pBytes[2] == 0x2f && pBytes[3] == 0xfd) 
+        return NOODLE_COMPRESSION_ZSTD;
+
+    return NOODLE_COMPRESSION_NONE;
+}
+
+NoodleGroup_t* noodleParseCompressed(const char* pPath, NoodleCompression_t compression, FILE* pFile, const char* pMemory, size_t memorySize, const NoodleAllocator_t* pAllocator, NoodleStringTable_t* pStrings, NoodleParseStats_t* pStats, const NoodleIncludeFrame_t* pIncluder, char* pErrorBuffer, size_t bufferSize)
+{
+    if (!pErrorBuffer || bufferSize < 1)
+    {
+        pErrorBuffer = NULL;
+        bufferSize = 0;
+    }
+
+#ifndef NOODLE_ZLIB
+    if (compression == NOODLE_COMPRESSION_GZIP) goto cleanupSupport;
+#endif
+#ifndef NOODLE_ZSTD
+    if (compression == NOODLE_COMPRESSION_ZSTD) goto cleanupSupport;
+#endif
+
+    NoodleAllocator_t defaultAllocator = {noodleDefaultAlloc, noodleDefaultRealloc, noodleDefaultFree, NULL};
+    if (!pAllocator) pAllocator = &defaultAllocator;
+
+    NoodleStream_t* pStream = noodleAlloc(pAllocator, sizeof(NoodleStream_t));
+    if (!pStream) goto cleanupMemory;
+
+    pStream->compression = compression;
+    pStream->pAllocator = pAllocator;
+    pStream->pFile = pFile;
+    pStream->pMemory = pMemory;
+    pStream->memorySize = memorySize;
+    pStream->memoryRead = 0;
+    pStream->discarded = 0;
+    pStream->filled = 0;
+    pStream->taken = 0;
+    pStream->finished = NOODLE_FALSE;
+    pStream->failed = NOODLE_FALSE;
+    pStream->cancelled = NOODLE_FALSE;
+
+    // Room for a block and what's left of the last one
+    pStream->windowCapacity = NOODLE_STREAM_BLOCK_SIZE * 2 + 1;
+    pStream->pWindow = noodleAlloc(pAllocator, pStream->windowCapacity);
+    if (!pStream->pWindow) goto cleanupWindow;
+
+    pStream->pWindow[0] = '\0';
+
+    noodleMutexInit(&pStream->lock);
+    noodleConditionInit(&pStream->produced);
+    noodleConditionInit(&pStream->consumed);
+
+    NoodleThread_t thread;
+    if (!noodleThreadStart(noodleStreamDecompress, pStream, &thread)) goto cleanupThread;
+
+    NoodleGroup_t* pRoot = noodleParseFileContent(pPath, pStream->pWindow, pStream, pAllocator, pStrings, pStats, pIncluder, pErrorBuffer, bufferSize);
+
+    // The parser may stop early, the decompressor is told to stop with it
+    noodleMutexLock(&pStream->lock);
+    pStream->cancelled = NOODLE_TRUE;
+    noodleConditionBroadcast(&pStream->consumed);
+    noodleMutexUnlock(&pStream->lock);
+
+    noodleThreadJoin(thread);
+
+    // Content cut short by a broken file could still have parsed
+    if (pStream->failed)
+    {
+        noodleCleanup(pRoot);
+        pRoot = NULL;
+        snprintf(pErrorBuffer, bufferSize, "Could not decompress file!");
+    }
+
+    noodleConditionDestroy(&pStream->consumed);
+    noodleConditionDestroy(&pStream->produced);
+    noodleMutexDestroy(&pStream->lock);
+    noodleDealloc(pAllocator, pStream->pWindow);
+    noodleDealloc(pAllocator, pStream);
+
+    return pRoot;
+
+#if !defined(NOODLE_ZLIB) || !defined(NOODLE_ZSTD)
+cleanupSupport:
+    snprintf(pErrorBuffer, bufferSize, "Could not decompress file, %s support was not built!", compression == NOODLE_COMPRESSION_GZIP ? "gzip" : "zstd");
+    return NULL;
+#endif
+
+cleanupThread:
+    noodleConditionDestroy(&pStream->consumed);
+    noodleConditionDestroy(&pStream->produced);
+    noodleMutexDestroy(&pStream->lock);
+    noodleDealloc(pAllocator, pStream->pWindow);
+
+cleanupWindow:
+    noodleDealloc(pAllocator, pStream);
+
+cleanupMemory:
+    snprintf(pErrorBuffer, bufferSize, "Could not allocate memory!");
+    return NULL;
+}
+
+void noodleStreamCompact(NoodleLexer_t* pLexer, NoodleToken_t* pToken)
+{
+    // Everything before the token has been parsed, the rest moves to the front
+    NoodleStream_t* pStream = pLexer->pStream;
+    size_t shift = pToken->start;
+
+    memmove(pStream->pWindow, pStream->pWindow + shift, pLexer->length - shift + 1);
+    pStream->discarded += shift;
+
+    pLexer->length -= shift;
+    pLexer->current -= shift;
+    pToken->start -= shift;
+    pToken->end -= shift;
+}
+
+size_t noodleStreamRead(NoodleStream_t* pStream, void* pData, size_t size)
+{
+    if (pStream->pFile) return fread(pData, 1, size, pStream->pFile);
+
+    size_t remaining = pStream->memorySize - pStream->memoryRead;
+    if (size > remaining) size = remaining;
+
+    memcpy(pData, pStream->pMemory + pStream->memoryRead, size);
+    pStream->memoryRead += size;
+
+    return size;
+}
+
+NoodleStreamBlock_t* noodleStreamAcquire(NoodleStream_t* pStream)
+{
+    noodleMutexLock(&pStream->lock);
+
+    while (pStream->filled - pStream->taken == NOODLE_STREAM_BLOCKS && !pStream->cancelled)
+        noodleConditionWait(&pStream->consumed, &pStream->lock);
+
+    NoodleStreamBlock_t* pBlock = pStream->cancelled ? NULL : &pStream->pBlocks[pStream->filled % NOODLE_STREAM_BLOCKS];
+    noodleMutexUnlock(&pStream->lock);
+
+    if (pBlock) pBlock->size = 0;
+    return pBlock;
+}
+
+void noodleStreamPublish(NoodleStream_t* pStream)
+{
+    noodleMutexLock(&pStream->lock);
+    pStream->filled++;
+    noodleConditionSignal(&pStream->produced);
+    noodleMutexUnlock(&pStream->lock);
+}
+
+NoodleThreadResult_t NOODLE_THREAD_CALL noodleStreamDecompress(void* pUser)
+{
+    NoodleStream_t* pStream = pUser;
+    NOODLE_BOOL succeeded = NOODLE_FALSE;
+
+    switch (pStream->compression)
+    {
+#ifdef NOODLE_ZLIB
+        case NOODLE_COMPRESSION_GZIP:
+            succeeded = noodleStreamInflate(pStream);
+            break;
+#endif
+#ifdef NOODLE_ZSTD
+        case NOODLE_COMPRESSION_ZSTD:
+            succeeded = noodleStreamZstd(pStream);
+            break;
+#endif
+        default:
+            break;
+    }
+
+    noodleMutexLock(&pStream->lock);
+    pStream->finished = NOODLE_TRUE;
+    pStream->failed = !succeeded && !pStream->cancelled;
+    noodleConditionSignal(&pStream->produced);
+    noodleMutexUnlock(&pStream->lock);
+
+    return 0;
+}
+
+#ifdef NOODLE_ZLIB
+NOODLE_BOOL noodleStreamInflate(NoodleStream_t* pStream)
+{
+    z_stream inflater;
+    memset(&inflater, 0, sizeof(inflater));
+
+    // Adding 32 to the window bits accepts both gzip and zlib headers
+    if (inflateInit2(&inflater, 15 + 32) != Z_OK) return NOODLE_FALSE;
+
+    unsigned char pInput[NOODLE_STREAM_INPUT_SIZE];
+    NoodleStreamBlock_t* pBlock = NULL;
+    NOODLE_BOOL ended = NOODLE_FALSE; // Input can only stop after a whole member
+
+    for (;;)
+    {
+        if (inflater.avail_in == 0)
+        {
+            inflater.next_in = pInput;
+            inflater.avail_in = (uInt)noodleStreamRead(pStream, pInput, sizeof(pInput));
+            if (inflater.avail_in == 0) break;
+        }
+
+        if (!pBlock)
+        {
+            pBlock = noodleStreamAcquire(pStream);
+            if (!pBlock) goto cleanupInflate;
+
+            inflater.next_out = (Bytef*)pBlock->pData;
+            inflater.avail_out = NOODLE_STREAM_BLOCK_SIZE;
+        }
+
+        int result = inflate(&inflater, Z_NO_FLUSH);
+        pBlock->size = NOODLE_STREAM_BLOCK_SIZE - inflater.avail_out;
+
+        if (result == Z_STREAM_END)
+        {
+            // Concatenated gzip files decompress to their joined contents
+            ended = NOODLE_TRUE;
+            inflateReset(&inflater);
+        }
+        else if (result == Z_OK)
+        {
+            ended = NOODLE_FALSE;
+        }
+        else if (result != Z_BUF_ERROR)
+        {
+            goto cleanupInflate;
+        }
+
+        if (inflater.avail_out == 0)
+        {
+            noodleStreamPublish(pStream);
+            pBlock = NULL;
+        }
+    }
+
+    if (pBlock && pBlock->size > 0) noodleStreamPublish(pStream);
+
+    inflateEnd(&inflater);
+    return ended;
+
+cleanupInflate:
+    inflateEnd(&inflater);
+    return NOODLE_FALSE;
+}
+#endif
+
+#ifdef NOODLE_ZSTD
+NOODLE_BOOL noodleStreamZstd(NoodleStream_t* pStream)
+{
+    ZSTD_DStream* pDecompressor = ZSTD_createDStream();
+    if (!pDecompressor) return NOODLE_FALSE;
+
+    ZSTD_initDStream(pDecompressor);
+
+    char pInput[NOODLE_STREAM_INPUT_SIZE];
+    ZSTD_inBuffer input = {pInput, 0, 0};
+    NoodleStreamBlock_t* pBlock = NULL;
+    size_t hint = 0; // Zero once a frame is complete, input can only stop then
+
+    for (;;)
+    {
+        if (input.pos == input.size)
+        {
+            input.size = noodleStreamRead(pStream, pInput, sizeof(pInput));
+            input.pos = 0;
+            if (input.size == 0) break;
+        }
+
+        if (!pBlock)
+        {
+            pBlock = noodleStreamAcquire(pStream);
+            if (!pBlock) goto cleanupZstd;
+        }
+
+        ZSTD_outBuffer output = {pBlock->pData, NOODLE_STREAM_BLOCK_SIZE, pBlock->size};
+
+        hint = ZSTD_decompressStream(pDecompressor, &output, &input);
+        if (ZSTD_isError(hint)) goto cleanupZstd;
+
+        pBlock->size = output.pos;
+
+        if (pBlock->size == NOODLE_STREAM_BLOCK_SIZE)
+        {
+            noodleStreamPublish(pStream);
+            pBlock = NULL;
+        }
+    }
+
+    if (pBlock && pBlock->size > 0) noodleStreamPublish(pStream);
+
+    ZSTD_freeDStream(pDecompressor);
+    return hint == 0;
+
+cleanupZstd:
+    ZSTD_freeDStream(pDecompressor);
+    return NOODLE_FALSE;
+}
+#endif
+
+NOODLE_BOOL noodleLoaderStart(void)
+{
+#ifdef NOODLE_IO_URING
+    // A single thread keeps every read of the ring in flight and parses the
+    // files as they complete
+    if (noodleRingInit(&gNoodleRing) && noodleThreadStart(noodleLoaderRing, &gNoodleRing, NULL))
+    {
+        gNoodleLoader.started = NOODLE_TRUE;
+        return NOODLE_TRUE;
+    }
+#endif
+
+    for (size_t i = 0; i < NOODLE_LOADER_THREADS; i++)
+        if (noodleThreadStart(noodleLoaderPool, NULL, NULL)) gNoodleLoader.started = NOODLE_TRUE;
+
+    return gNoodleLoader.started;
+}
+
+NoodleLoad_t* noodleLoaderTake(size_t limit)
+{
+    // Called with the lock held, takes up to limit loads off the queue
+    NoodleLoad_t* pFirst = gNoodleLoader.pFirst;
+    NoodleLoad_t* pLast = NULL;
+
+    for (NoodleLoad_t* pLoad = pFirst; pLoad && limit > 0; pLoad = pLoad->pNext, limit--)
+        pLast = pLoad;
+
+    if (!pLast) return NULL;
+
+    gNoodleLoader.pFirst = pLast->pNext;
+    if (!gNoodleLoader.pFirst) gNoodleLoader.pLast = NULL;
+
+    pLast->pNext = NULL;
+    return pFirst;
+}
+
+void noodleLoadFinish(NoodleLoad_t* pLoad, NoodleGroup_t* pGroup, const char* pError)
+{
+    pLoad->callback(pLoad->pUser, pLoad->pPath, pGroup, pGroup ? NULL : pError);
+    NOODLE_FREE(pLoad);
+
+    noodleMutexLock(&gNoodleLoader.lock);
+
+    if (--gNoodleLoader.pending == 0)
+        noodleConditionBroadcast(&gNoodleLoader.idle);
+
+    noodleMutexUnlock(&gNoodleLoader.lock);
+}
+
+NoodleThreadResult_t NOODLE_THREAD_CALL noodleLoaderPool(void* pUser)
+{
+    (void)pUser;
+
+    for (;;)
+    {
+        noodleMutexLock(&gNoodleLoader.lock);
+
+        while (!gNoodleLoader.pFirst)
+            noodleConditionWait(&gNoodleLoader.wake, &gNoodleLoader.lock);
+
+        NoodleLoad_t* pLoad = noodleLoaderTake(1);
+        noodleMutexUnlock(&gNoodleLoader.lock);
+
+        char pErrorBuffer[256] = {0};
+        NoodleGroup_t* pGroup = noodleParseFile(pLoad->pPath, NULL, NULL, NULL, NULL, pErrorBuffer, sizeof(pErrorBuffer));
+
+        noodleLoadFinish(pLoad, pGroup, pErrorBuffer);
+    }
+
+    return 0;
+}
+
+#ifdef NOODLE_IO_URING
+NOODLE_BOOL noodleRingInit(NoodleRing_t* pRing)
+{
+    struct io_uring_params params;
+    memset(&params, 0, sizeof(params));
+
+    int file = (int)syscall(__NR_io_uring_setup, NOODLE_RING_ENTRIES, &params);
+    if (file < 0) return NOODLE_FALSE;
+
+    // IORING_OP_READ arrived in the same kernel as this feature
+    if (!(params.features & IORING_FEAT_RW_CUR_POS)) goto cleanupRing;
+
+    size_t sqSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    size_t cqSize = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+
+    // Newer kernels map both rings at once
+    NOODLE_BOOL single = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+    if (single && cqSize > sqSize) sqSize = cqSize;
+
+    char* pSq = mmap(NULL, sqSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, file, IORING_OFF_SQ_RING);
+    if (pSq == MAP_FAILED) goto cleanupRing;
+
+    char* pCq = single ? pSq : mmap(NULL, cqSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, file, IORING_OFF_CQ_RING);
+    if (pCq == MAP_FAILED) goto cleanupSq;
+
+    void* pSqes = mmap(NULL, params.sq_entries * sizeof(struct io_uring_sqe), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, file, IORING_OFF_SQES);
+    if (pSqes == MAP_FAILED) goto cleanupCq;
+
+    pRing->file = file;
+    pRing->entries = params.sq_entries;
+    pRing->pSqHead = (unsigned*)(pSq + params.sq_off.head);
+    pRing->pSqTail = (unsigned*)(pSq + params.sq_off.tail);
+    pRing->pSqMask = (unsigned*)(pSq + params.sq_off.ring_mask);
+    pRing->pSqArray = (unsigned*)(pSq + params.sq_off.array);
+    pRing->pSqes = pSqes;
+    pRing->pCqHead = (unsigned*)(pCq + params.cq_off.head);
+    pRing->pCqTail = (unsigned*)(pCq + params.cq_off.tail);
+    pRing->pCqMask = (unsigned*)(pCq + params.cq_off.ring_mask);
+    pRing->pCqes = (struct io_uring_cqe*)(pCq + params.cq_off.cqes);
+
+    return NOODLE_TRUE;
+
+cleanupCq:
+    if (!single) munmap(pCq, cqSize);
+
+cleanupSq:
+    munmap(pSq, sqSize);
+
+cleanupRing:
+    close(file);
+    return NOODLE_FALSE;
+}
+
+void noodleRingRead(NoodleRing_t* pRing, NoodleLoad_t* pLoad)
+{
+    // Only the loader thread submits, so the tail can't move underneath it
+    unsigned tail = *pRing->pSqTail;
+    unsigned index = tail & *pRing->pSqMask;
+    struct io_uring_sqe* pSqe = &pRing->pSqes[index];
+
+    size_t remaining = pLoad->size - pLoad->read;
+
+    memset(pSqe, 0, sizeof(*pSqe));
+    pSqe->opcode = IORING_OP_READ;
+    pSqe->fd = pLoad->file;
+    pSqe->addr = (uint64_t)(uintptr_t)(pLoad->pContent + pLoad->read);
+    pSqe->len = remaining < NOODLE_RING_MAX_READ ? (unsigned)remaining : NOODLE_RING_MAX_READ;
+    pSqe->off = (uint64_t)pLoad->read;
+    pSqe->user_data = (uint64_t)(uintptr_t)pLoad;
+
+    pRing->pSqArray[index] = index;
+    NOODLE_STORE_RELEASE(pRing->pSqTail, tail + 1);
+}
+
+int noodleRingEnter(NoodleRing_t* pRing, unsigned submit, unsigned wait)
+{
+    // Submitting never blocks, so only a wait can be interrupted
+    for (;;)
+    {
+        int result = (int)syscall(__NR_io_uring_enter, pRing->file, submit, wait, wait ? IORING_ENTER_GETEVENTS : 0, NULL, 0);
+        if (result >= 0 || errno != EINTR) return result;
+    }
+}
+
+NoodleThreadResult_t NOODLE_THREAD_CALL noodleLoaderRing(void* pUser)
+{
+    NoodleRing_t* pRing = pUser;
+    unsigned inFlight = 0;
+
+    for (;;)
+    {
+        // Every load queued since the last pass is submitted in one batch
+        noodleMutexLock(&gNoodleLoader.lock);
+
+        while (!gNoodleLoader.pFirst && inFlight == 0)
+            noodleConditionWait(&gNoodleLoader.wake, &gNoodleLoader.lock);
+
+        NoodleLoad_t* pTaken = noodleLoaderTake(pRing->entries - inFlight);
+        noodleMutexUnlock(&gNoodleLoader.lock);
+
+        unsigned submit = 0;
+        NoodleLoad_t* pReady = NULL;
+
+        while (pTaken)
+        {
+            NoodleLoad_t* pLoad = pTaken;
+            pTaken = pTaken->pNext;
+            pLoad->pNext = NULL;
+
+            struct stat info;
+            pLoad->file = open(pLoad->pPath, O_RDONLY | O_CLOEXEC);
+
+            if (pLoad->file < 0 || fstat(pLoad->file, &info) != 0 || (uint64_t)info.st_size >= SIZE_MAX ||
+                !(pLoad->pContent = NOODLE_MALLOC((size_t)info.st_size + 1)))
+            {
+                pLoad->size = SIZE_MAX; // Marks the failure
+                pLoad->pNext = pReady;
+                pReady = pLoad;
+                continue;
+            }
+
+            pLoad->size = (size_t)info.st_size;
+
+            if (pLoad->size == 0)
+            {
+                pLoad->pNext = pReady;
+                pReady = pLoad;
+                continue;
+            }
+
+            noodleRingRead(pRing, pLoad);
+            inFlight++;
+            submit++;
+        }
+
+        if (submit) noodleRingEnter(pRing, submit, 0);
+
+        // Only block on the ring when nothing else is ready to be parsed
+        if (!pReady && inFlight && NOODLE_LOAD_ACQUIRE(pRing->pCqTail) == *pRing->pCqHead)
+            noodleRingEnter(pRing, 0, 1);
+
+        submit = 0;
+        unsigned head = *pRing->pCqHead;
+
+        while (head != NOODLE_LOAD_ACQUIRE(pRing->pCqTail))
+        {
+            struct io_uring_cqe* pCqe = &pRing->pCqes[head & *pRing->pCqMask];
+            NoodleLoad_t* pLoad = (NoodleLoad_t*)(uintptr_t)pCqe->user_data;
+            int result = pCqe->res;
+
+            head++;
+            inFlight--;
+
+            // Reads can come back short, the rest is read by another one
+            if (result > 0) pLoad->read += (size_t)result;
+
+            if (result > 0 && pLoad->read < pLoad->size)
+            {
+                noodleRingRead(pRing, pLoad);
+                inFlight++;
+                submit++;
+                continue;
+            }
+
+            if (result < 0 || pLoad->read < pLoad->size) pLoad->size = SIZE_MAX;
+
+            pLoad->pNext = pReady;
+            pReady = pLoad;
+        }
+
+        NOODLE_STORE_RELEASE(pRing->pCqHead, head);
+
+        if (submit) noodleRingEnter(pRing, submit, 0);
+
+        // The reads submitted above carry on while these files are parsed
+        while (pReady)
+        {
+            NoodleLoad_t* pLoad = pReady;
+            pReady = pReady->pNext;
+
+            char pErrorBuffer[256] = {0};
+            NoodleGroup_t* pGroup = NULL;
+
+            if (pLoad->file >= 0) close(pLoad->file);
+
+            if (pLoad->size == SIZE_MAX)
+            {
+                snprintf(pErrorBuffer, sizeof(pErrorBuffer), pLoad->file < 0 ? "Could not open file!" : "Could not read file!");
+            }
+            else
+            {
+                pLoad->pContent[pLoad->size] = '\0';
+
+                NoodleCompression_t compression = noodleCompressionOf(pLoad->pContent, pLoad->size);
+
+                if (compression != NOODLE_COMPRESSION_NONE)
+                    pGroup = noodleParseCompressed(pLoad->pPath, compression, NULL, pLoad->pContent, pLoad->size, NULL, NULL, NULL, NULL, pErrorBuffer, sizeof(pErrorBuffer));
+                else
+                    pGroup = noodleParseFileContent(pLoad->pPath, pLoad->pContent, NULL, NULL, NULL, NULL, NULL, pErrorBuffer, sizeof(pErrorBuffer));
+            }
+
+            NOODLE_FREE(pLoad->pContent);
+            noodleLoadFinish(pLoad, pGroup, pErrorBuffer);
+        }
+    }
+
+    return 0;
+}
+#endif
+
+NOODLE_BOOL noodleParseIncludeDirective(NoodleLexer_t* pLexer, NoodleToken_t* pToken)
+{
+    // Only a keyword when a string follows, so it can still be used as a key
+    if (pToken->kind != NOODLE_TOKEN_KIND_IDENTIFIER || pToken->end - pToken->start != sizeof("include") - 1 ||
+        strncmp(pLexer->pContent + pToken->start, "include", sizeof("include") - 1) != 0)
+        return NOODLE_FALSE;
+
+    NoodleLexer_t lookahead = *pLexer;
+    NoodleToken_t path = {0};
+
+    noodleLexerNextToken(&lookahead, &path);
+
+    // A stream's window may have grown while looking ahead
+    pLexer->pContent = lookahead.pContent;
+    pLexer->length = lookahead.length;
+
+    if (path.kind != NOODLE_TOKEN_KIND_STRING) return NOODLE_FALSE;
+
+    *pLexer = lookahead;
+    *pToken = path;
+    return NOODLE_TRUE;
+}
+
+NOODLE_BOOL noodlePathCanonical(const char* pPath, char* pCanonical)
+{
+#ifdef _WIN32
+    return _fullpath(pCanonical, pPath, NOODLE_PATH_MAX) ? NOODLE_TRUE : NOODLE_FALSE;
+#else
+    char* pResolved = realpath(pPath, NULL);
+    if (!pResolved) return NOODLE_FALSE;
+
+    size_t length = strlen(pResolved);
+    NOODLE_BOOL fits = length < NOODLE_PATH_MAX;
+
+    if (fits) memcpy(pCanonical, pResolved, length + 1);
+
+    free(pResolved);
+    return fits;
+#endif
+}
+
+NOODLE_BOOL noodleInclude(NoodleRoot_t* pRoot, NoodleGroup_t* pGroup, const NoodleLexer_t* pLexer, const NoodleToken_t* pToken, const NoodleIncludeFrame_t* pFrame, char* pErrorBuffer, size_t bufferSize)
+{
+    const NoodleAllocator_t* pAllocator = &pRoot->allocator;
+    const char* pPath = pLexer->pContent + pToken->start;
+    size_t length = pToken->end - pToken->start;
+    const char* pReason = "";
+
+    char pJoined[NOODLE_PATH_MAX];
+    char pCanonical[NOODLE_PATH_MAX];
+    char pLoadError[256] = "";
+
+#ifdef _WIN32
+    NOODLE_BOOL absolute = length > 0 && (NOODLE_IS_SEPARATOR(pPath[0]) || (length > 1 && pPath[1] == ':'));
+#else
+    NOODLE_BOOL absolute = length > 0 && NOODLE_IS_SEPARATOR(pPath[0]);
+#endif
+
+    // Relative paths start from the directory of the file doing the including
+    size_t directory = 0;
+
+    if (pFrame && !absolute)
+    {
+        for (size_t i = 0; pFrame->pPath[i]; i++)
+            if (NOODLE_IS_SEPARATOR(pFrame->pPath[i])) directory = i + 1;
+    }
+
+    if (directory + length >= NOODLE_PATH_MAX)
+    {
+        pReason = "Path is too long!";
+        goto cleanupInclude;
+    }
+
+    if (directory) memcpy(pJoined, pFrame->pPath, directory);
+    if (pToken->escaped)
+        length = noodleStringDecode(pPath, length, pJoined + directory);
+    else
+        memcpy(pJoined + directory, pPath, length);
+
+    pJoined[directory + length] = '\0';
+
+    if (!noodlePathCanonical(pJoined, pCanonical))
+    {
+        pReason = "Could not open file!";
+        goto cleanupInclude;
+    }
+
+    for (const NoodleIncludeFrame_t* pOuter = pFrame; pOuter; pOuter = pOuter->pPrevious)
+    {
+        if (strcmp(pOuter->pPath, pCanonical) == 0)
+        {
+            pReason = "The file includes itself!";
+            goto cleanupInclude;
+        }
+    }
+
+    // Make room first so the reference taken by the load can't be lost
+    NoodleInclude_t** ppIncludes = noodleRealloc(pAllocator, pRoot->ppIncludes, sizeof(NoodleInclude_t*) * (pRoot->includeCount + 1));
+    if (!ppIncludes) goto cleanupMemory;
+
+    pRoot->ppIncludes = ppIncludes;
+
+    NoodleInclude_t* pInclude = noodleIncludeLoad(pCanonical, pFrame, pLoadError, sizeof(pLoadError));
+    if (!pInclude)
+    {
+        pReason = pLoadError;
+        goto cleanupInclude;
+    }
+
+    pRoot->ppIncludes[pRoot->includeCount++] = pInclude;
+
+    // Scalars are copied in, groups and arrays are borrowed from the included document
+    const NoodleGroup_t* pSource = pInclude->pDocument;
+
+    for (size_t i = 0; i < pSource->count; i++)
     {
-        case ' ':
-        case '\n':
-        case '\t':
-        case '\v':
-        case '\f':
-        case '\r':
-            return NOODLE_TRUE;
-        default:
-            return NOODLE_FALSE;
+        const NoodleValue_t* pFrom = &pSource->pEntries[i];
+
+        char* pName = noodleStringTableIntern(pRoot->pStrings, pFrom->base.pName, noodleStringHeader(pFrom->base.pName)->length);
+        if (!pName) goto cleanupMemory;
+
+        char* pString = NULL;
+
+        if (pFrom->base.type == NOODLE_TYPE_STRING)
+        {
+            pString = noodleStringDuplicate(pAllocator, pFrom->s);
+            if (!pString) goto cleanupMemory;
+        }
+
+        NoodleValue_t* pEntry = noodleGroupInsert(pAllocator, pGroup, pName, pFrom->base.type);
+        if (!pEntry)
+        {
+            noodleDealloc(pAllocator, pString);
+            goto cleanupMemory;
+        }
+
+        Noodle_t base = pEntry->base;
+        *pEntry = *pFrom;
+        pEntry->base = base;
+
+        if (pString) pEntry->s = pString;
     }
+
+    return NOODLE_TRUE;
+
+cleanupMemory:
+    pReason = "Could not allocate memory!";
+
+cleanupInclude:
+    snprintf(pErrorBuffer, bufferSize, "(Ln %zu, Col %zu) Could not include \"%.*s\", %s", pLexer->line, pLexer->character, noodleTokenPrintLength(pToken), pPath, pReason);
+    return NOODLE_FALSE;
 }
 
-NOODLE_BOOL noodleLexerNextToken(NoodleLexer_t* pLexer, NoodleToken_t* pTokenOut)
+NoodleInclude_t* noodleIncludeLoad(const char* pPath, const NoodleIncludeFrame_t* pIncluder, char* pErrorBuffer, size_t bufferSize)
 {
-    switch(noodleLexerPeek(pLexer))
+#ifdef _WIN32
+    struct __stat64 info;
+    if (_stat64(pPath, &info) != 0) goto cleanupFile;
+#else
+    struct stat info;
+    if (stat(pPath, &info) != 0) goto cleanupFile;
+#endif
+
+    int64_t modified = (int64_t)info.st_mtime;
+    int64_t size = (int64_t)info.st_size;
+    NoodleInclude_t* pInclude = NULL;
+
+    noodleMutexLock(&gNoodleIncludeLock);
+
+    for (pInclude = gpNoodleIncludes; pInclude; pInclude = pInclude->pNext)
     {
-        case 'a':
-        case 'b':
-        case 'c':
-        case 'd':
-        case 'e':
-        case 'f':
-        case 'g':
-        case 'h':
-        case 'i':
-        case 'j':
-        case 'k':
-        case 'l':
-        case 'm':
-        case 'n': 
-        case 'o':
-        case 'p':
-        case 'q':
-        case 'r':
-        case 's':
-        case 't':
-        case 'u':
-        case 'v':
-        case 'w':
-        case 'x':
-        case 'y':
-        case 'z':
-        case 'A':
-        case 'B':
-        case 'C':
-        case 'D':
-        case 'E':
-        case 'F':
-        case 'G':
-        case 'H':
-        case 'I':
-        case 'J':
-        case 'K':
-        case 'L':
-        case 'M':
-        case 'N':
-        case 'O':
-        case 'P':
-        case 'Q':
-        case 'R':
-        case 'S':
-        case 'T':
-        case 'U':
-        case 'V':
-        case 'W':
-        case 'X':
-        case 'Y':
-        case 'Z':
-        case '_':
-            noodleLexerIdentifierOrBool(pLexer, pTokenOut);
-            break;
-        case '0':
-        case '1':
-        case '2':
-        case '3':
-        case '4':
-        case '5':
-        case '6':
-        case '7':
-        case '8':
-        case '9':
-            noodleLexerNumber(pLexer, pTokenOut);
-            break;
-        case '=':
-            noodleLexerAtom(pLexer, NOODLE_TOKEN_KIND_EQUAL, pTokenOut);
-            break;
-        case '{':
-            noodleLexerAtom(pLexer, NOODLE_TOKEN_KIND_LEFTCURLY, pTokenOut);
-            break;
-        case '}':
-            noodleLexerAtom(pLexer, NOODLE_TOKEN_KIND_RIGHTCURLY, pTokenOut);
-            break;
-        case '[':
-            noodleLexerAtom(pLexer, NOODLE_TOKEN_KIND_LEFTBRACKET, pTokenOut);
-            break;
-        case ']':
-            noodleLexerAtom(pLexer, NOODLE_TOKEN_KIND_RIGHTBRACKET, pTokenOut);
-            break;
-        case '\"':
-            noodleLexerString(pLexer, pTokenOut);
-            break;
-        case ',':
-            noodleLexerAtom(pLexer, NOODLE_TOKEN_KIND_COMMA, pTokenOut);
-            break;
-        case '#':
-            noodleLexerSkipComment(pLexer);
-            return noodleLexerNextToken(pLexer, pTokenOut);
-        case ' ':
-        case '\n':
-        case '\t':
-        case '\v':
-        case '\f':
-        case '\r':
-            noodleLexerSkipSpaces(pLexer);
-            return noodleLexerNextToken(pLexer, pTokenOut);
-        case '\0':
-            noodleLexerAtom(pLexer, NOODLE_TOKEN_KIND_END, pTokenOut);
-            break;
-        default:
-            noodleLexerAtom(pLexer, NOODLE_TOKEN_KIND_UNEXPECTED, pTokenOut);
-            return NOODLE_FALSE;
+        if (strcmp(pInclude->pPath, pPath) == 0) break;
     }
 
-    return true;
-}
+    if (pInclude && pInclude->modified == modified && pInclude->size == size)
+        pInclude->references++;
+    else
+        pInclude = NULL;
 
-char noodleLexerGet(NoodleLexer_t* pLexer)
-{
-    char c = pLexer->pContent[pLexer->current++];
+    noodleMutexUnlock(&gNoodleIncludeLock);
 
-    // Correctly increase line counts and character numbers
-    if (c == '\n')
+    if (pInclude) return pInclude;
+
+    // Parsed without holding the lock, the file may include others in turn
+    NoodleGroup_t* pDocument = noodleParseFile(pPath, NULL, NULL, NULL, pIncluder, pErrorBuffer, bufferSize);
+    if (!pDocument) return NULL;
+
+    // The document never changes again, a failed freeze only leaves it on its index
+    noodleFreeze(pDocument);
+    noodleGroupInclude(pDocument);
+
+    size_t pathLength = strlen(pPath);
+
+    NoodleInclude_t* pLoaded = noodleDefaultAlloc(NULL, sizeof(NoodleInclude_t) + pathLength + 1);
+    if (!pLoaded) goto cleanupMemory;
+
+    pLoaded->pNext = NULL;
+    pLoaded->references = 2; // The cache and the caller
+    pLoaded->pDocument = pDocument;
+    pLoaded->modified = modified;
+    pLoaded->size = size;
+    memcpy(pLoaded->pPath, pPath, pathLength + 1);
+
+    NoodleInclude_t* pStale = NULL;
+
+    noodleMutexLock(&gNoodleIncludeLock);
+
+    // Another thread may have loaded the same file in the meantime
+    NoodleInclude_t** ppLink = &gpNoodleIncludes;
+    while (*ppLink && strcmp((*ppLink)->pPath, pPath) != 0)
+        ppLink = &(*ppLink)->pNext;
+
+    pInclude = *ppLink;
+
+    if (pInclude && pInclude->modified == modified && pInclude->size == size)
     {
-        pLexer->line++;
-        pLexer->character = 0;
+        pInclude->references++;
     }
     else
     {
-        pLexer->character++;
+        // A file that changed replaces its entry, documents using the old one keep it alive
+        if (pInclude)
+        {
+            *ppLink = pInclude->pNext;
+            pStale = pInclude;
+        }
+
+        pLoaded->pNext = gpNoodleIncludes;
+        gpNoodleIncludes = pLoaded;
+        pInclude = pLoaded;
+        pLoaded = NULL;
     }
- 
-    return c;
+
+    noodleMutexUnlock(&gNoodleIncludeLock);
+
+    if (pStale) noodleIncludeRelease(pStale);
+
+    if (pLoaded)
+    {
+        noodleCleanup(pLoaded->pDocument);
+        noodleDefaultFree(NULL, pLoaded);
+    }
+
+    return pInclude;
+
+cleanupFile:
+    snprintf(pErrorBuffer, bufferSize, "Could not open file!");
+    return NULL;
+
+cleanupMemory:
+    snprintf(pErrorBuffer, bufferSize, "Could not allocate memory!");
+    noodleCleanup(pDocument);
+    return NULL;
 }
 
-char noodleLexerPeek(const NoodleLexer_t* pLexer)
+void noodleIncludeRelease(NoodleInclude_t* pInclude)
 {
-    return pLexer->pContent[pLexer->current];
+    noodleMutexLock(&gNoodleIncludeLock);
+    size_t references = --pInclude->references;
+    noodleMutexUnlock(&gNoodleIncludeLock);
+
+    if (references > 0) return;
+
+    // Not under the lock, cleaning up releases the files this one included
+    noodleCleanup(pInclude->pDocument);
+    noodleDefaultFree(NULL, pInclude);
 }
 
-void noodleLexerSkipComment(NoodleLexer_t* pLexer)
+NOODLE_BOOL noodleOwns(const NoodleGroup_t* pGroup, const NoodleValue_t* pEntry)
 {
-    char c = 0;
-    do
-    {
-        c = noodleLexerGet(pLexer);
-    } while (c != '\0' && c != '\n');
+    // Noodles borrowed from an included file keep the parent they have there
+    return pEntry->pChild->pParent == pGroup;
 }
 
-void noodleLexerSkipSpaces(NoodleLexer_t* pLexer)
+void noodleGroupInclude(NoodleGroup_t* pGroup)
 {
-    char c = noodleLexerGet(pLexer);
-    while ((c = noodleLexerPeek(pLexer)) && noodleLexerIsSpace(c))
+    pGroup->included = NOODLE_TRUE;
+
+    // Groups the file borrowed from its own includes were marked when those were loaded
+    for (size_t i = 0; i < pGroup->count; i++)
     {
-        c = noodleLexerGet(pLexer);
+        NoodleValue_t* pEntry = &pGroup->pEntries[i];
+
+        if (pEntry->base.type == NOODLE_TYPE_GROUP && noodleOwns(pGroup, pEntry))
+            noodleGroupInclude((NoodleGroup_t*)pEntry->pChild);
     }
 }
 
-void noodleLexerAtom(NoodleLexer_t* pLexer, NoodleTokenKind_t kind, NoodleToken_t* pTokenOut)
+NoodleThreadResult_t NOODLE_THREAD_CALL noodleReclaimer(void* pUser)
 {
-    assert(pLexer);
-    assert(pTokenOut);
+    (void)pUser;
 
-    noodleLexerGet(pLexer);
+    for (;;)
+    {
+        noodleMutexLock(&gNoodleReclaimer.lock);
 
-    *pTokenOut = noodleToken(kind, pLexer->current, pLexer->current + 1);
-}
+        while (!gNoodleReclaimer.pFirst)
+            noodleConditionWait(&gNoodleReclaimer.wake, &gNoodleReclaimer.lock);
 
-void noodleLexerIdentifierOrBool(NoodleLexer_t* pLexer, NoodleToken_t* pTokenOut)
-{
-    assert(pLexer);
-    assert(pTokenOut);
+        // Everything queued so far is taken at once
+        NoodleGroup_t* pGroup = gNoodleReclaimer.pFirst;
+        gNoodleReclaimer.pFirst = NULL;
 
-    int start = pLexer->current;
+        noodleMutexUnlock(&gNoodleReclaimer.lock);
 
-    while(noodleLexerIsIdentifier(noodleLexerPeek(pLexer))) 
-    {
-        noodleLexerGet(pLexer);
-    }
+        size_t count = 0;
 
-    // It's easier to catch booleans here so we do
-    if (((sizeof("true") - 1 == pLexer->current - start) || (sizeof("false") - 1 == pLexer->current - start)) 
-        && ((strncmp(pLexer->pContent + start, "true", pLexer->current - start) == 0) || (strncmp(pLexer->pContent + start, "false", pLexer->current - start) == 0)))
-    {
-        *pTokenOut = noodleToken(NOODLE_TOKEN_KIND_BOOLEAN, start, pLexer->current);
-        return;
+        while (pGroup)
+        {
+            NoodleGroup_t* pNext = pGroup->base.pParent;
+            pGroup->base.pParent = NULL;
+
+            noodleCleanup(pGroup);
+            pGroup = pNext;
+            count++;
+        }
+
+        noodleMutexLock(&gNoodleReclaimer.lock);
+
+        gNoodleReclaimer.pending -= count;
+        if (gNoodleReclaimer.pending == 0)
+            noodleConditionBroadcast(&gNoodleReclaimer.idle);
+
+        noodleMutexUnlock(&gNoodleReclaimer.lock);
     }
 
-    *pTokenOut = noodleToken(NOODLE_TOKEN_KIND_IDENTIFIER, start, pLexer->current);
+    return 0;
 }
 
-void noodleLexerNumber(NoodleLexer_t* pLexer, NoodleToken_t* pOutToken)
+const char* noodleTapeStrings(const NoodleTape_t* pTape)
 {
-    assert(pLexer);
-    assert(pOutToken);
+    return pTape->stringsOffset ? (const char*)pTape + pTape->stringsOffset : pTape->pStrings;
+}
 
-    int start = pLexer->current;
+NOODLE_BOOL noodleSharedName(char* pName, const char* pBase, uint64_t generation)
+{
+    // Checks the base name alone when pName is NULL, the longest generation 
+    // should then be given. Images are named after the base and generation.
+    char pBuffer[NOODLE_SHARED_NAME_MAX];
+    int length = snprintf(pName ? pName : pBuffer, NOODLE_SHARED_NAME_MAX, "%s.%llu", pBase, (unsigned long long)generation);
 
-    while (noodleLexerIsNumber(noodleLexerPeek(pLexer)))
-    {
-        noodleLexerGet(pLexer);
-    }
+    return pBase[0] != '\0' && length > 0 && length < NOODLE_SHARED_NAME_MAX;
+}
 
-    // Determine if this string is a long or a float, or a failed case
-    char* pFloatEnd = NULL;
-    char* pLongEnd = NULL;
+void* noodleSharedCreate(const char* pName, size_t size)
+{
+#ifdef _WIN32
+    // The mapping lives on while any process has a view of it
+    HANDLE mapping = CreateFileMappingA(INVALID_HANDLE_VALUE, NULL, PAGE_READWRITE, (DWORD)((uint64_t)size >> 32), (DWORD)size, pName);
+    if (!mapping) return NULL;
 
-    strtof(pLexer->pContent + start, &pFloatEnd);
-    strtol(pLexer->pContent + start, &pLongEnd, 10);
+    void* pMemory = MapViewOfFile(mapping, FILE_MAP_WRITE, 0, 0, size);
+    CloseHandle(mapping);
 
-    NoodleTokenKind_t kind = NOODLE_TOKEN_KIND_UNEXPECTED;
+    return pMemory;
+#else
+    int file = shm_open(pName, O_CREAT | O_RDWR, 0644);
+    if (file < 0) return NULL;
+
+    // Only a new segment is grown, one of the same size is left as it is
+    if (ftruncate(file, (off_t)size) != 0)
+    {
+        close(file);
+        return NULL;
+    }
 
-    if (pLongEnd == pLexer->pContent + pLexer->current)
-        kind = NOODLE_TOKEN_KIND_INTEGER;
-    else if (pFloatEnd == pLexer->pContent + pLexer->current)
-        kind = NOODLE_TOKEN_KIND_FLOAT;
+    void* pMemory = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, file, 0);
+    close(file);
 
-    *pOutToken = noodleToken(kind, start, pLexer->current);
+    return pMemory == MAP_FAILED ? NULL : pMemory;
+#endif
 }
 
-void noodleLexerString(NoodleLexer_t* pLexer, NoodleToken_t* pTokenOut)
+const void* noodleSharedOpen(const char* pName, size_t* pSize)
 {
-    assert(pLexer);
-    assert(pTokenOut);
+#ifdef _WIN32
+    HANDLE mapping = OpenFileMappingA(FILE_MAP_READ, FALSE, pName);
+    if (!mapping) return NULL;
 
-    noodleLexerGet(pLexer); // Get the starting quote
+    const void* pMemory = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    CloseHandle(mapping);
 
-    int start = pLexer->current; 
+    if (!pMemory) return NULL;
 
-    // Iterate until another end quote is found
-    char c = '\0';
-    while((c = noodleLexerPeek(pLexer)) && c != '\"')
+    // Views are whole pages, which is at least the size it was made with
+    MEMORY_BASIC_INFORMATION information;
+    if (!VirtualQuery(pMemory, &information, sizeof(information)))
     {
-        noodleLexerGet(pLexer);
+        UnmapViewOfFile(pMemory);
+        return NULL;
     }
 
-    noodleLexerGet(pLexer); // Push past the second quote 
+    *pSize = information.RegionSize;
+    return pMemory;
+#else
+    int file = shm_open(pName, O_RDONLY, 0);
+    if (file < 0) return NULL;
 
-    *pTokenOut = noodleToken(NOODLE_TOKEN_KIND_STRING, start, pLexer->current - 1);
+    struct stat status;
+    if (fstat(file, &status) != 0 || status.st_size <= 0)
+    {
+        close(file);
+        return NULL;
+    }
+
+    const void* pMemory = mmap(NULL, (size_t)status.st_size, PROT_READ, MAP_SHARED, file, 0);
+    close(file);
+
+    if (pMemory == MAP_FAILED) return NULL;
+
+    *pSize = (size_t)status.st_size;
+    return pMemory;
+#endif
 }
 
-void noodleFree(Noodle_t* pNoodle)
+void noodleSharedUnmap(const void* pMemory, size_t size)
 {
-    // Free the name of the any noodle
-    NOODLE_FREE(pNoodle->pName);
-    
-    switch (pNoodle->type)
-    {
-        case NOODLE_TYPE_GROUP:
-        {
-            NoodleGroup_t* pGroup = (NoodleGroup_t*)pNoodle;
-            NoodleNode_t* pNode = NULL;
-            NoodleNode_t* pToFree = NULL;
+    if (!pMemory) return;
+
+#ifdef _WIN32
+    (void)size;
+    UnmapViewOfFile(pMemory);
+#else
+    munmap((void*)pMemory, size);
+#endif
+}
 
-            for (int i = 0; i < pGroup->bucketCount; i++)
-            {
-                pNode = pGroup->ppBuckets[i];    
-                
-                while (pNode != NULL)
-                {
-                    noodleFree(pNode->pNoodle);
+void noodleSharedRemove(const char* pName)
+{
+#ifdef _WIN32
+    (void)pName; // Mappings go away with the last view
+#else
+    shm_unlink(pName);
+#endif
+}
 
-                    pToFree = pNode;
-                    pNode = pNode->pNext;
+NOODLE_BOOL noodleSubscriberMap(NoodleSubscriber_t* pSubscriber, uint64_t generation)
+{
+    char pImageName[NOODLE_SHARED_NAME_MAX];
+    if (!noodleSharedName(pImageName, pSubscriber->pName, generation)) return NOODLE_FALSE;
 
-                    NOODLE_FREE(pToFree);
-                    pToFree = NULL;
-                }
-            }
+    size_t size = 0;
+    const NoodleSharedImage_t* pImage = noodleSharedOpen(pImageName, &size);
+    if (!pImage) return NOODLE_FALSE;
 
-            NOODLE_FREE(pGroup);
-            break;
-        }
-        
-        case NOODLE_TYPE_ARRAY:
-        {
-            NoodleArray_t* pArray = (NoodleArray_t*)pNoodle;
+    // The image is checked against the mapping before anything reads the tape
+    const NoodleTape_t* pTape = (const NoodleTape_t*)(pImage + 1);
+    size_t header = sizeof(NoodleSharedImage_t) + sizeof(NoodleTape_t);
 
-            if (pArray->type == NOODLE_TYPE_STRING)
-                for (int i = 0; i < pArray->count; i++)
-                    NOODLE_FREE(pArray->ppStrings[i]);
-            
-            NOODLE_FREE(pArray->pIntegers);
-            NOODLE_FREE(pArray);
-            break;
-        }
+    if (size < header || pImage->magic != NOODLE_SHARED_MAGIC || pImage->generation != generation || pImage->size > size ||
+        pTape->count > (pImage->size - header) / sizeof(uint64_t) || 
+        pTape->stringsOffset != sizeof(NoodleTape_t) + sizeof(uint64_t) * pTape->count ||
+        pTape->stringsSize > pImage->size - header - sizeof(uint64_t) * pTape->count)
+    {
+        noodleSharedUnmap(pImage, size);
+        return NOODLE_FALSE;
+    }
 
-        case NOODLE_TYPE_STRING:
-        {
-            NoodleValue_t* pValue = (NoodleValue_t*)pNoodle;
-            NOODLE_FREE(pValue->s);
-            NOODLE_FREE(pValue);
-            break;
-        }
+    // Tapes handed out before stay valid until now
+    noodleSharedUnmap(pSubscriber->pImage, pSubscriber->imageSize);
+    pSubscriber->pImage = pImage;
+    pSubscriber->imageSize = size;
 
-        case NOODLE_TYPE_INTEGER:
-        case NOODLE_TYPE_FLOAT:
-        case NOODLE_TYPE_BOOLEAN:
-            NOODLE_FREE(pNoodle);
-            break;
-    }
-}
\ No newline at end of file
+    return NOODLE_TRUE;
+}
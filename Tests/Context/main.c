@@ -0,0 +1,101 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "noodle.h"
+
+// Enough keys for the root group's entries to outgrow the largest pool class
+#define KEY_COUNT 1200000
+#define PARSE_COUNT 2
+
+// Keys are made of letters alone, "k" followed by the index in base 26
+void keyName(char* pName, int index)
+{
+    *pName++ = 'k';
+    do
+    {
+        *pName++ = (char)('a' + index % 26);
+        index /= 26;
+    } while (index);
+    *pName = '\0';
+}
+
+char* createContent(void)
+{
+    // A key of up to 6 characters, " = ", up to 7 digits and a line break
+    char* pContent = malloc((size_t)KEY_COUNT * 24 + 1);
+    if (!pContent) return NULL;
+
+    char pName[16];
+    char* pCursor = pContent;
+    for (int i = 0; i < KEY_COUNT; i++)
+    {
+        keyName(pName, i);
+        pCursor += sprintf(pCursor, "%s = %d\n", pName, i);
+    }
+
+    return pContent;
+}
+
+int checkDocument(const NoodleGroup_t* pDocument)
+{
+    char pName[16];
+
+    for (int i = 0; i < KEY_COUNT; i++)
+    {
+        keyName(pName, i);
+
+        NOODLE_BOOL found = NOODLE_FALSE;
+        int value = noodleIntFrom(pDocument, pName, &found);
+
+        if (!found || value != i)
+        {
+            printf("%s has value %d, expected %d\n", pName, value, i);
+            return EXIT_FAILURE;
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
+
+int main(void)
+{
+    char* pContent = createContent();
+    if (!pContent)
+    {
+        printf("Could not create the content!\n");
+        return EXIT_FAILURE;
+    }
+
+    NoodleContext_t* pContext = noodleContextCreate(NULL);
+    if (!pContext)
+    {
+        printf("Could not create the context!\n");
+        free(pContent);
+        return EXIT_FAILURE;
+    }
+
+    int result = EXIT_SUCCESS;
+    char pErrorBuffer[256] = {0};
+
+    // The second parse reuses the blocks the first one grew into
+    for (int i = 0; i < PARSE_COUNT && result == EXIT_SUCCESS; i++)
+    {
+        NoodleGroup_t* pDocument = noodleParseWith(pContext, pContent, NULL, pErrorBuffer, sizeof(pErrorBuffer));
+        if (!pDocument)
+        {
+            printf("noodleParseWith: %s\n", pErrorBuffer);
+            result = EXIT_FAILURE;
+            break;
+        }
+
+        result = checkDocument(pDocument);
+        noodleCleanup(pDocument);
+    }
+
+    noodleContextDestroy(pContext);
+    free(pContent);
+
+    if (result == EXIT_SUCCESS) printf("Context documents parsed as expected\n");
+    return result;
+}
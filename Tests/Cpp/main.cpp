@@ -0,0 +1,49 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include "noodle.hpp"
+
+static const char* pContent = "width = 1580, height = 720";
+
+// Array keys are hashed up to the first null-terminator, as the C lookups read them
+static_assert(noodle::Key("width").hash() == noodle::hash("width"));
+static_assert(noodle::Key("width\0height").hash() == noodle::hash("width"));
+
+static int check(const char* pName, std::optional<int> value, int expected)
+{
+    if (value == expected) return EXIT_SUCCESS;
+
+    if (value) std::printf("%s: found %d, expected %d\n", pName, *value, expected);
+    else std::printf("%s: found nothing, expected %d\n", pName, expected);
+
+    return EXIT_FAILURE;
+}
+
+int main()
+{
+    std::string error;
+    noodle::Document document = noodle::Document::parse(pContent, &error);
+
+    if (!document)
+    {
+        std::printf("%s\n", error.c_str());
+        return EXIT_FAILURE;
+    }
+
+    int result = EXIT_SUCCESS;
+
+    // A buffer longer than the name it holds
+    char pBuffer[32] = "width";
+    char pCopied[32];
+    std::strcpy(pCopied, "height");
+
+    if (check("Literal", document.get<int>("width"), 1580) != EXIT_SUCCESS) result = EXIT_FAILURE;
+    if (check("NOODLE_KEY", document.get<int>(NOODLE_KEY("height")), 720) != EXIT_SUCCESS) result = EXIT_FAILURE;
+    if (check("Buffer", document.get<int>(pBuffer), 1580) != EXIT_SUCCESS) result = EXIT_FAILURE;
+    if (check("Copied buffer", document.get<int>(pCopied), 720) != EXIT_SUCCESS) result = EXIT_FAILURE;
+    if (check("Key::runtime", document.get<int>(noodle::Key::runtime(pCopied)), 720) != EXIT_SUCCESS) result = EXIT_FAILURE;
+
+    if (result == EXIT_SUCCESS) std::printf("Keys found as expected\n");
+    return result;
+}
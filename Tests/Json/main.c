@@ -0,0 +1,95 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "noodle.h"
+
+#define OUTPUT_CAPACITY 1024
+
+typedef struct Output_t
+{
+    char    pData[OUTPUT_CAPACITY];
+    size_t  size;
+} Output_t;
+
+// Every escape JSON has, control characters among them
+const char* pJson = "{\"s\":\"a\\u0001b\\\"c\\\\d\\/e\\bf\\fg\\nh\\ti\\u00e9\\ud83d\\ude00\"}";
+const char* pExpected = "a\x01" "b\"c\\d/e\b" "f\f" "g\nh\ti\xc3\xa9\xf0\x9f\x98\x80";
+
+size_t writeOutput(void* pUser, const void* pData, size_t size)
+{
+    Output_t* pOutput = pUser;
+
+    // Keeps room for the null-terminator
+    if (size >= OUTPUT_CAPACITY - pOutput->size) return 0;
+
+    memcpy(pOutput->pData + pOutput->size, pData, size);
+    pOutput->size += size;
+    pOutput->pData[pOutput->size] = '\0';
+
+    return size;
+}
+
+int checkString(const char* pName, const char* pNoodle)
+{
+    char pErrorBuffer[256] = {0};
+
+    NoodleGroup_t* pDocument = noodleParse(pNoodle, NULL, NULL, NULL, pErrorBuffer, sizeof(pErrorBuffer));
+    if (!pDocument)
+    {
+        printf("%s: %s\n", pName, pErrorBuffer);
+        return EXIT_FAILURE;
+    }
+
+    const char* pString = noodleStringFrom(pDocument, "s", NULL);
+    int result = pString && strcmp(pString, pExpected) == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+
+    if (result != EXIT_SUCCESS) printf("%s: the string changed, the noodle was %s\n", pName, pNoodle);
+
+    noodleCleanup(pDocument);
+    return result;
+}
+
+int main(void)
+{
+    char pErrorBuffer[256] = {0};
+    Output_t noodle = {{0}, 0};
+    Output_t json = {{0}, 0};
+    Output_t again = {{0}, 0};
+
+    // JSON to noodle and back, then to noodle once more
+    if (!noodleFromJson(pJson, strlen(pJson), writeOutput, &noodle, pErrorBuffer, sizeof(pErrorBuffer)))
+    {
+        printf("noodleFromJson: %s\n", pErrorBuffer);
+        return EXIT_FAILURE;
+    }
+
+    if (checkString("noodleFromJson", noodle.pData) != EXIT_SUCCESS) return EXIT_FAILURE;
+
+    if (!noodleToJson(noodle.pData, noodle.size, writeOutput, &json, pErrorBuffer, sizeof(pErrorBuffer)))
+    {
+        printf("noodleToJson: %s\n", pErrorBuffer);
+        return EXIT_FAILURE;
+    }
+
+    if (!noodleFromJson(json.pData, json.size, writeOutput, &again, pErrorBuffer, sizeof(pErrorBuffer)))
+    {
+        printf("noodleFromJson: %s\n", pErrorBuffer);
+        return EXIT_FAILURE;
+    }
+
+    if (checkString("Round trip", again.pData) != EXIT_SUCCESS) return EXIT_FAILURE;
+
+    // A null character would cut the string short, so it isn't converted
+    const char* pNull = "{\"s\":\"a\\u0000b\"}";
+    Output_t rejected = {{0}, 0};
+
+    if (noodleFromJson(pNull, strlen(pNull), writeOutput, &rejected, pErrorBuffer, sizeof(pErrorBuffer)))
+    {
+        printf("noodleFromJson converted U+0000 into %s\n", rejected.pData);
+        return EXIT_FAILURE;
+    }
+
+    printf("Strings converted as expected\n");
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,85 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "noodle.h"
+
+#define MAX_RESULTS 16
+
+typedef struct QueryCase_t
+{
+    const char* pSelector;
+    const char* pContent;
+    size_t      expected; // Distinct matches
+} QueryCase_t;
+
+// Selectors with several ** reach the same nodes along more than one path
+const QueryCase_t cases[] =
+{
+    {"a.*", "a = { x = 1, y = 2 } b = { x = 3 }", 2},
+    {"**.b", "a = { a = { b = 1 } }", 1},
+    {"**.**.b", "a = { a = { b = 1 } }", 1},
+    {"**.a.**.b", "a = { a = { b = 1 } }", 1},
+    {"**.a.**.a.**.b", "a = { a = { a = { b = 1 } } }", 1},
+    {"**.a.**.*", "a = { a = { b = 1 } }", 2},
+    {"**.a.*.**.b", "a = { x = { a = { y = { b = 1 } } } }", 1},
+};
+
+int runCase(const QueryCase_t* pCase)
+{
+    char pErrorBuffer[256] = {0};
+
+    NoodleGroup_t* pDocument = noodleParse(pCase->pContent, NULL, NULL, NULL, pErrorBuffer, sizeof(pErrorBuffer));
+    if (!pDocument)
+    {
+        printf("%s: %s\n", pCase->pSelector, pErrorBuffer);
+        return EXIT_FAILURE;
+    }
+
+    NoodleQuery_t* pQuery = noodleQueryCompile(pCase->pSelector, NULL, pErrorBuffer, sizeof(pErrorBuffer));
+    if (!pQuery)
+    {
+        printf("%s: %s\n", pCase->pSelector, pErrorBuffer);
+        noodleCleanup(pDocument);
+        return EXIT_FAILURE;
+    }
+
+    Noodle_t* ppResults[MAX_RESULTS];
+    size_t count = noodleQueryRun(pQuery, pDocument, ppResults, MAX_RESULTS);
+    int result = EXIT_SUCCESS;
+
+    if (count != pCase->expected)
+    {
+        printf("%s: found %zu matches, expected %zu\n", pCase->pSelector, count, pCase->expected);
+        result = EXIT_FAILURE;
+    }
+
+    for (size_t i = 0; i < count && i < MAX_RESULTS; i++)
+    {
+        for (size_t j = 0; j < i; j++)
+        {
+            if (ppResults[i] == ppResults[j])
+            {
+                printf("%s: match %zu is reported again as match %zu\n", pCase->pSelector, j, i);
+                result = EXIT_FAILURE;
+            }
+        }
+    }
+
+    noodleQueryCleanup(pQuery);
+    noodleCleanup(pDocument);
+
+    return result;
+}
+
+int main(void)
+{
+    int result = EXIT_SUCCESS;
+
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++)
+    {
+        if (runCase(&cases[i]) != EXIT_SUCCESS) result = EXIT_FAILURE;
+    }
+
+    if (result == EXIT_SUCCESS) printf("Queries matched as expected\n");
+    return result;
+}
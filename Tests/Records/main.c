@@ -0,0 +1,213 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif
+
+#include "noodle.h"
+
+#ifdef _WIN32
+typedef SRWLOCK Mutex_t;
+#define MUTEX_INITIALIZER SRWLOCK_INIT
+#define mutexLock(pMutex) AcquireSRWLockExclusive(pMutex)
+#define mutexUnlock(pMutex) ReleaseSRWLockExclusive(pMutex)
+#else
+typedef pthread_mutex_t Mutex_t;
+#define MUTEX_INITIALIZER PTHREAD_MUTEX_INITIALIZER
+#define mutexLock(pMutex) pthread_mutex_lock(pMutex)
+#define mutexUnlock(pMutex) pthread_mutex_unlock(pMutex)
+#endif
+
+// Records of about 80 characters, 2 MiB in all, so the threads of
+// noodleParseRecords have several 256 KiB batches to take between them
+#define RECORD_COUNT 25000
+#define RECORD_CAPACITY 96
+#define THREAD_COUNT 4
+
+// Every so often a record is missing its value, the ones around it are fine
+#define FAILED_INTERVAL 1000
+#define FAILED_OFFSET 2
+
+typedef struct Record_t
+{
+    int     id;
+    char    pError[256];
+    size_t  calls;
+} Record_t;
+
+// Callbacks run on several threads at once, the results are shared
+typedef struct Results_t
+{
+    Mutex_t     mutex;
+    Record_t*   pRecords;
+    size_t      count;
+    size_t      unexpected; // Indices past the expected records
+} Results_t;
+
+int isFailedRecord(size_t index)
+{
+    return index % FAILED_INTERVAL == FAILED_OFFSET;
+}
+
+char* createContent(size_t* pLength)
+{
+    char* pContent = malloc((size_t)RECORD_COUNT * RECORD_CAPACITY + 1);
+    if (!pContent) return NULL;
+
+    char* pCursor = pContent;
+    for (size_t i = 0; i < RECORD_COUNT; i++)
+    {
+        if (isFailedRecord(i)) pCursor += sprintf(pCursor, "bad = \n");
+        else pCursor += sprintf(pCursor, "ev = { id = %zu, name = \"A record long enough to fill the batches\" }\n", i + 1);
+    }
+
+    *pLength = (size_t)(pCursor - pContent);
+    return pContent;
+}
+
+int recordId(const NoodleGroup_t* pRecord)
+{
+    const NoodleGroup_t* pEvent = noodleGroupFrom(pRecord, "ev");
+    return pEvent ? noodleIntFrom(pEvent, "id", NULL) : -1;
+}
+
+NOODLE_BOOL collect(void* pUser, size_t index, NoodleGroup_t* pRecord, const char* pError)
+{
+    Results_t* pResults = pUser;
+    int id = pRecord ? recordId(pRecord) : 0;
+
+    mutexLock(&pResults->mutex);
+
+    if (index < RECORD_COUNT)
+    {
+        Record_t* pEntry = &pResults->pRecords[index];
+
+        if (pRecord) pEntry->id = id;
+        else snprintf(pEntry->pError, sizeof(pEntry->pError), "%s", pError);
+
+        pEntry->calls++;
+    }
+    else
+    {
+        pResults->unexpected++;
+    }
+
+    pResults->count++;
+
+    mutexUnlock(&pResults->mutex);
+
+    noodleCleanup(pRecord);
+    return NOODLE_TRUE;
+}
+
+int checkResults(const char* pName, const Results_t* pResults)
+{
+    if (pResults->count != RECORD_COUNT || pResults->unexpected)
+    {
+        printf("%s: read %zu records, %zu past the end, expected %d\n", pName, pResults->count, pResults->unexpected, RECORD_COUNT);
+        return EXIT_FAILURE;
+    }
+
+    // By index, whatever order the callbacks came in
+    for (size_t i = 0; i < RECORD_COUNT; i++)
+    {
+        const Record_t* pEntry = &pResults->pRecords[i];
+        char pExpected[64];
+
+        if (pEntry->calls != 1)
+        {
+            printf("%s: record %zu was reported %zu times\n", pName, i, pEntry->calls);
+            return EXIT_FAILURE;
+        }
+
+        if (isFailedRecord(i))
+        {
+            // Reported where the value was expected, like noodleParse does
+            snprintf(pExpected, sizeof(pExpected), "(Ln %zu, Col 1) Unexpected token found, \"\"", i + 1);
+
+            if (!strstr(pEntry->pError, pExpected))
+            {
+                printf("%s: record %zu gave error \"%s\"\n", pName, i, pEntry->pError);
+                return EXIT_FAILURE;
+            }
+        }
+        else if (pEntry->id != (int)i + 1 || pEntry->pError[0])
+        {
+            printf("%s: record %zu has id %d and error \"%s\", expected id %zu\n", pName, i, pEntry->id, pEntry->pError, i + 1);
+            return EXIT_FAILURE;
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
+
+void resetResults(Results_t* pResults)
+{
+    memset(pResults->pRecords, 0, sizeof(Record_t) * RECORD_COUNT);
+    pResults->count = 0;
+    pResults->unexpected = 0;
+}
+
+int main(void)
+{
+    size_t length = 0;
+    char* pContent = createContent(&length);
+    Results_t results = {MUTEX_INITIALIZER, calloc(RECORD_COUNT, sizeof(Record_t)), 0, 0};
+
+    if (!pContent || !results.pRecords)
+    {
+        printf("Could not create the records!\n");
+        free(pContent);
+        free(results.pRecords);
+        return EXIT_FAILURE;
+    }
+
+    int result = EXIT_FAILURE;
+    NoodleRecords_t* pRecords = noodleRecordsOpen(pContent, length, NULL, NULL);
+    if (!pRecords)
+    {
+        printf("Could not open the records!\n");
+        goto cleanup;
+    }
+
+    NoodleGroup_t* pRecord = NULL;
+    char pErrorBuffer[256] = {0};
+
+    while (noodleRecordsNext(pRecords, &pRecord, pErrorBuffer, sizeof(pErrorBuffer)))
+    {
+        collect(&results, results.count, pRecord, pErrorBuffer);
+        pErrorBuffer[0] = '\0';
+    }
+
+    noodleRecordsClose(pRecords);
+
+    if (checkResults("noodleRecordsNext", &results) != EXIT_SUCCESS) goto cleanup;
+
+    // Once on the calling thread alone and once on several
+    size_t threadCounts[] = {1, THREAD_COUNT};
+
+    for (size_t i = 0; i < sizeof(threadCounts) / sizeof(threadCounts[0]); i++)
+    {
+        resetResults(&results);
+
+        if (!noodleParseRecords(pContent, length, threadCounts[i], collect, &results))
+        {
+            printf("noodleParseRecords stopped early!\n");
+            goto cleanup;
+        }
+
+        if (checkResults("noodleParseRecords", &results) != EXIT_SUCCESS) goto cleanup;
+    }
+
+    printf("Records parsed as expected\n");
+    result = EXIT_SUCCESS;
+
+cleanup:
+    free(results.pRecords);
+    free(pContent);
+    return result;
+}
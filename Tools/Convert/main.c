@@ -0,0 +1,136 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "noodle.h"
+
+// Built twice, as noodle2json and json2noodle
+#if CONVERT_TO_JSON
+#define CONVERT_NAME "noodle2json"
+#define CONVERT_FUNCTION noodleToJson
+#else
+#define CONVERT_NAME "json2noodle"
+#define CONVERT_FUNCTION noodleFromJson
+#endif
+
+// The input is mapped rather than read so that neither side of the 
+// conversion holds the whole document in memory
+static const char* mapDocument(const char* pPath, size_t* pSize)
+{
+#ifdef _WIN32
+    HANDLE file = CreateFileA(pPath, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE) return NULL;
+
+    LARGE_INTEGER size;
+    GetFileSizeEx(file, &size);
+
+    // Empty files can't be mapped
+    if (size.QuadPart == 0)
+    {
+        CloseHandle(file);
+        *pSize = 0;
+        return "";
+    }
+
+    HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    CloseHandle(file);
+    if (!mapping) return NULL;
+
+    const char* pContent = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    CloseHandle(mapping);
+
+    *pSize = (size_t)size.QuadPart;
+    return pContent;
+#else
+    int file = open(pPath, O_RDONLY);
+    if (file < 0) return NULL;
+
+    struct stat info;
+    fstat(file, &info);
+
+    // Empty files can't be mapped
+    if (info.st_size == 0)
+    {
+        close(file);
+        *pSize = 0;
+        return "";
+    }
+
+    void* pContent = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+    close(file);
+    if (pContent == MAP_FAILED) return NULL;
+
+#ifdef MADV_SEQUENTIAL
+    madvise(pContent, (size_t)info.st_size, MADV_SEQUENTIAL);
+#endif
+
+    *pSize = (size_t)info.st_size;
+    return pContent;
+#endif
+}
+
+static void unmapDocument(const char* pContent, size_t size)
+{
+    if (size == 0) return;
+
+#ifdef _WIN32
+    UnmapViewOfFile(pContent);
+#else
+    munmap((void*)pContent, size);
+#endif
+}
+
+static size_t writeFile(void* pUser, const void* pData, size_t size)
+{
+    return fwrite(pData, 1, size, (FILE*)pUser);
+}
+
+int main(int argc, const char* argv[])
+{
+    if (argc < 2 || argc > 3)
+    {
+        printf("Usage: " CONVERT_NAME " input [output]\n");
+        return EXIT_FAILURE;
+    }
+
+    size_t size = 0;
+    const char* pContent = mapDocument(argv[1], &size);
+    if (!pContent)
+    {
+        fprintf(stderr, "Could not open %s!\n", argv[1]);
+        return EXIT_FAILURE;
+    }
+
+    FILE* pOutput = argc > 2 ? fopen(argv[2], "wb") : stdout;
+    if (!pOutput)
+    {
+        fprintf(stderr, "Could not open %s!\n", argv[2]);
+        unmapDocument(pContent, size);
+        return EXIT_FAILURE;
+    }
+
+    char pErrorBuffer[256] = {0};
+    NOODLE_BOOL succeeded = CONVERT_FUNCTION(pContent, size, writeFile, pOutput, pErrorBuffer, sizeof(pErrorBuffer));
+
+    if (pOutput != stdout && fclose(pOutput) != 0) succeeded = NOODLE_FALSE;
+    unmapDocument(pContent, size);
+
+    if (!succeeded)
+    {
+        fprintf(stderr, "%s: %s\n", argv[1], pErrorBuffer[0] ? pErrorBuffer : "Could not write output!");
+        if (argc > 2) remove(argv[2]);
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}